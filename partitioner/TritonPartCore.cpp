@@ -8,13 +8,18 @@
 #include "src/Partitioner.h"
 #include "src/Evaluator.h"
 #include "src/Coarsener.h"
+#include "src/GreedyRefine.h"
+#include "src/ILPRefine.h"
 #include "src/KWayFMRefine.h"
+#include "src/KWayPMRefine.h"
+#include "src/ThreadPool.h"
 #include "utils/Logger.h"
 
 #include <fstream>
 #include <sstream>
 #include <algorithm>
 #include <random>
+#include <set>
 
 namespace par {
 
@@ -33,6 +38,21 @@ TritonPartCore::~TritonPartCore() {
 
 void TritonPartCore::setAdapter(std::shared_ptr<NetlistAdapter> adapter) {
     adapter_ = adapter;
+    if (adapter_) {
+        adapter_->setNumThreads(num_threads_);
+    }
+}
+
+void TritonPartCore::setNumThreads(int num_threads) {
+    // The same number of threads is used by timing analysis and
+    // by the partitioner's worker pool
+    if (num_threads != num_threads_) {
+        thread_pool_.reset();  // recreated with the new size
+    }
+    num_threads_ = num_threads;
+    if (adapter_) {
+        adapter_->setNumThreads(num_threads_);
+    }
 }
 
 bool TritonPartCore::readNetlist(const std::string& filename, const std::string& top_module) {
@@ -70,8 +90,15 @@ bool TritonPartCore::buildHypergraph() {
     logger.info("Building hypergraph from adapter...");
     
     // The input files should be read before calling buildHypergraph
-    // This method just builds the hypergraph from already loaded data
-    hypergraph_ = adapter_->buildHypergraph();
+    // This method just builds the hypergraph from already loaded data.
+    // For timing-driven runs, the timing paths from extractTimingPaths
+    // are attached to the hypergraph.
+    if (timing_aware_ && (net_timing_only_ || !timing_paths_.empty())) {
+        hypergraph_ = adapter_->buildTimingHypergraph(timing_paths_, extra_delay_, guardband_);
+        clock_period_ = adapter_->getClockPeriod();
+    } else {
+        hypergraph_ = adapter_->buildHypergraph();
+    }
     
     if (!hypergraph_) {
         logger.error("Failed to build hypergraph");
@@ -98,23 +125,27 @@ bool TritonPartCore::extractTimingPaths() {
         return true;
     }
     
+    if (net_timing_only_) {
+        logger.info("Using net slacks only, skipping path extraction");
+        return true;
+    }
+    
     logger.info("Extracting timing paths...");
     
     // Get critical paths from adapter
-    // Use top_n = 100000 to match OpenROAD's default setting
-    timing_paths_ = adapter_->getCriticalPaths(100000);  // Get top 100000 paths
+    // The default top_n = 100000 matches OpenROAD's default setting
+    timing_paths_ = adapter_->getCriticalPaths(top_n_);
     
     logger.info("Extracted " + std::to_string(timing_paths_.size()) + " timing paths");
     
     if (!timing_paths_.empty()) {
-        logger.info("Worst slack: " + std::to_string(timing_paths_[0].slack));
+        logger.info("Worst slack: " + std::to_string(timing_paths_.slacks[0]));
     }
     
-    // Add timing paths to hypergraph if available
+    // The timing paths should be extracted before building the hypergraph.
+    // Otherwise, rebuild the hypergraph to attach them.
     if (hypergraph_ && !timing_paths_.empty()) {
-        // TODO: Add timing paths to hypergraph when method is available
-        // hypergraph_->SetTimingPaths(timing_paths_);
-        logger.info("Timing paths extracted (integration pending)");
+        return buildHypergraph();
     }
     
     return true;
@@ -139,8 +170,11 @@ bool TritonPartCore::partition() {
     
     // Determine partition method based on size
     int num_vertices = hypergraph_->GetNumVertices();
+    // The simple partitioning ignores the fixed vertices and the groups
+    const bool has_constraints = !groups_.empty()
+                                 || hypergraph_->GetFixedAttrSize() == num_vertices;
     
-    if (num_vertices < 100) {
+    if (num_vertices < 100 && !has_constraints) {
         // For small hypergraphs, use simple random or greedy partitioning
         logger.info("Using simple partitioning for small hypergraph");
         performSimplePartition();
@@ -248,9 +282,9 @@ void TritonPartCore::reportPartitionMetrics() {
     if (timing_aware_ && !timing_paths_.empty()) {
         // Report timing-related metrics
         int critical_cuts = 0;
-        for (const auto& path : timing_paths_) {
+        for (int path_id = 0; path_id < timing_paths_.size(); ++path_id) {
             std::set<int> parts_in_path;
-            for (int v : path.path) {
+            for (int v : timing_paths_.PathVertices(path_id)) {
                 if (v < static_cast<int>(partition_.size())) {
                     parts_in_path.insert(partition_[v]);
                 }
@@ -313,15 +347,19 @@ bool TritonPartCore::writePartitionResult(const std::string& filename) {
 void TritonPartCore::initializePartitioner() {
     auto& logger = Logger::getInstance();
     
-    // Create evaluator with default parameters
-    std::vector<float> e_wt_factors = {1.0};      // hyperedge weight factors
-    std::vector<float> v_wt_factors = {1.0};      // vertex weight factors
-    std::vector<float> placement_wt_factors = {}; // no placement info
-    float net_timing_factor = timing_aware_ ? 1.0 : 0.0;
-    float path_timing_factor = timing_aware_ ? 1.0 : 0.0;
-    float path_snaking_factor = timing_aware_ ? 0.1 : 0.0;
-    float timing_exp_factor = 1.0;
-    float extra_cut_delay = 0.0;
+    // Create evaluator with the default parameters of TritonPart
+    // The timing factors are ignored when the hypergraph has no timing paths
+    const int vertex_dimensions = hypergraph_->GetVertexDimensions();
+    const int hyperedge_dimensions = hypergraph_->GetHyperedgeDimensions();
+    std::vector<float> e_wt_factors(hyperedge_dimensions, 1.0);  // hyperedge weight factors
+    std::vector<float> v_wt_factors(vertex_dimensions, 1.0);     // vertex weight factors
+    // placement weight factors (default value of 1, as in TritonPart)
+    std::vector<float> placement_wt_factors(hypergraph_->GetPlacementDimensions(), 1.0);
+    const float net_timing_factor = timing_aware_ ? net_timing_factor_ : 0.0;
+    const float path_timing_factor = timing_aware_ ? path_timing_factor_ : 0.0;
+    const float path_snaking_factor = timing_aware_ ? path_snaking_factor_ : 0.0;
+    // The slacks of the timing graph are normalized to the clock period
+    const float extra_delay = clock_period_ > 0.0 ? extra_delay_ / clock_period_ : 0.0;
     
     evaluator_ = std::make_shared<GoldenEvaluator>(
         num_parts_,
@@ -331,14 +369,79 @@ void TritonPartCore::initializePartitioner() {
         net_timing_factor,
         path_timing_factor,
         path_snaking_factor,
-        timing_exp_factor,
-        extra_cut_delay,
-        nullptr,  // timing_graph (not used for now)
+        timing_exp_factor_,
+        extra_delay,
+        hypergraph_,  // the original hypergraph is the timing graph
         &logger
     );
     
-    // TODO: Initialize full partitioner components when constructors are properly configured
-    // For now, we use simple partitioning methods directly
+    // Create the coarsener
+    const std::vector<float> thr_cluster_weight
+        = DivideFactor(hypergraph_->GetTotalVertexWeights(),
+                       min_num_vertices_each_part_ * num_parts_);
+    coarsener_ = std::make_shared<Coarsener>(
+        num_parts_,
+        thr_coarsen_hyperedge_size_skip_,
+        thr_coarsen_vertices_,
+        thr_coarsen_hyperedges_,
+        coarsening_ratio_,
+        max_coarsen_iters_,
+        adj_diff_ratio_,
+        thr_cluster_weight,
+        seed_,
+        CoarsenOrder::kRandom,
+        evaluator_,
+        &logger
+    );
+    coarsener_->SetCoarsenScheme(parallel_coarsening_
+                                     ? CoarsenScheme::kParallelFirstChoice
+                                     : CoarsenScheme::kLazyFirstChoice);
+    
+    // Create the initial partitioner
+    partitioner_ = std::make_shared<Partitioner>(num_parts_, seed_, evaluator_, &logger);
+    
+    // Create the four refiners: greedy, ILP, direct k-way FM and
+    // k-way pair-wise FM
+    auto greedy_refiner = std::make_shared<GreedyRefine>(
+        num_parts_, refiner_iters_, path_timing_factor, path_snaking_factor,
+        max_moves_, evaluator_, &logger);
+    auto ilp_refiner = std::make_shared<IlpRefine>(
+        num_parts_, refiner_iters_, path_timing_factor, path_snaking_factor,
+        max_moves_, evaluator_, &logger);
+    auto k_way_fm_refiner = std::make_shared<KWayFMRefine>(
+        num_parts_, refiner_iters_, path_timing_factor, path_snaking_factor,
+        max_moves_, total_corking_passes_, evaluator_, &logger);
+    auto k_way_pm_refiner = std::make_shared<KWayPMRefine>(
+        num_parts_, refiner_iters_, path_timing_factor, path_snaking_factor,
+        max_moves_, total_corking_passes_, evaluator_, &logger);
+    
+    // Create the multilevel partitioner
+    multilevel_ = std::make_shared<MultilevelPartitioner>(
+        num_parts_,
+        v_cycle_flag_,
+        num_initial_solutions_,
+        num_best_initial_solutions_,
+        num_vertices_threshold_ilp_,
+        max_num_vcycle_,
+        num_coarsen_solutions_,
+        seed_,
+        coarsener_,
+        partitioner_,
+        k_way_fm_refiner,
+        k_way_pm_refiner,
+        greedy_refiner,
+        ilp_refiner,
+        evaluator_,
+        &logger
+    );
+    
+    // The coarsener and the refiners share one pool, which is kept
+    // across partition() calls
+    if (!thread_pool_) {
+        const int num_threads = num_threads_ > 0 ? num_threads_ : ThreadPool::DefaultNumThreads();
+        thread_pool_ = std::make_shared<ThreadPool>(num_threads);
+    }
+    multilevel_->SetThreadPool(thread_pool_);
 }
 
 void TritonPartCore::performSimplePartition() {
@@ -391,10 +494,34 @@ void TritonPartCore::performSimplePartition() {
 void TritonPartCore::performMultilevelPartition() {
     auto& logger = Logger::getInstance();
     
-    // For now, use simple partitioning for "multilevel"
-    // TODO: Implement full multilevel with proper constructor parameters
-    logger.info("Using simplified partitioning (full multilevel pending)");
-    performSimplePartition();
+    // Same flow as TritonPart::MultiLevelPartition
+    const std::vector<float> base_balance(num_parts_, 1.0 / num_parts_);
+    const Matrix<float> upper_block_balance
+        = hypergraph_->GetUpperVertexBalance(num_parts_, balance_, base_balance);
+    const Matrix<float> lower_block_balance
+        = hypergraph_->GetLowerVertexBalance(num_parts_, balance_, base_balance);
+    
+    if (timing_aware_) {
+        evaluator_->InitializeTiming(hypergraph_);
+    }
+    
+    // Remove the large hyperedges and merge the parallel hyperedges
+    // before calling the multilevel partitioner
+    coarsener_->SetThrCoarsenHyperedgeSizeSkip(global_net_threshold_);
+    HGraphPtr grouped_hypergraph = coarsener_->GroupVertices(hypergraph_, groups_);
+    coarsener_->SetThrCoarsenHyperedgeSizeSkip(thr_coarsen_hyperedge_size_skip_);
+    
+    const std::vector<int> solution = multilevel_->Partition(
+        grouped_hypergraph, upper_block_balance, lower_block_balance);
+    
+    // Translate the solution back to the original hypergraph
+    grouped_hypergraph->ProjectSolution(solution, partition_);
+    
+    // Perform the last-minute refinement on the original hypergraph
+    coarsener_->SetThrCoarsenHyperedgeSizeSkip(global_net_threshold_);
+    multilevel_->VcycleRefinement(hypergraph_, upper_block_balance, lower_block_balance, partition_);
+    
+    logger.info("Multilevel partitioning completed");
 }
 
 void TritonPartCore::convertAdapterDataToHypergraph() {
@@ -5,6 +5,7 @@
 
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 #include <map>
 
@@ -16,9 +17,10 @@ namespace par {
 
 // Forward declarations
 class Coarsener;
-class Multilevel;
+class MultilevelPartitioner;
 class Partitioner;
 class GoldenEvaluator;
+class ThreadPool;
 
 // Simplified TritonPart core class
 class TritonPartCore {
@@ -38,15 +40,31 @@ public:
     bool buildHypergraph();
     bool extractTimingPaths();
     
+    // Partition a hypergraph read from a file instead of the adapter netlist
+    void setHypergraph(std::shared_ptr<Hypergraph> hypergraph) { hypergraph_ = std::move(hypergraph); }
+    // Groups of vertices which stay in the same partition (vertex ids)
+    void setGroups(const std::vector<std::vector<int>>& groups) { groups_ = groups; }
+    
     // Partitioning parameters
     void setNumPartitions(int num_parts) { num_parts_ = num_parts; }
     void setBalance(float balance) { balance_ = balance; }
     void setTimingAware(bool enable) { timing_aware_ = enable; }
+    void setTopN(int top_n) { top_n_ = top_n; }
+    void setExtraDelay(float extra_delay) { extra_delay_ = extra_delay; }
+    void setGuardband(bool enable) { guardband_ = enable; }
+    void setNetTimingOnly(bool enable) { net_timing_only_ = enable; }
     void setMaxIterations(int max_iter) { max_iterations_ = max_iter; }
+    void setSeed(int seed) { seed_ = seed; }
+    void setNumThreads(int num_threads);
+    void setParallelCoarsening(bool enable) { parallel_coarsening_ = enable; }
     
     // Run partitioning
     bool partition();
     
+    // Front-end result (after buildHypergraph / extractTimingPaths)
+    std::shared_ptr<Hypergraph> getHypergraph() const { return hypergraph_; }
+    const TimingPathStore& getTimingPaths() const { return timing_paths_; }
+    
     // Get results
     std::vector<int> getPartitionAssignment() const;
     float getCutsize() const;
@@ -65,23 +83,57 @@ private:
     
     // Core data structures
     std::shared_ptr<Hypergraph> hypergraph_;
+    std::vector<std::vector<int>> groups_;  // grouped before coarsening
     std::vector<int> partition_;
     
     // Partitioning components
     std::shared_ptr<Coarsener> coarsener_;
-    std::shared_ptr<Multilevel> multilevel_;
+    std::shared_ptr<MultilevelPartitioner> multilevel_;
     std::shared_ptr<Partitioner> partitioner_;
     std::shared_ptr<GoldenEvaluator> evaluator_;
+    // Created on the first partition() and reused by the later ones
+    std::shared_ptr<ThreadPool> thread_pool_;
     
     // Parameters
     int num_parts_ = 2;
-    float balance_ = 1.1;  // 10% imbalance allowed
+    float balance_ = 1.1;  // UBfactor of the multilevel partitioner
     bool timing_aware_ = true;
+    int top_n_ = 100000;  // top_n critical timing paths
+    float extra_delay_ = 1e-9;  // extra delay introduced by a cut (in seconds)
+    bool guardband_ = false;  // subtract extra_delay_ from all the slacks
+    bool net_timing_only_ = false;  // use net slacks without timing paths
     int max_iterations_ = 10;
     int seed_ = 0;
+    int num_threads_ = 0;  // 0 means using all the hardware threads
+    bool parallel_coarsening_ = false;  // parallel first-choice matching
+
+    // Multilevel partitioning parameters
+    // The defaults are the same as TritonPart::MultiLevelPartition
+    int thr_coarsen_hyperedge_size_skip_ = 50;
+    int thr_coarsen_vertices_ = 200;
+    int thr_coarsen_hyperedges_ = 50;
+    float coarsening_ratio_ = 1.5;
+    int max_coarsen_iters_ = 20;
+    float adj_diff_ratio_ = 0.0001;
+    int min_num_vertices_each_part_ = 4;
+    int global_net_threshold_ = 1000;
+    float net_timing_factor_ = 1.0;
+    float path_timing_factor_ = 1.0;
+    float path_snaking_factor_ = 1.0;
+    float timing_exp_factor_ = 2.0;
+    int num_initial_solutions_ = 50;
+    int num_best_initial_solutions_ = 10;
+    int refiner_iters_ = 2;
+    int max_moves_ = 50;
+    int total_corking_passes_ = 25;
+    bool v_cycle_flag_ = true;
+    int max_num_vcycle_ = 5;
+    int num_coarsen_solutions_ = 3;
+    int num_vertices_threshold_ilp_ = 50;
     
     // Timing paths
-    std::vector<TimingPath> timing_paths_;
+    TimingPathStore timing_paths_;
+    float clock_period_ = 0.0;  // maximum clock period of timing_paths_
     
     // Metrics
     float cutsize_ = 0;
@@ -0,0 +1,456 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Cached front-end result (hypergraph + timing) for repeated runs
+
+#include "CachedAdapter.h"
+#include "../src/Hypergraph.h"
+#include "../utils/Logger.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <set>
+#include <utility>
+
+namespace par {
+
+namespace {
+
+// File layout (native endianness, all the arrays are prefixed by a uint64 size):
+//   magic, version, clock period, dimensions,
+//   hypergraph (vertex weights, eind, eptr, hyperedge weights, timing flag,
+//               vertex types, hyperedge slacks, arc sets, timing paths),
+//   net slacks, critical paths, instance names, cell types, net names
+constexpr char kCacheMagic[8] = {'T', 'P', 'F', 'E', 'C', 'A', 'C', 'H'};
+constexpr uint32_t kCacheVersion = 1;
+
+// 64-bit FNV-1a hash
+constexpr uint64_t kFnvOffset = 14695981039346656037ULL;
+constexpr uint64_t kFnvPrime = 1099511628211ULL;
+
+void hashBytes(uint64_t& hash, const char* data, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= kFnvPrime;
+    }
+}
+
+void hashString(uint64_t& hash, const std::string& str) {
+    const uint64_t size = str.size();
+    hashBytes(hash, reinterpret_cast<const char*>(&size), sizeof(size));
+    hashBytes(hash, str.data(), str.size());
+}
+
+template <typename T>
+void writePod(std::ofstream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool readPod(std::ifstream& in, T& value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+template <typename T>
+void writeVector(std::ofstream& out, const std::vector<T>& vec) {
+    writePod(out, static_cast<uint64_t>(vec.size()));
+    out.write(reinterpret_cast<const char*>(vec.data()), vec.size() * sizeof(T));
+}
+
+// The number of bytes from the read position to the end of the file
+uint64_t remainingBytes(std::ifstream& in) {
+    const std::streampos pos = in.tellg();
+    in.seekg(0, std::ios::end);
+    const std::streampos end = in.tellg();
+    in.seekg(pos);
+    return pos < 0 || end < pos ? 0 : static_cast<uint64_t>(end - pos);
+}
+
+template <typename T>
+bool readVector(std::ifstream& in, std::vector<T>& vec) {
+    uint64_t size = 0;
+    // the size comes from the file: it must fit in the rest of the file
+    if (!readPod(in, size) || size > remainingBytes(in) / sizeof(T)) {
+        return false;
+    }
+    vec.resize(size);
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(vec.data()), size * sizeof(T)));
+}
+
+// The strings are stored as one character array and the offsets of the strings
+void writeStrings(std::ofstream& out, const std::vector<std::string>& strs) {
+    std::vector<char> chars;
+    std::vector<uint64_t> offsets{0};
+    for (const auto& str : strs) {
+        chars.insert(chars.end(), str.begin(), str.end());
+        offsets.push_back(chars.size());
+    }
+    writeVector(out, chars);
+    writeVector(out, offsets);
+}
+
+bool readStrings(std::ifstream& in, std::vector<std::string>& strs) {
+    std::vector<char> chars;
+    std::vector<uint64_t> offsets;
+    if (!readVector(in, chars) || !readVector(in, offsets) || offsets.empty()
+        || offsets.front() != 0 || offsets.back() != chars.size()
+        || !std::is_sorted(offsets.begin(), offsets.end())) {
+        return false;
+    }
+    strs.clear();
+    strs.reserve(offsets.size() - 1);
+    for (size_t i = 0; i + 1 < offsets.size(); i++) {
+        strs.emplace_back(chars.data() + offsets[i], chars.data() + offsets[i + 1]);
+    }
+    return true;
+}
+
+void writePaths(std::ofstream& out, const TimingPathStore& paths) {
+    writeVector(out, paths.vind);
+    writeVector(out, paths.vptr);
+    writeVector(out, paths.eind);
+    writeVector(out, paths.eptr);
+    writeVector(out, paths.slacks);
+}
+
+bool readPaths(std::ifstream& in, TimingPathStore& paths) {
+    return readVector(in, paths.vind) && readVector(in, paths.vptr)
+           && readVector(in, paths.eind) && readVector(in, paths.eptr)
+           && readVector(in, paths.slacks)
+           && paths.vptr.size() == paths.slacks.size() + 1
+           && paths.eptr.size() == paths.slacks.size() + 1;
+}
+
+// Check a CSR array: ptr holds non-decreasing offsets from 0 to ind.size(),
+// and all the indices of ind are in [0, upper)
+bool isValidCsr(const std::vector<int>& ind, const std::vector<int>& ptr, size_t upper) {
+    if (ptr.empty() || ptr.front() != 0 || static_cast<size_t>(ptr.back()) != ind.size()) {
+        return false;
+    }
+    for (size_t i = 1; i < ptr.size(); i++) {
+        if (ptr[i - 1] > ptr[i]) {
+            return false;
+        }
+    }
+    for (const int index : ind) {
+        if (index < 0 || static_cast<size_t>(index) >= upper) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// The vertices and the hyperedges of the paths must be in the hypergraph
+bool isValidPaths(const TimingPathStore& paths, size_t num_vertices, size_t num_hyperedges) {
+    return isValidCsr(paths.vind, paths.vptr, num_vertices)
+           && isValidCsr(paths.eind, paths.eptr, num_hyperedges);
+}
+
+} // namespace
+
+std::string computeFrontEndCacheKey(const std::vector<std::string>& input_files,
+                                    const std::string& top_module,
+                                    const std::string& options) {
+    uint64_t hash = kFnvOffset;
+    hashBytes(hash, reinterpret_cast<const char*>(&kCacheVersion), sizeof(kCacheVersion));
+    std::vector<char> buffer(1 << 20);
+    for (const auto& filename : input_files) {
+        std::ifstream in(filename, std::ios::binary);
+        if (!in.is_open()) {
+            return "";
+        }
+        uint64_t file_size = 0;
+        while (in) {
+            in.read(buffer.data(), buffer.size());
+            const size_t num_read = static_cast<size_t>(in.gcount());
+            hashBytes(hash, buffer.data(), num_read);
+            file_size += num_read;
+        }
+        // separate the files, so that moving bytes across files changes the key
+        hashBytes(hash, reinterpret_cast<const char*>(&file_size), sizeof(file_size));
+    }
+    hashString(hash, top_module);
+    hashString(hash, options);
+
+    char key[17];
+    std::snprintf(key, sizeof(key), "%016llx", static_cast<unsigned long long>(hash));
+    return key;
+}
+
+std::shared_ptr<CachedAdapter> CachedAdapter::load(const std::string& filename) {
+    // a cache which cannot be loaded is a cache miss
+    try {
+        return loadFile(filename);
+    } catch (const std::exception& e) {
+        Logger::getInstance().warning("Ignoring unreadable front-end cache " + filename + ": "
+                                      + e.what());
+        return nullptr;
+    }
+}
+
+std::shared_ptr<CachedAdapter> CachedAdapter::loadFile(const std::string& filename) {
+    auto& logger = Logger::getInstance();
+
+    std::ifstream in(filename, std::ios::binary);
+    if (!in.is_open()) {
+        return nullptr;
+    }
+
+    char magic[sizeof(kCacheMagic)];
+    uint32_t version = 0;
+    if (!in.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), kCacheMagic)
+        || !readPod(in, version) || version != kCacheVersion) {
+        logger.warning("Ignoring front-end cache with unknown format: " + filename);
+        return nullptr;
+    }
+
+    auto adapter = std::make_shared<CachedAdapter>();
+    int32_t vertex_dimensions = 0;
+    int32_t hyperedge_dimensions = 0;
+    std::vector<float> vertex_weights;
+    std::vector<int> eind;
+    std::vector<int> eptr;
+    std::vector<float> hyperedge_weights;
+    uint8_t has_timing = 0;
+    std::vector<int32_t> vertex_types;
+    std::vector<float> hyperedge_slacks;
+    std::vector<int> arc_ind;
+    std::vector<int> arc_ptr;
+    TimingPathStore hypergraph_paths;
+    bool ok = readPod(in, adapter->clock_period_) && readPod(in, vertex_dimensions)
+              && readPod(in, hyperedge_dimensions) && vertex_dimensions > 0
+              && hyperedge_dimensions > 0 && readVector(in, vertex_weights)
+              && readVector(in, eind) && readVector(in, eptr)
+              && readVector(in, hyperedge_weights) && readPod(in, has_timing);
+    if (ok && has_timing) {
+        ok = readVector(in, vertex_types) && readVector(in, hyperedge_slacks)
+             && readVector(in, arc_ind) && readVector(in, arc_ptr)
+             && readPaths(in, hypergraph_paths);
+    }
+    ok = ok && readVector(in, adapter->net_slacks_) && readPaths(in, adapter->timing_paths_)
+         && readStrings(in, adapter->instance_names_) && readStrings(in, adapter->cell_types_)
+         && readStrings(in, adapter->net_names_);
+    // Check the values as well as the sizes: a stale or corrupted cache
+    // is a cache miss (the front end runs again) instead of a crash
+    ok = ok && vertex_weights.size() % vertex_dimensions == 0
+         && hyperedge_weights.size() % hyperedge_dimensions == 0;
+    // the dimensions are only known to be positive if everything was read
+    const size_t num_vertices = ok ? vertex_weights.size() / vertex_dimensions : 0;
+    const size_t num_hyperedges = ok ? hyperedge_weights.size() / hyperedge_dimensions : 0;
+    ok = ok && eptr.size() == num_hyperedges + 1 && isValidCsr(eind, eptr, num_vertices)
+         && isValidPaths(adapter->timing_paths_, num_vertices, num_hyperedges)
+         && adapter->instance_names_.size() <= num_vertices
+         && adapter->cell_types_.size() == adapter->instance_names_.size()
+         && adapter->net_names_.size() <= num_hyperedges;
+    if (ok && has_timing) {
+        ok = vertex_types.size() == num_vertices
+             && std::all_of(vertex_types.begin(), vertex_types.end(),
+                            [](int32_t type) { return type >= kCombStdCell && type <= kPort; })
+             && hyperedge_slacks.size() == num_hyperedges
+             && arc_ptr.size() == num_hyperedges + 1
+             && isValidCsr(arc_ind, arc_ptr, num_hyperedges)
+             && isValidPaths(hypergraph_paths, num_vertices, num_hyperedges);
+    }
+    if (!ok) {
+        logger.warning("Ignoring corrupted front-end cache: " + filename);
+        return nullptr;
+    }
+
+    // rebuild the hypergraph exactly as it was built by the adapter
+    HypergraphBuilder builder;
+    builder.vertex_dimensions = vertex_dimensions;
+    builder.hyperedge_dimensions = hyperedge_dimensions;
+    builder.eind = std::move(eind);
+    builder.eptr = std::move(eptr);
+    builder.vertex_weights = std::move(vertex_weights);
+    builder.hyperedge_weights = std::move(hyperedge_weights);
+    if (has_timing) {
+        builder.vertex_types.reserve(vertex_types.size());
+        for (const int32_t type : vertex_types) {
+            builder.vertex_types.push_back(static_cast<VertexType>(type));
+        }
+        builder.hyperedges_slack = std::move(hyperedge_slacks);
+        builder.arc_ind = std::move(arc_ind);
+        builder.arc_ptr = std::move(arc_ptr);
+        builder.timing_paths = std::move(hypergraph_paths);
+    }
+    adapter->hypergraph_ = builder.Build(&logger);
+
+    logger.info("Loaded front-end cache " + filename + ": " +
+                std::to_string(adapter->hypergraph_->GetNumVertices()) + " vertices, " +
+                std::to_string(adapter->hypergraph_->GetNumHyperedges()) + " hyperedges, " +
+                std::to_string(adapter->hypergraph_->GetNumTimingPaths()) + " timing paths");
+    return adapter;
+}
+
+bool CachedAdapter::write(const std::string& filename,
+                          const NetlistAdapter& adapter,
+                          const Hypergraph& hypergraph,
+                          const TimingPathStore& timing_paths) {
+    auto& logger = Logger::getInstance();
+
+    const int num_vertices = hypergraph.GetNumVertices();
+    const int num_hyperedges = hypergraph.GetNumHyperedges();
+    const int32_t vertex_dimensions = hypergraph.GetVertexDimensions();
+    const int32_t hyperedge_dimensions = hypergraph.GetHyperedgeDimensions();
+    const bool has_timing = hypergraph.HasTiming();
+
+    // hyperedges and arc sets in CSR format
+    std::vector<int> eind;
+    std::vector<int> eptr{0};
+    std::vector<int> arc_ind;
+    std::vector<int> arc_ptr{0};
+    eind.reserve(hypergraph.GetNumPins());
+    for (int e = 0; e < num_hyperedges; e++) {
+        for (const int v : hypergraph.Vertices(e)) {
+            eind.push_back(v);
+        }
+        eptr.push_back(static_cast<int>(eind.size()));
+        if (has_timing) {
+            const auto& arc_set = hypergraph.GetHyperedgeArcSet(e);
+            arc_ind.insert(arc_ind.end(), arc_set.begin(), arc_set.end());
+            arc_ptr.push_back(static_cast<int>(arc_ind.size()));
+        }
+    }
+
+    std::vector<int32_t> vertex_types;
+    std::vector<float> net_slacks;
+    TimingPathStore hypergraph_paths;
+    if (has_timing) {
+        vertex_types.reserve(num_vertices);
+        for (int v = 0; v < num_vertices; v++) {
+            vertex_types.push_back(hypergraph.GetVertexType(v));
+        }
+        for (int path_id = 0; path_id < hypergraph.GetNumTimingPaths(); path_id++) {
+            hypergraph_paths.AddPath(hypergraph.PathVertices(path_id),
+                                     hypergraph.PathEdges(path_id),
+                                     hypergraph.PathTimingSlack(path_id));
+        }
+        net_slacks.reserve(adapter.getNumNets());
+        for (int net_id = 0; net_id < adapter.getNumNets(); net_id++) {
+            net_slacks.push_back(adapter.getNetSlack(net_id));
+        }
+    }
+
+    std::vector<std::string> instance_names;
+    std::vector<std::string> cell_types;
+    for (const auto& inst : adapter.getInstances()) {
+        instance_names.push_back(inst.name);
+        cell_types.push_back(inst.cell_type);
+    }
+    std::vector<std::string> net_names;
+    for (const auto& net : adapter.getNets()) {
+        net_names.push_back(net.name);
+    }
+
+    // write to a temporary file, then rename it to the cache file
+    const std::string tmp_filename = filename + ".tmp." + std::to_string(getpid());
+    {
+        std::ofstream out(tmp_filename, std::ios::binary);
+        if (!out.is_open()) {
+            logger.warning("Cannot write front-end cache: " + filename);
+            return false;
+        }
+        out.write(kCacheMagic, sizeof(kCacheMagic));
+        writePod(out, kCacheVersion);
+        writePod(out, adapter.getClockPeriod());
+        writePod(out, vertex_dimensions);
+        writePod(out, hyperedge_dimensions);
+        // the weights are stored row by row in the hypergraph
+        writeVector(out, hypergraph.GetFlatVertexWeights());
+        writeVector(out, eind);
+        writeVector(out, eptr);
+        writeVector(out, hypergraph.GetFlatHyperedgeWeights());
+        writePod(out, static_cast<uint8_t>(has_timing));
+        if (has_timing) {
+            writeVector(out, vertex_types);
+            writeVector(out, hypergraph.GetHyperedgeTimingAttr());
+            writeVector(out, arc_ind);
+            writeVector(out, arc_ptr);
+            writePaths(out, hypergraph_paths);
+        }
+        writeVector(out, net_slacks);
+        writePaths(out, timing_paths);
+        writeStrings(out, instance_names);
+        writeStrings(out, cell_types);
+        writeStrings(out, net_names);
+        if (!out) {
+            logger.warning("Failed to write front-end cache: " + filename);
+            out.close();
+            std::remove(tmp_filename.c_str());
+            return false;
+        }
+    }
+    if (std::rename(tmp_filename.c_str(), filename.c_str()) != 0) {
+        logger.warning("Failed to write front-end cache: " + filename);
+        std::remove(tmp_filename.c_str());
+        return false;
+    }
+
+    logger.info("Front-end result cached to " + filename);
+    return true;
+}
+
+std::vector<Instance> CachedAdapter::getInstances() const {
+    std::vector<Instance> instances;
+    instances.reserve(instance_names_.size());
+    for (size_t i = 0; i < instance_names_.size(); i++) {
+        Instance inst;
+        inst.name = instance_names_[i];
+        inst.cell_type = cell_types_[i];
+        inst.id = static_cast<int>(i);
+        inst.is_sequential = hypergraph_->HasTiming()
+                             && hypergraph_->GetVertexType(inst.id) == kSeqStdCell;
+        inst.is_macro = hypergraph_->HasTiming()
+                        && hypergraph_->GetVertexType(inst.id) == kMacro;
+        inst.area = hypergraph_->GetVertexWeights(inst.id)[0];
+        instances.push_back(inst);
+    }
+    return instances;
+}
+
+std::vector<Net> CachedAdapter::getNets() const {
+    std::vector<Net> nets;
+    nets.reserve(net_names_.size());
+    for (size_t e = 0; e < net_names_.size(); e++) {
+        Net net;
+        net.name = net_names_[e];
+        net.id = static_cast<int>(e);
+        for (const int v : hypergraph_->Vertices(net.id)) {
+            net.instances.push_back(v);
+        }
+        net.weight = hypergraph_->GetHyperedgeWeights(net.id)[0];
+        nets.push_back(net);
+    }
+    return nets;
+}
+
+TimingPathStore CachedAdapter::getCriticalPaths(int max_paths) const {
+    if (max_paths >= timing_paths_.size()) {
+        return timing_paths_;
+    }
+    // the paths are sorted by slack, keep the first max_paths ones
+    TimingPathStore paths;
+    for (int path_id = 0; path_id < max_paths; path_id++) {
+        paths.AddPath(timing_paths_.PathVertices(path_id),
+                      timing_paths_.PathEdges(path_id),
+                      timing_paths_.slacks[path_id]);
+    }
+    return paths;
+}
+
+float CachedAdapter::getNetSlack(int net_id) const {
+    if (net_id < 0 || net_id >= static_cast<int>(net_slacks_.size())) {
+        return 0.0f;
+    }
+    return net_slacks_[net_id];
+}
+
+int CachedAdapter::getNumPins() const {
+    return hypergraph_ ? hypergraph_->GetNumPins() : 0;
+}
+
+} // namespace par
@@ -0,0 +1,78 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Cached front-end result (hypergraph + timing) for repeated runs
+
+#pragma once
+
+#include "NetlistAdapter.h"
+#include "../src/Hypergraph.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace par {
+
+// Key of a front-end run: a 64-bit hash (hex) of the contents of the input
+// files (in the given order), the top module and the options string.
+// Returns an empty string if one of the input files cannot be read.
+std::string computeFrontEndCacheKey(const std::vector<std::string>& input_files,
+                                    const std::string& top_module,
+                                    const std::string& options);
+
+// Netlist adapter which serves the front-end result of an earlier run,
+// i.e., the built hypergraph (with vertex types, hyperedge slacks and timing
+// paths), the net slacks, the critical paths and the instance and net names.
+// Nothing is read or analyzed again: a cache hit replaces the OpenStaAdapter.
+// The cached hypergraph was built with the timing options of the cache key,
+// so buildTimingHypergraph ignores its arguments.
+class CachedAdapter : public NetlistAdapter {
+public:
+    // Load a cache file written by write(), nullptr if it is missing or invalid
+    static std::shared_ptr<CachedAdapter> load(const std::string& filename);
+
+    // Save the front-end result of adapter to filename (written to a
+    // temporary file first, so concurrent runs never see a partial file).
+    // timing_paths are the paths returned by adapter.getCriticalPaths.
+    static bool write(const std::string& filename,
+                      const NetlistAdapter& adapter,
+                      const Hypergraph& hypergraph,
+                      const TimingPathStore& timing_paths);
+
+    // NetlistAdapter interface
+    // The input files were already read by the run that wrote the cache
+    bool readNetlist(const std::string& filename, const std::string& top_module = "") override { return true; }
+    bool readSDC(const std::string& filename) override { return true; }
+    bool readLiberty(const std::string& filename) override { return true; }
+    bool runTimingAnalysis() override { return true; }
+
+    std::vector<Instance> getInstances() const override;
+    std::vector<Net> getNets() const override;
+    std::vector<Pin> getPins() const override { return {}; }
+
+    TimingPathStore getCriticalPaths(int max_paths = 100) const override;
+    float getNetSlack(int net_id) const override;
+
+    std::shared_ptr<Hypergraph> buildHypergraph() override { return hypergraph_; }
+    std::shared_ptr<Hypergraph> buildTimingHypergraph(
+        const TimingPathStore& timing_paths, float extra_delay, bool guardband) override {
+        return hypergraph_;
+    }
+    float getClockPeriod() const override { return clock_period_; }
+
+    int getNumInstances() const override { return static_cast<int>(instance_names_.size()); }
+    int getNumNets() const override { return static_cast<int>(net_names_.size()); }
+    int getNumPins() const override;
+
+private:
+    // load() without catching the exceptions
+    static std::shared_ptr<CachedAdapter> loadFile(const std::string& filename);
+
+    std::shared_ptr<Hypergraph> hypergraph_;
+    std::vector<std::string> instance_names_;
+    std::vector<std::string> cell_types_;
+    std::vector<std::string> net_names_;
+    std::vector<float> net_slacks_;  // empty without timing
+    TimingPathStore timing_paths_;  // slacks not normalized
+    float clock_period_ = 0.0f;
+};
+
+} // namespace par
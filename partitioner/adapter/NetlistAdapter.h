@@ -13,6 +13,7 @@ namespace par {
 // Forward declarations
 class Hypergraph;
 struct TimingPath;  // Defined in Hypergraph.h
+struct TimingPathStore;  // Defined in Hypergraph.h
 
 // Basic data structures for netlist representation
 struct Instance {
@@ -41,7 +42,7 @@ struct Pin {
 };
 
 // Use TimingPath from Hypergraph.h which is already defined there
-// struct TimingPath is defined in src/Hypergraph.h
+// struct TimingPath and struct TimingPathStore are defined in src/Hypergraph.h
 
 // Abstract base class for netlist adapters
 class NetlistAdapter {
@@ -66,18 +67,36 @@ public:
     // Perform timing analysis
     virtual bool runTimingAnalysis() = 0;
     
+    // Number of threads used by timing analysis (<= 0 means all the hardware threads)
+    virtual void setNumThreads(int num_threads) {
+        // Default implementation is single-threaded
+    }
+    
     // Get netlist components
     virtual std::vector<Instance> getInstances() const = 0;
     virtual std::vector<Net> getNets() const = 0;
     virtual std::vector<Pin> getPins() const = 0;
     
-    // Get timing paths
-    virtual std::vector<TimingPath> getCriticalPaths(int max_paths = 100) const = 0;
+    // Get timing paths (in CSR format, sorted by slack)
+    virtual TimingPathStore getCriticalPaths(int max_paths = 100) const = 0;
     virtual float getNetSlack(int net_id) const = 0;
     
     // Convert to TritonPart hypergraph
     virtual std::shared_ptr<Hypergraph> buildHypergraph() = 0;
     
+    // Convert to TritonPart hypergraph with timing information, i.e., vertex
+    // types, hyperedge slacks and the given critical paths (from
+    // getCriticalPaths). All the slacks are normalized to the clock period,
+    // and extra_delay (in seconds) is subtracted from them if guardband is set.
+    virtual std::shared_ptr<Hypergraph> buildTimingHypergraph(
+        const TimingPathStore& timing_paths, float extra_delay, bool guardband) {
+        // Default implementation ignores the timing information
+        return buildHypergraph();
+    }
+    
+    // Maximum clock period of the extracted critical paths (0 if unknown)
+    virtual float getClockPeriod() const { return 0.0f; }
+    
     // Get statistics
     virtual int getNumInstances() const = 0;
     virtual int getNumNets() const = 0;
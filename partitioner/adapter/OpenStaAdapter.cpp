@@ -13,12 +13,15 @@
 #include "sta/MinMax.hh"
 #include "sta/PortDirection.hh"
 #include "sta/StaMain.hh"
+#include "sta/DispatchQueue.hh"
 
 #include <tcl.h>
+#include <algorithm>
 #include <memory>
-#include <map>
 #include <set>
-#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+#include <thread>
 
 // External TCL init array from OpenSTA
 namespace sta {
@@ -27,6 +30,34 @@ extern const char *tcl_inits[];
 
 namespace par {
 
+// Split [0, num_items) into at most num_threads contiguous chunks and call
+// func(begin, end, results[chunk_id]) for each chunk on the OpenSTA
+// dispatch threads. The chunks are ordered, so merging results in order
+// gives the same result as a sequential traversal.
+template <typename T, typename Func>
+static void forEachChunk(size_t num_items, int num_threads, std::vector<T>& results, Func func) {
+    results.clear();
+    if (num_items == 0) {
+        return;
+    }
+    const size_t num_chunks = std::min(num_items, static_cast<size_t>(std::max(num_threads, 1)));
+    const size_t chunk_size = (num_items + num_chunks - 1) / num_chunks;
+    results.resize((num_items + chunk_size - 1) / chunk_size);
+    if (results.size() == 1) {
+        func(0, num_items, results[0]);
+        return;
+    }
+    sta::DispatchQueue dispatch_queue(results.size());
+    for (size_t chunk_id = 0; chunk_id < results.size(); chunk_id++) {
+        const size_t begin = chunk_id * chunk_size;
+        const size_t end = std::min(begin + chunk_size, num_items);
+        dispatch_queue.dispatch([&func, &results, chunk_id, begin, end](int) {
+            func(begin, end, results[chunk_id]);
+        });
+    }
+    dispatch_queue.finishTasks();
+}
+
 // Private implementation class
 class OpenStaImpl {
 public:
@@ -112,6 +143,21 @@ OpenStaAdapter::OpenStaAdapter()
 
 OpenStaAdapter::~OpenStaAdapter() = default;
 
+void OpenStaAdapter::setNumThreads(int num_threads) {
+    if (!sta_impl_) {
+        return;
+    }
+    
+    if (num_threads <= 0) {
+        num_threads = std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+    }
+    
+    // OpenSTA runs single-threaded by default. The thread count is used by
+    // the levelized BFS (delay calculation, arrival and required search).
+    sta_impl_->sta_->setThreadCount(num_threads);
+    Logger::getInstance().info("OpenSTA thread count: " + std::to_string(num_threads));
+}
+
 bool OpenStaAdapter::readLiberty(const std::string& filename) {
     auto& logger = Logger::getInstance();
     
@@ -242,14 +288,24 @@ void OpenStaAdapter::extractNetlistData() {
     sta::Network* network = sta_impl_->network_;
     sta::Instance* top_inst = network->topInstance();
     
+    // Clear existing data
+    instances_.clear();
+    nets_.clear();
+    pins_.clear();
+    sta_ports_.clear();
+    sta_insts_.clear();
+    sta_nets_.clear();
+    inst_to_id_.clear();
+    net_to_id_.clear();
+    eind_.clear();
+    eptr_.clear();
+    eptr_.push_back(0);
+    net_slacks_.clear();
+    
     if (!top_inst) {
         logger.warning("No top instance found - using dummy data");
         
         // Create dummy data for testing
-        instances_.clear();
-        nets_.clear();
-        pins_.clear();
-        
         for (int i = 0; i < 10; i++) {
             Instance inst;
             inst.id = i;
@@ -259,6 +315,7 @@ void OpenStaAdapter::extractNetlistData() {
             inst.is_macro = false;
             inst.area = 1.0f;
             instances_.push_back(inst);
+            sta_insts_.push_back(nullptr);
         }
         
         for (int i = 0; i < 8; i++) {
@@ -266,22 +323,21 @@ void OpenStaAdapter::extractNetlistData() {
             net.id = i;
             net.name = "dummy_net_" + std::to_string(i);
             net.weight = 1.0f;
-            net.instances.push_back(i);
-            net.instances.push_back((i + 1) % 10);
             nets_.push_back(net);
+            sta_nets_.push_back(nullptr);
+            eind_.push_back(i);
+            eind_.push_back((i + 1) % 10);
+            eptr_.push_back(static_cast<int>(eind_.size()));
         }
         
+        names_cached_ = false;
         data_cached_ = true;
         return;
     }
     
-    // Clear existing data
-    instances_.clear();
-    nets_.clear();
-    pins_.clear();
-    
+    // All the STA objects are mapped to dense ids by pointer in a single
+    // pass. The names are only built when they are needed (see ensureNames).
     int inst_id = 0;
-    std::map<sta::Instance*, int> inst_to_id;
     
     // ========================================
     // Step 1: Add top-level ports as vertices FIRST (like OpenROAD does)
@@ -289,49 +345,37 @@ void OpenStaAdapter::extractNetlistData() {
     // ========================================
     sta::Cell* top_cell = network->cell(top_inst);
     int port_count = 0;
-    std::map<sta::Port*, int> port_to_id;  // 端口到 vertex ID 的映射
+    std::unordered_map<const sta::Port*, int> port_to_id;  // 端口到 vertex ID 的映射
+    
+    auto add_port = [&](const sta::Port* port) {
+        Instance port_inst;
+        port_inst.id = inst_id;
+        port_inst.cell_type = "PORT";
+        port_inst.is_sequential = false;
+        port_inst.is_macro = false;
+        port_inst.area = 0.0f;  // IO port has no area
+        
+        instances_.push_back(port_inst);
+        sta_ports_.push_back(port);
+        port_to_id[port] = inst_id;
+        inst_id++;
+        port_count++;
+    };
     
     if (top_cell) {
         sta::CellPortIterator* port_iter = network->portIterator(top_cell);
         while (port_iter->hasNext()) {
             sta::Port* port = port_iter->next();
             
-            // 跳过 bus 端口，只处理 bit 端口
-            // OpenROAD 处理的是展开后的端口
+            // OpenROAD 处理的是展开后的端口, 遍历 bus 的每个 bit
             if (network->isBus(port)) {
-                // 遍历 bus 的每个 bit
                 sta::PortMemberIterator* member_iter = network->memberIterator(port);
                 while (member_iter->hasNext()) {
-                    sta::Port* bit_port = member_iter->next();
-                    
-                    Instance port_inst;
-                    port_inst.id = inst_id;
-                    port_inst.name = network->name(bit_port);
-                    port_inst.cell_type = "PORT";
-                    port_inst.is_sequential = false;
-                    port_inst.is_macro = false;
-                    port_inst.area = 0.0f;  // IO port has no area
-                    
-                    instances_.push_back(port_inst);
-                    port_to_id[bit_port] = inst_id;
-                    inst_id++;
-                    port_count++;
+                    add_port(member_iter->next());
                 }
                 delete member_iter;
             } else {
-                // 非 bus 端口直接添加
-                Instance port_inst;
-                port_inst.id = inst_id;
-                port_inst.name = network->name(port);
-                port_inst.cell_type = "PORT";
-                port_inst.is_sequential = false;
-                port_inst.is_macro = false;
-                port_inst.area = 0.0f;  // IO port has no area
-                
-                instances_.push_back(port_inst);
-                port_to_id[port] = inst_id;
-                inst_id++;
-                port_count++;
+                add_port(port);
             }
         }
         delete port_iter;
@@ -356,20 +400,13 @@ void OpenStaAdapter::extractNetlistData() {
         
         Instance inst;
         inst.id = inst_id;
-        inst.name = network->pathName(sta_inst);
-        
-        // Get cell info
-        sta::Cell* cell = network->cell(sta_inst);
-        if (cell) {
-            inst.cell_type = network->name(cell);
-        }
-        
         inst.is_sequential = lib_cell->hasSequentials();
         inst.is_macro = lib_cell->isMacro();
         inst.area = lib_cell->area();
         
         instances_.push_back(inst);
-        inst_to_id[sta_inst] = inst_id;
+        sta_insts_.push_back(sta_inst);
+        inst_to_id_[sta_inst] = inst_id;
         inst_id++;
         
         // Log progress every 10000 instances
@@ -392,134 +429,192 @@ void OpenStaAdapter::extractNetlistData() {
     // 关键：OpenSTA 的网络是按层次结构组织的
     // 我们需要遍历所有叶子实例的引脚，收集它们连接的网络
     // 使用 highestConnectedNet 获取最高层级的网络，避免重复
+    // The network is only read here, so the work is split into chunks
+    // running on the OpenSTA dispatch threads. The chunks are merged in
+    // order, so the net ids are the same as a sequential traversal, i.e.,
+    // nets are numbered by their first connection in leaf-instance order.
+    // The hyperedges are written directly in CSR format (eind_, eptr_)
     // ========================================
     logger.info("Starting net extraction...");
-    int net_id = 0;
-    int skipped_single = 0;
-    int skipped_no_driver = 0;
-    int skipped_power = 0;
-    
-    // 使用 set 来避免重复处理同一个网络
-    // 使用 highestConnectedNet 作为 key，确保同一个逻辑网络只处理一次
-    std::set<const sta::Net*> processed_nets;
-    std::map<const sta::Net*, int> net_to_id_map;
-    
-    // 方法：遍历所有叶子实例的引脚，收集它们连接的网络
-    // 使用 highestConnectedNet 获取最高层级的网络
-    sta::LeafInstanceIterator* leaf_iter2 = network->leafInstanceIterator();
-    while (leaf_iter2->hasNext()) {
-        sta::Instance* sta_inst = leaf_iter2->next();
-        
-        // 只处理有 Liberty cell 的实例
-        if (inst_to_id.find(sta_inst) == inst_to_id.end()) {
-            continue;
-        }
-        
-        // 遍历实例的所有引脚
-        sta::InstancePinIterator* pin_iter = network->pinIterator(sta_inst);
-        while (pin_iter->hasNext()) {
-            sta::Pin* pin = pin_iter->next();
-            sta::Net* pin_net = network->net(pin);
-            
-            if (pin_net) {
+    const int num_threads = std::max(1, static_cast<int>(sta_impl_->sta_->threadCount()));
+    
+    // (a) find the highest nets connected to each chunk of instances,
+    //     in the order of their first connection within the chunk
+    std::vector<std::vector<const sta::Net*>> chunk_nets;
+    forEachChunk(sta_insts_.size(), num_threads, chunk_nets, [&](size_t begin, size_t end, std::vector<const sta::Net*>& nets) {
+        std::unordered_set<const sta::Net*> local_nets;  // thread-local table
+        for (size_t i = begin; i < end; i++) {
+            // 遍历实例的所有引脚
+            sta::InstancePinIterator* pin_iter = network->pinIterator(sta_insts_[i]);
+            while (pin_iter->hasNext()) {
+                sta::Net* pin_net = network->net(pin_iter->next());
+                if (!pin_net) {
+                    continue;
+                }
                 // 获取最高层级的网络，确保同一个逻辑网络只处理一次
                 const sta::Net* highest_net = network->highestConnectedNet(pin_net);
+                if (local_nets.insert(highest_net).second) {
+                    nets.push_back(highest_net);
+                }
+            }
+            delete pin_iter;
+        }
+    });
+    
+    // (b) merge the chunks in order
+    std::vector<const sta::Net*> candidate_nets;
+    {
+        std::unordered_set<const sta::Net*> processed_nets;
+        for (const auto& nets : chunk_nets) {
+            for (const sta::Net* net : nets) {
+                if (processed_nets.insert(net).second) {
+                    candidate_nets.push_back(net);
+                }
+            }
+        }
+        chunk_nets.clear();
+    }
+    
+    // (c) build the hyperedges (driver + sorted unique loads) of each chunk
+    //     of candidate nets
+    struct NetChunk {
+        std::vector<const sta::Net*> nets;  // the nets kept as hyperedges
+        std::vector<int> eind;
+        std::vector<int> eptr{0};
+        int skipped_single = 0;
+        int skipped_no_driver = 0;
+        int skipped_power = 0;
+    };
+    std::vector<NetChunk> net_chunks;
+    forEachChunk(candidate_nets.size(), num_threads, net_chunks, [&](size_t begin, size_t end, NetChunk& chunk) {
+        std::vector<int> loads_id;
+        for (size_t i = begin; i < end; i++) {
+            const sta::Net* highest_net = candidate_nets[i];
+            
+            // 跳过电源网络
+            if (network->isPower(highest_net) || network->isGround(highest_net)) {
+                chunk.skipped_power++;
+                continue;
+            }
+            
+            // 遍历网络连接的所有引脚（包括层次结构中的所有引脚）
+            int driver_id = -1;
+            loads_id.clear();
+            sta::NetConnectedPinIterator* conn_iter = network->connectedPinIterator(highest_net);
+            while (conn_iter->hasNext()) {
+                const sta::Pin* conn_pin = conn_iter->next();
+                const sta::Instance* conn_inst = network->instance(conn_pin);
                 
-                if (processed_nets.find(highest_net) == processed_nets.end()) {
-                    processed_nets.insert(highest_net);
-                    
-                    // 跳过电源网络
-                    if (network->isPower(highest_net) || network->isGround(highest_net)) {
-                        skipped_power++;
-                        continue;
-                    }
-                    
-                    // 检查网络连接
-                    int driver_id = -1;
-                    std::set<int> loads_id;
-                    
-                    // 遍历网络连接的所有引脚（包括层次结构中的所有引脚）
-                    sta::NetConnectedPinIterator* conn_iter = network->connectedPinIterator(highest_net);
-                    while (conn_iter->hasNext()) {
-                        const sta::Pin* conn_pin = conn_iter->next();
-                        sta::Instance* conn_inst = network->instance(conn_pin);
-                        
-                        // 检查是否是叶子实例（有 Liberty cell 的实例）
-                        if (conn_inst && inst_to_id.find(conn_inst) != inst_to_id.end()) {
-                            int vertex_id = inst_to_id[conn_inst];
-                            
-                            // 判断是 driver 还是 load
-                            sta::PortDirection* dir = network->direction(conn_pin);
-                            if (dir->isOutput()) {
-                                driver_id = vertex_id;
-                            } else {
-                                loads_id.insert(vertex_id);
-                            }
-                        }
-                        // 检查是否是顶层端口
-                        else if (network->isTopLevelPort(conn_pin)) {
-                            // 获取端口
-                            sta::Port* port = network->port(conn_pin);
-                            if (port && port_to_id.find(port) != port_to_id.end()) {
-                                int vertex_id = port_to_id[port];
-                                // 顶层 input port 是 driver，output port 是 load
-                                sta::PortDirection* dir = network->direction(conn_pin);
-                                if (dir->isInput()) {
-                                    driver_id = vertex_id;
-                                } else {
-                                    loads_id.insert(vertex_id);
-                                }
-                            }
-                        }
-                    }
-                    delete conn_iter;
-                    
-                    // 构建超边：driver + loads
-                    std::vector<int> hyperedge;
-                    if (driver_id != -1 && !loads_id.empty()) {
-                        hyperedge.push_back(driver_id);
-                        for (int load_id : loads_id) {
-                            if (load_id != driver_id) {
-                                hyperedge.push_back(load_id);
-                            }
-                        }
+                // 检查是否是叶子实例（有 Liberty cell 的实例）
+                auto inst_it = conn_inst ? inst_to_id_.find(conn_inst) : inst_to_id_.end();
+                if (inst_it != inst_to_id_.end()) {
+                    // 判断是 driver 还是 load
+                    if (network->direction(conn_pin)->isOutput()) {
+                        driver_id = inst_it->second;
+                    } else {
+                        loads_id.push_back(inst_it->second);
                     }
-                    
-                    // 只保留连接 2 个以上顶点的网络
-                    if (hyperedge.size() >= 2) {
-                        Net net_obj;
-                        net_obj.id = net_id;
-                        net_obj.name = network->pathName(highest_net);
-                        net_obj.weight = 1.0f;
-                        net_obj.instances = hyperedge;
-                        
-                        nets_.push_back(net_obj);
-                        net_to_id_map[highest_net] = net_id;
-                        net_id++;
-                        
-                        if (net_id % 10000 == 0) {
-                            logger.info("Extracted " + std::to_string(net_id) + " nets...");
+                } else if (network->isTopLevelPort(conn_pin)) {
+                    // 顶层 input port 是 driver，output port 是 load
+                    auto port_it = port_to_id.find(network->port(conn_pin));
+                    if (port_it != port_to_id.end()) {
+                        if (network->direction(conn_pin)->isInput()) {
+                            driver_id = port_it->second;
+                        } else {
+                            loads_id.push_back(port_it->second);
                         }
-                    } else if (hyperedge.size() == 1) {
-                        skipped_single++;
-                    } else {
-                        skipped_no_driver++;
                     }
                 }
             }
+            delete conn_iter;
+            
+            if (driver_id == -1 || loads_id.empty()) {
+                chunk.skipped_no_driver++;
+                continue;
+            }
+            
+            std::sort(loads_id.begin(), loads_id.end());
+            loads_id.erase(std::unique(loads_id.begin(), loads_id.end()), loads_id.end());
+            loads_id.erase(std::remove(loads_id.begin(), loads_id.end(), driver_id), loads_id.end());
+            
+            // 只保留连接 2 个以上顶点的网络
+            if (loads_id.empty()) {
+                chunk.skipped_single++;
+                continue;
+            }
+            
+            chunk.eind.push_back(driver_id);
+            chunk.eind.insert(chunk.eind.end(), loads_id.begin(), loads_id.end());
+            chunk.eptr.push_back(static_cast<int>(chunk.eind.size()));
+            chunk.nets.push_back(highest_net);
+        }
+    });
+    
+    // (d) number the nets and concatenate the CSR arrays in order
+    int skipped_single = 0;
+    int skipped_no_driver = 0;
+    int skipped_power = 0;
+    for (const auto& chunk : net_chunks) {
+        skipped_single += chunk.skipped_single;
+        skipped_no_driver += chunk.skipped_no_driver;
+        skipped_power += chunk.skipped_power;
+        const int offset = static_cast<int>(eind_.size());
+        eind_.insert(eind_.end(), chunk.eind.begin(), chunk.eind.end());
+        for (size_t j = 0; j < chunk.nets.size(); j++) {
+            eptr_.push_back(offset + chunk.eptr[j + 1]);
+            
+            Net net_obj;
+            net_obj.id = static_cast<int>(nets_.size());
+            net_obj.weight = 1.0f;
+            net_to_id_[chunk.nets[j]] = net_obj.id;
+            nets_.push_back(net_obj);
+            sta_nets_.push_back(chunk.nets[j]);
         }
-        delete pin_iter;
     }
-    delete leaf_iter2;
     
-    logger.info("Extracted " + std::to_string(nets_.size()) + " nets");
+    logger.info("Extracted " + std::to_string(nets_.size()) + " nets with " +
+                std::to_string(num_threads) + " threads");
     logger.info("Skipped " + std::to_string(skipped_power) + " power nets, " +
                 std::to_string(skipped_single) + " single-vertex nets, " +
                 std::to_string(skipped_no_driver) + " no-driver nets");
     
+    names_cached_ = false;
     data_cached_ = true;
 }
 
+// Build the names of the instances and nets, and the instance lists of
+// the nets, which are only needed by getInstances and getNets
+void OpenStaAdapter::ensureNames() const {
+    if (names_cached_ || !sta_impl_) {
+        return;
+    }
+    
+    sta::Network* network = sta_impl_->network_;
+    const size_t num_ports = sta_ports_.size();
+    for (size_t i = 0; i < num_ports; i++) {
+        instances_[i].name = network->name(sta_ports_[i]);
+    }
+    for (size_t i = 0; i < sta_insts_.size(); i++) {
+        const sta::Instance* sta_inst = sta_insts_[i];
+        if (sta_inst == nullptr) {
+            continue;  // dummy data
+        }
+        Instance& inst = instances_[num_ports + i];
+        inst.name = network->pathName(sta_inst);
+        sta::Cell* cell = network->cell(sta_inst);
+        if (cell) {
+            inst.cell_type = network->name(cell);
+        }
+    }
+    for (size_t e = 0; e < nets_.size(); e++) {
+        if (sta_nets_[e] != nullptr) {
+            nets_[e].name = network->pathName(sta_nets_[e]);
+        }
+        nets_[e].instances.assign(eind_.begin() + eptr_[e], eind_.begin() + eptr_[e + 1]);
+    }
+    names_cached_ = true;
+}
+
 bool OpenStaAdapter::readSDC(const std::string& filename) {
     auto& logger = Logger::getInstance();
     
@@ -536,6 +631,7 @@ bool OpenStaAdapter::readSDC(const std::string& filename) {
         std::string result;
         if (sta_impl_->executeTcl(cmd, &result)) {
             logger.info("SDC file loaded successfully");
+            net_slacks_.clear();  // the constraints have changed
             return true;
         } else {
             logger.error("Failed to load SDC: " + result);
@@ -586,87 +682,165 @@ std::shared_ptr<Hypergraph> OpenStaAdapter::buildHypergraph() {
         return nullptr;
     }
     
-    // Prepare data structures for Hypergraph constructor
+    // Prepare the arrays of the hypergraph
     // 超图定义：
     //   - Vertices (顶点) = Instances (实例/单元)
     //   - Hyperedges (超边) = Nets (网络)，每个网络连接多个实例
-    int vertex_dimensions = 1;
-    int hyperedge_dimensions = 1;
-    int placement_dimensions = 0;
+    // One vertex dimension, one hyperedge dimension and no placement
+    HypergraphBuilder builder;
     
     // Build vertex weights from instances
     // 顶点权重 = 实例面积
-    std::vector<std::vector<float>> vertex_weights;
+    std::vector<float>& vertex_weights = builder.vertex_weights;
+    vertex_weights.reserve(instances_.size());
     for (const auto& inst : instances_) {
         float weight = inst.area > 0 ? inst.area : 1.0f;
-        vertex_weights.push_back({weight});
+        vertex_weights.push_back(weight);
     }
     
     // Build hyperedges from nets
-    // 超边 = 网络连接的实例列表
-    std::vector<std::vector<int>> hyperedges;
-    std::vector<std::vector<float>> hyperedge_weights;
-    
+    // 超边 = 网络连接的实例列表, already in CSR format (eind_, eptr_)
+    // Every extracted net connects at least 2 vertices
+    builder.eind = eind_;
+    builder.eptr = eptr_;
+    builder.hyperedge_weights.reserve(nets_.size());
     for (const auto& net : nets_) {
-        // 只保留连接 2 个以上实例的网络
-        if (net.instances.size() >= 2) {
-            hyperedges.push_back(net.instances);
-            hyperedge_weights.push_back({net.weight});
+        builder.hyperedge_weights.push_back(net.weight);
+    }
+    
+    logger.info("Building hypergraph with " + std::to_string(vertex_weights.size()) + 
+                " vertices (instances) and " + std::to_string(nets_.size()) + " hyperedges (nets)");
+    
+    // Create hypergraph from the CSR arrays (without timing information).
+    // Fixed vertices, community structure and placement: none for now
+    auto hg = builder.Build(&Logger::getInstance());
+    
+    logger.info("Hypergraph built: " + std::to_string(hg->GetNumVertices()) + 
+                " vertices, " + std::to_string(hg->GetNumHyperedges()) + " hyperedges");
+    
+    return hg;
+}
+
+std::shared_ptr<Hypergraph> OpenStaAdapter::buildTimingHypergraph(
+    const TimingPathStore& timing_paths, float extra_delay, bool guardband) {
+    auto& logger = Logger::getInstance();
+    
+    if (!data_cached_) {
+        logger.error("No netlist data available");
+        return nullptr;
+    }
+    
+    // The net slacks are needed for all the hyperedges. The timing paths
+    // are optional, i.e., without paths only the net-based timing cost is used.
+    ensureNetSlacks();
+    if (max_clock_period_ <= 0.0f) {
+        logger.warning("No clock is defined, building hypergraph without timing");
+        return buildHypergraph();
+    }
+    
+    logger.info("Building timing hypergraph from adapter...");
+    
+    // Same normalization as TritonPart::BuildTimingPaths:
+    // all the slacks are normalized to the maximum clock period
+    const float norm_extra_delay = extra_delay / max_clock_period_;
+    const float slack_offset = guardband ? norm_extra_delay : 0.0f;
+    
+    // The arrays are filled in place and moved into the hypergraph
+    // (one vertex dimension, one hyperedge dimension, no placement)
+    HypergraphBuilder builder;
+    
+    // Vertices: weights and types in one pass over the instances
+    std::vector<float>& vertex_weights = builder.vertex_weights;
+    std::vector<VertexType>& vertex_types = builder.vertex_types;
+    vertex_weights.reserve(instances_.size());
+    vertex_types.reserve(instances_.size());
+    for (const auto& inst : instances_) {
+        vertex_weights.push_back(inst.area > 0 ? inst.area : 1.0f);
+        if (inst.cell_type == "PORT") {
+            vertex_types.push_back(kPort);
+        } else if (inst.is_macro) {
+            vertex_types.push_back(kMacro);
+        } else if (inst.is_sequential) {
+            vertex_types.push_back(kSeqStdCell);
+        } else {
+            vertex_types.push_back(kCombStdCell);
         }
     }
     
-    // Fixed vertices (none for now)
-    std::vector<int> fixed_attr;
+    // Hyperedges in net order (the net id is the hyperedge id of the paths)
+    builder.eind = eind_;
+    builder.eptr = eptr_;
+    std::vector<float>& hyperedge_weights = builder.hyperedge_weights;
+    std::vector<float>& hyperedge_slacks = builder.hyperedges_slack;
+    hyperedge_weights.reserve(nets_.size());
+    hyperedge_slacks.reserve(nets_.size());
+    // each hyperedge is its own timing arc
+    builder.arc_ind.reserve(nets_.size());
+    builder.arc_ptr.reserve(nets_.size() + 1);
+    builder.arc_ptr.push_back(0);
+    int num_unconstrained_hyperedges = 0;
+    for (size_t e = 0; e < nets_.size(); e++) {
+        hyperedge_weights.push_back(nets_[e].weight);
+        builder.arc_ind.push_back(static_cast<int>(e));
+        builder.arc_ptr.push_back(static_cast<int>(e) + 1);
+        // set the slack of unconstrained net to 1.0 (one clock period)
+        const float slack = net_slacks_[e];
+        if (slack > max_clock_period_) {
+            num_unconstrained_hyperedges++;
+            hyperedge_slacks.push_back(1.0f);
+        } else {
+            hyperedge_slacks.push_back(slack / max_clock_period_ - slack_offset);
+        }
+    }
     
-    // Community structure (for coarsening)
-    std::vector<int> community_attr;
+    if (num_unconstrained_hyperedges > 0) {
+        logger.info("Timing graph has " + std::to_string(num_unconstrained_hyperedges) +
+                    " unconstrained hyperedges");
+    }
     
-    // Placement attributes (empty for now)
-    std::vector<std::vector<float>> placement_attr;
+    // Timing paths: already in CSR format, only the slacks are normalized
+    TimingPathStore& normalized_paths = builder.timing_paths;
+    normalized_paths.vind.reserve(timing_paths.vind.size());
+    normalized_paths.eind.reserve(timing_paths.eind.size());
+    for (int path_id = 0; path_id < timing_paths.size(); path_id++) {
+        if (timing_paths.PathEdges(path_id).empty()) {
+            continue;  // the path does not traverse any hyperedge
+        }
+        normalized_paths.AddPath(timing_paths.PathVertices(path_id),
+                                 timing_paths.PathEdges(path_id),
+                                 timing_paths.slacks[path_id] / max_clock_period_ - slack_offset);
+    }
     
-    logger.info("Building hypergraph with " + std::to_string(vertex_weights.size()) + 
-                " vertices (instances) and " + std::to_string(hyperedges.size()) + " hyperedges (nets)");
-    
-    // Create hypergraph with proper constructor
-    // 参数顺序: hyperedges, vertex_weights, hyperedge_weights
-    auto hg = std::make_shared<Hypergraph>(
-        vertex_dimensions,
-        hyperedge_dimensions,
-        placement_dimensions,
-        hyperedges,           // 超边（网络连接）
-        vertex_weights,       // 顶点权重（实例面积）
-        hyperedge_weights,    // 超边权重
-        fixed_attr,           // 固定顶点
-        community_attr,       // 社区属性
-        placement_attr,       // 布局属性
-        &Logger::getInstance()
-    );
+    const int num_nets = static_cast<int>(nets_.size());
+    auto hg = builder.Build(&logger);
     
-    logger.info("Hypergraph built: " + std::to_string(hg->GetNumVertices()) + 
-                " vertices, " + std::to_string(hg->GetNumHyperedges()) + " hyperedges");
+    logger.info("Timing hypergraph built: " + std::to_string(hg->GetNumVertices()) +
+                " vertices, " + std::to_string(num_nets) + " hyperedges, " +
+                std::to_string(hg->GetNumTimingPaths()) + " timing paths");
     
     return hg;
 }
 
 // Forward declarations for timing path extraction helpers
-std::vector<TimingPath> extractTimingPathsFromSTA(
+TimingPathStore extractTimingPathsFromSTA(
     sta::Sta* sta, 
-    const std::map<sta::Instance*, int>& inst_to_id,
-    const std::map<sta::Net*, int>& net_to_id,
+    const std::unordered_map<const sta::Instance*, int>& inst_to_id,
+    const std::unordered_map<const sta::Net*, int>& net_to_id,
+    int num_vertices,
+    int num_nets,
     int max_paths,
+    float& max_clock_period,
     Logger& logger);
 
-std::map<sta::Instance*, int> buildInstanceToIdMap(
-    sta::Network* network,
-    const std::vector<Instance>& instances);
-
-std::map<sta::Net*, int> buildNetToIdMap(
-    sta::Network* network,
-    const std::vector<Net>& nets);
+std::vector<float> extractNetSlacksFromSTA(
+    sta::Sta* sta,
+    const std::vector<const sta::Net*>& nets,
+    float& max_clock_period,
+    Logger& logger);
 
-std::vector<TimingPath> OpenStaAdapter::getCriticalPaths(int max_paths) const {
+TimingPathStore OpenStaAdapter::getCriticalPaths(int max_paths) const {
     auto& logger = Logger::getInstance();
-    std::vector<TimingPath> paths;
+    TimingPathStore paths;
     
     if (!sta_impl_ || !data_cached_) {
         logger.warning("OpenSTA not initialized or no data cached");
@@ -675,16 +849,16 @@ std::vector<TimingPath> OpenStaAdapter::getCriticalPaths(int max_paths) const {
     
     logger.info("Extracting critical timing paths (max " + std::to_string(max_paths) + ")...");
     
-    // Build mapping from STA objects to our IDs
-    auto inst_to_id = buildInstanceToIdMap(sta_impl_->network_, instances_);
-    auto net_to_id = buildNetToIdMap(sta_impl_->network_, nets_);
-    
     // Extract timing paths using the helper function
+    // The STA objects are mapped to our IDs by the maps built in extractNetlistData
     paths = extractTimingPathsFromSTA(
         sta_impl_->sta_,
-        inst_to_id,
-        net_to_id,
+        inst_to_id_,
+        net_to_id_,
+        static_cast<int>(instances_.size()),
+        static_cast<int>(nets_.size()),
         max_paths,
+        max_clock_period_,
         logger
     );
     
@@ -694,10 +868,12 @@ std::vector<TimingPath> OpenStaAdapter::getCriticalPaths(int max_paths) const {
 }
 
 std::vector<Instance> OpenStaAdapter::getInstances() const {
+    ensureNames();
     return instances_;
 }
 
 std::vector<Net> OpenStaAdapter::getNets() const {
+    ensureNames();
     return nets_;
 }
 
@@ -710,6 +886,16 @@ void OpenStaAdapter::clearCache() {
     instances_.clear();
     nets_.clear();
     pins_.clear();
+    sta_ports_.clear();
+    sta_insts_.clear();
+    sta_nets_.clear();
+    inst_to_id_.clear();
+    net_to_id_.clear();
+    eind_.clear();
+    eptr_.clear();
+    names_cached_ = false;
+    max_clock_period_ = 0.0f;
+    net_slacks_.clear();
 }
 
 int OpenStaAdapter::getNumInstances() const {
@@ -725,8 +911,24 @@ int OpenStaAdapter::getNumPins() const {
 }
 
 float OpenStaAdapter::getNetSlack(int net_id) const {
-    // TODO: Implement actual slack extraction from timing analysis
-    return 0.0f;
+    // The slacks of all the nets are extracted at once on the first call
+    ensureNetSlacks();
+    if (net_id < 0 || net_id >= static_cast<int>(net_slacks_.size())) {
+        return 0.0f;
+    }
+    return net_slacks_[net_id];
+}
+
+void OpenStaAdapter::ensureNetSlacks() const {
+    if (!sta_impl_ || !data_cached_ || net_slacks_.size() == nets_.size()) {
+        return;
+    }
+    net_slacks_ = extractNetSlacksFromSTA(
+        sta_impl_->sta_,
+        sta_nets_,
+        max_clock_period_,
+        Logger::getInstance()
+    );
 }
 
 void OpenStaAdapter::buildDataCache() const {
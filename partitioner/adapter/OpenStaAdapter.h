@@ -5,10 +5,12 @@
 
 #include "NetlistAdapter.h"
 #include <memory>
+#include <unordered_map>
 
 // Forward declarations
 namespace sta {
 class Sta;
+class Port;
 class Network;
 class Graph;
 class Instance;
@@ -35,15 +37,19 @@ public:
     bool readSDC(const std::string& filename) override;
     bool readLiberty(const std::string& filename) override;
     bool runTimingAnalysis() override;
+    void setNumThreads(int num_threads) override;
     
     std::vector<Instance> getInstances() const override;
     std::vector<Net> getNets() const override;
     std::vector<Pin> getPins() const override;
     
-    std::vector<TimingPath> getCriticalPaths(int max_paths = 100) const override;
+    TimingPathStore getCriticalPaths(int max_paths = 100) const override;
     float getNetSlack(int net_id) const override;
     
     std::shared_ptr<Hypergraph> buildHypergraph() override;
+    std::shared_ptr<Hypergraph> buildTimingHypergraph(
+        const TimingPathStore& timing_paths, float extra_delay, bool guardband) override;
+    float getClockPeriod() const override { return max_clock_period_; }
     
     int getNumInstances() const override;
     int getNumNets() const override;
@@ -57,12 +63,39 @@ private:
     void clearCache();
     void buildDataCache() const;
     void extractNetlistData();
+    void ensureNetSlacks() const;
+    void ensureNames() const;
     
     // Cache for converted data
+    // The names of instances_ and nets_ and the instance lists of nets_
+    // are built lazily by ensureNames
     mutable std::vector<Instance> instances_;
     mutable std::vector<Net> nets_;
     mutable std::vector<Pin> pins_;
     mutable bool data_cached_;
+    mutable bool names_cached_ = false;
+    
+    // STA objects of the vertices and nets: the ports come first
+    // (vertex id < sta_ports_.size()), followed by the leaf instances
+    std::vector<const sta::Port*> sta_ports_;
+    std::vector<const sta::Instance*> sta_insts_;
+    // The (highest) STA net of each net in nets_
+    std::vector<const sta::Net*> sta_nets_;
+    
+    // Dense ids of the STA objects, keyed by pointer
+    std::unordered_map<const sta::Instance*, int> inst_to_id_;
+    std::unordered_map<const sta::Net*, int> net_to_id_;  // highest connected net
+    
+    // Hyperedges in CSR format: the vertices of net e are
+    // eind_[eptr_[e]], ..., eind_[eptr_[e + 1] - 1] (driver first)
+    std::vector<int> eind_;
+    std::vector<int> eptr_;
+    
+    // Maximum clock period seen by getCriticalPaths or ensureNetSlacks
+    mutable float max_clock_period_ = 0.0f;
+    
+    // Worst slack of each net in nets_ (filled by ensureNetSlacks)
+    mutable std::vector<float> net_slacks_;
 };
 
 } // namespace par
@@ -17,23 +17,36 @@
 #include "sta/MinMax.hh"
 #include "sta/ExceptionPath.hh"
 #include "sta/Units.hh"
+#include "sta/Clock.hh"
+#include "sta/Sdc.hh"
+#include "sta/Graph.hh"
+#include "sta/Delay.hh"
+#include "sta/DispatchQueue.hh"
 
-#include <map>
-#include <set>
+#include <unordered_map>
 #include <algorithm>
+#include <vector>
 
 namespace par {
 
 // Helper function to extract timing paths with real OpenSTA
 // This implementation follows OpenROAD's BuildTimingPaths() method
-std::vector<TimingPath> extractTimingPathsFromSTA(
+// The path ends are found (and their slacks evaluated) sequentially, then the
+// paths are expanded and mapped to vertex/hyperedge ids by the OpenSTA dispatch
+// threads. Each thread dedups the vertices and nets of a path with arrays
+// stamped by the path index (no clearing between paths) and writes its paths
+// to its own CSR store. The stores are appended in the path end order.
+TimingPathStore extractTimingPathsFromSTA(
     sta::Sta* sta, 
-    const std::map<sta::Instance*, int>& inst_to_id,
-    const std::map<sta::Net*, int>& net_to_id,
+    const std::unordered_map<const sta::Instance*, int>& inst_to_id,
+    const std::unordered_map<const sta::Net*, int>& net_to_id,
+    int num_vertices,
+    int num_nets,
     int max_paths,
+    float& max_clock_period,
     Logger& logger) {
     
-    std::vector<TimingPath> timing_paths;
+    TimingPathStore timing_paths;
     
     if (!sta) {
         logger.warning("STA not initialized for timing path extraction");
@@ -92,15 +105,27 @@ std::vector<TimingPath> extractTimingPathsFromSTA(
         int non_critical_count = 0;
         float slack_threshold = -0.01f; // Consider paths with slack < -0.01 as critical
         
-        // Process each path endpoint
+        // Collect the paths and their slacks. PathEnd::slack may update
+        // the search state (e.g., crpr), so this part stays sequential.
+        std::vector<const sta::Path*> paths;
+        std::vector<float> slacks;
+        paths.reserve(path_ends.size());
+        slacks.reserve(path_ends.size());
         for (sta::PathEnd* path_end : path_ends) {
             if (!path_end) continue;
             
-            sta::Path* path = path_end->path();
+            const sta::Path* path = path_end->path();
             if (!path) continue;
             
             // Get slack value
             float slack = path_end->slack(sta);
+            
+            // The slacks are normalized to the maximum clock period
+            // when the timing hypergraph is built
+            const sta::Clock* target_clk = path_end->targetClk(sta);
+            if (target_clk) {
+                max_clock_period = std::max(max_clock_period, target_clk->period());
+            }
             bool is_critical = (slack < slack_threshold);
             
             if (is_critical) {
@@ -109,65 +134,91 @@ std::vector<TimingPath> extractTimingPathsFromSTA(
                 non_critical_count++;
             }
             
-            // Expand the path to get all pins/instances along it
-            sta::PathExpanded expanded(path, sta);
-            
-            // Build the vertex path (instances)
+            paths.push_back(path);
+            slacks.push_back(slack);
+        }
+        
+        sta::Network* network = sta->network();
+        
+        // Expand the paths in [begin, end) into store.
+        // vertex_stamp / net_stamp hold the index of the last path which
+        // visited the vertex / net.
+        auto expand_paths = [&](size_t begin, size_t end, TimingPathStore& store) {
+            std::vector<int> vertex_stamp(num_vertices, -1);
+            std::vector<int> net_stamp(num_nets, -1);
             std::vector<int> path_vertices;
-            std::set<int> unique_vertices; // To avoid duplicates
-            
-            // Build the arc path (nets)  
             std::vector<int> path_arcs;
-            std::set<int> unique_arcs; // To avoid duplicates
-            
-            // Traverse the expanded path
-            for (size_t i = 0; i < expanded.size(); i++) {
-                // PathExpanded provides direct access to the path at index
-                const sta::Path* path_at_i = expanded.path(i);
-                if (!path_at_i) continue;
-                
-                // Get the pin at this path point
-                const sta::Pin* pin = path_at_i->pin(sta);
-                if (!pin) continue;
+            for (size_t path_idx = begin; path_idx < end; path_idx++) {
+                const int stamp = static_cast<int>(path_idx);
+                path_vertices.clear();
+                path_arcs.clear();
                 
-                // Get the instance for this pin
-                sta::Network* network = sta->network();
-                sta::Instance* inst = network->instance(pin);
+                // Expand the path to get all pins/instances along it
+                sta::PathExpanded expanded(paths[path_idx], sta);
                 
-                // Map instance to vertex ID
-                if (inst) {
-                    auto it = inst_to_id.find(inst);
-                    if (it != inst_to_id.end()) {
-                        int vertex_id = it->second;
-                        if (unique_vertices.find(vertex_id) == unique_vertices.end()) {
-                            path_vertices.push_back(vertex_id);
-                            unique_vertices.insert(vertex_id);
+                // Traverse the expanded path
+                for (size_t i = 0; i < expanded.size(); i++) {
+                    // PathExpanded provides direct access to the path at index
+                    const sta::Path* path_at_i = expanded.path(i);
+                    if (!path_at_i) continue;
+                    
+                    // Get the pin at this path point
+                    const sta::Pin* pin = path_at_i->pin(sta);
+                    if (!pin) continue;
+                    
+                    // Map instance to vertex ID
+                    sta::Instance* inst = network->instance(pin);
+                    if (inst) {
+                        auto it = inst_to_id.find(inst);
+                        if (it != inst_to_id.end() && vertex_stamp[it->second] != stamp) {
+                            vertex_stamp[it->second] = stamp;
+                            path_vertices.push_back(it->second);
                         }
                     }
-                }
-                
-                // Get the net connected to this pin
-                sta::Net* net = network->net(pin);
-                if (net) {
-                    auto it = net_to_id.find(net);
-                    if (it != net_to_id.end()) {
-                        int arc_id = it->second;
-                        if (unique_arcs.find(arc_id) == unique_arcs.end()) {
-                            path_arcs.push_back(arc_id);
-                            unique_arcs.insert(arc_id);
+                    
+                    // Get the net connected to this pin
+                    // The nets are identified by their highest connected net
+                    sta::Net* net = network->net(pin);
+                    if (net) {
+                        auto it = net_to_id.find(network->highestConnectedNet(net));
+                        if (it != net_to_id.end() && net_stamp[it->second] != stamp) {
+                            net_stamp[it->second] = stamp;
+                            path_arcs.push_back(it->second);
                         }
                     }
                 }
+                
+                // Keep the path if it visits at least one vertex
+                if (!path_vertices.empty()) {
+                    store.AddPath(path_vertices, path_arcs, slacks[path_idx]);
+                }
             }
-            
-            // Create TimingPath object if we have valid path
-            if (!path_vertices.empty()) {
-                TimingPath timing_path(path_vertices, path_arcs, slack);
-                timing_paths.push_back(timing_path);
+        };
+        
+        const size_t num_threads = std::max(1u, sta->threadCount());
+        if (num_threads == 1 || paths.size() < num_threads) {
+            expand_paths(0, paths.size(), timing_paths);
+        } else {
+            const size_t chunk_size = (paths.size() + num_threads - 1) / num_threads;
+            const size_t num_chunks = (paths.size() + chunk_size - 1) / chunk_size;
+            std::vector<TimingPathStore> chunk_paths(num_chunks);
+            sta::DispatchQueue dispatch_queue(num_threads);
+            for (size_t chunk = 0; chunk < num_chunks; chunk++) {
+                const size_t begin = chunk * chunk_size;
+                const size_t end = std::min(begin + chunk_size, paths.size());
+                dispatch_queue.dispatch([&expand_paths, &chunk_paths, chunk, begin, end](int) {
+                    expand_paths(begin, end, chunk_paths[chunk]);
+                });
+            }
+            dispatch_queue.finishTasks();
+            // merge in order, so the paths stay sorted by slack
+            for (const auto& chunk_store : chunk_paths) {
+                timing_paths.Append(chunk_store);
             }
         }
         
-        logger.info("Extracted " + std::to_string(timing_paths.size()) + " timing paths");
+        logger.info("Extracted " + std::to_string(timing_paths.size()) + " timing paths with " +
+                    std::to_string(num_threads) + " threads");
         logger.info("  Critical paths: " + std::to_string(critical_count));
         logger.info("  Non-critical paths: " + std::to_string(non_critical_count));
         
@@ -181,92 +232,93 @@ std::vector<TimingPath> extractTimingPathsFromSTA(
     return timing_paths;
 }
 
-// Helper to build instance to ID mapping
-std::map<sta::Instance*, int> buildInstanceToIdMap(
-    sta::Network* network,
-    const std::vector<Instance>& instances) {
-    
-    std::map<sta::Instance*, int> inst_to_id;
-    
-    if (!network) return inst_to_id;
+// Helper function to extract the worst slack of all the nets at once
+// Instead of enumerating timing paths, this runs one arrival/required
+// propagation over the whole timing graph and then reads the slack of
+// the load pins of each net, which is what Sta::netSlack returns.
+// Sta::netSlack cannot be called concurrently because it updates the
+// requireds lazily, so the requireds are found once up front and the
+// (read-only) slack queries are split among the OpenSTA dispatch threads.
+std::vector<float> extractNetSlacksFromSTA(
+    sta::Sta* sta,
+    const std::vector<const sta::Net*>& nets,
+    float& max_clock_period,
+    Logger& logger) {
     
-    sta::Instance* top_inst = network->topInstance();
-    if (!top_inst) return inst_to_id;
+    std::vector<float> net_slacks(nets.size(), sta::INF);
     
-    // Map instance names to IDs
-    std::map<std::string, int> name_to_id;
-    for (size_t i = 0; i < instances.size(); i++) {
-        name_to_id[instances[i].name] = i;
+    if (!sta) {
+        logger.warning("STA not initialized for net slack extraction");
+        return net_slacks;
     }
     
-    // Iterate through all leaf instances and map them
-    sta::LeafInstanceIterator* iter = network->leafInstanceIterator();
-    while (iter->hasNext()) {
-        sta::Instance* inst = iter->next();
-        std::string inst_name = network->pathName(inst);
+    try {
+        sta->ensureGraph();
+        // one arrival/required propagation for the whole design
+        sta->findRequireds();
         
-        auto it = name_to_id.find(inst_name);
-        if (it != name_to_id.end()) {
-            inst_to_id[inst] = it->second;
+        // the slacks are normalized to the maximum clock period
+        for (const sta::Clock* clk : *sta->sdc()->clocks()) {
+            max_clock_period = std::max(max_clock_period, clk->period());
         }
-    }
-    delete iter;
-    
-    return inst_to_id;
-}
-
-// Helper to build net to ID mapping  
-// Uses highestConnectedNet to match the net extraction logic
-std::map<sta::Net*, int> buildNetToIdMap(
-    sta::Network* network,
-    const std::vector<Net>& nets) {
-    
-    std::map<sta::Net*, int> net_to_id;
-    
-    if (!network) return net_to_id;
-    
-    sta::Instance* top_inst = network->topInstance();
-    if (!top_inst) return net_to_id;
-    
-    // Map net names to IDs
-    std::map<std::string, int> name_to_id;
-    for (size_t i = 0; i < nets.size(); i++) {
-        name_to_id[nets[i].name] = i;
-    }
-    
-    // Function to recursively process nets
-    // We need to map both the original net and its highestConnectedNet
-    std::function<void(sta::Instance*)> processNets = [&](sta::Instance* inst) {
-        sta::NetIterator* iter = network->netIterator(inst);
-        while (iter->hasNext()) {
-            sta::Net* net = iter->next();
-            
-            // Get the highest connected net (same as in extractNetlistData)
-            const sta::Net* highest_net = network->highestConnectedNet(net);
-            std::string net_name = network->pathName(highest_net);
-            
-            auto it = name_to_id.find(net_name);
-            if (it != name_to_id.end()) {
-                // Map both the original net and the highest net to the same ID
-                net_to_id[net] = it->second;
-                net_to_id[const_cast<sta::Net*>(highest_net)] = it->second;
+        
+        sta::Network* network = sta->network();
+        sta::Graph* graph = sta->graph();
+        const sta::MinMax* max = sta::MinMax::max();
+        
+        // worst slack of the load pins of the nets in [begin, end)
+        auto find_net_slacks = [&](size_t begin, size_t end) {
+            for (size_t net_id = begin; net_id < end; net_id++) {
+                if (nets[net_id] == nullptr) {
+                    continue;
+                }
+                float slack = sta::INF;
+                sta::NetConnectedPinIterator* pin_iter = network->connectedPinIterator(nets[net_id]);
+                while (pin_iter->hasNext()) {
+                    const sta::Pin* pin = pin_iter->next();
+                    if (!network->isLoad(pin)) {
+                        continue;
+                    }
+                    sta::Vertex* vertex = graph->pinLoadVertex(pin);
+                    if (!vertex) {
+                        continue;
+                    }
+                    sta::VertexPathIterator path_iter(vertex, sta);
+                    while (path_iter.hasNext()) {
+                        sta::Path* path = path_iter.next();
+                        if (path->minMax(sta) == max) {
+                            slack = std::min(slack, sta::delayAsFloat(path->slack(sta)));
+                        }
+                    }
+                }
+                delete pin_iter;
+                net_slacks[net_id] = slack;
             }
-        }
-        delete iter;
+        };
         
-        // Process child instances
-        sta::InstanceChildIterator* child_iter = network->childIterator(inst);
-        while (child_iter->hasNext()) {
-            sta::Instance* child = child_iter->next();
-            processNets(child);
+        const size_t num_threads = std::max(1u, sta->threadCount());
+        if (num_threads == 1 || nets.size() < num_threads) {
+            find_net_slacks(0, nets.size());
+        } else {
+            sta::DispatchQueue dispatch_queue(num_threads);
+            const size_t chunk_size = (nets.size() + num_threads - 1) / num_threads;
+            for (size_t begin = 0; begin < nets.size(); begin += chunk_size) {
+                const size_t end = std::min(begin + chunk_size, nets.size());
+                dispatch_queue.dispatch([&find_net_slacks, begin, end](int) {
+                    find_net_slacks(begin, end);
+                });
+            }
+            dispatch_queue.finishTasks();
         }
-        delete child_iter;
-    };
-    
-    // Start from top instance
-    processNets(top_inst);
+        
+        logger.info("Extracted the slack of " + std::to_string(nets.size()) + " nets with " +
+                    std::to_string(num_threads) + " threads");
+        
+    } catch (const std::exception& e) {
+        logger.error("Exception during net slack extraction: " + std::string(e.what()));
+    }
     
-    return net_to_id;
+    return net_slacks;
 }
 
 } // namespace par
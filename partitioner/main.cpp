@@ -9,12 +9,18 @@
 #include <string>
 #include <vector>
 #include <chrono>
+#include <climits>
+#include <cstdlib>
 #include <cstring>
+#include <filesystem>
 
 #include "TritonPartCore.h"
 #include "adapter/OpenStaAdapter.h"
+#include "adapter/CachedAdapter.h"
 #include "src/Hypergraph.h"
+#include "src/HypergraphFile.h"
 #include "src/Evaluator.h"
+#include "src/ThreadPool.h"
 #include "utils/Logger.h"
 
 using namespace par;
@@ -22,6 +28,8 @@ using namespace par;
 enum class Mode {
     PARTITION,   // triton_part_design
     EVALUATE,    // evaluate_part_design_solution
+    CONVERT,     // convert between hMETIS and binary (.hgrb) hypergraph files
+    PARTITION_HYPERGRAPH,  // triton_part_hypergraph
     HELP
 };
 
@@ -42,6 +50,20 @@ struct Options {
     bool timing_aware = false;
     float extra_delay = 1e-9;
     bool guardband = false;
+    bool net_timing_only = false;  // use net slacks without timing paths
+    int num_threads = 0;  // 0 means using all the hardware threads
+    bool parallel_coarsen = false;
+    std::string cache_dir;  // front-end cache directory (empty: no cache)
+    
+    // Hypergraph files (convert and partition_hypergraph modes)
+    std::string input_file;
+    std::string output_file;
+    std::string fixed_file;
+    std::string community_file;
+    std::string group_file;
+    std::string placement_file;
+    int vertex_dimensions = 1;
+    int hyperedge_dimensions = 1;
     
     // Output files
     std::string solution_file = "partition.part";
@@ -58,6 +80,8 @@ void printUsage(const char* prog_name) {
     std::cout << "Commands:" << std::endl;
     std::cout << "  partition    Run triton_part_design (default)" << std::endl;
     std::cout << "  evaluate     Run evaluate_part_design_solution" << std::endl;
+    std::cout << "  convert      Convert a hypergraph between hMETIS and binary (.hgrb) format" << std::endl;
+    std::cout << "  partition_hypergraph  Run triton_part_hypergraph on a hypergraph file" << std::endl;
     std::cout << std::endl;
     std::cout << "Common Options:" << std::endl;
     std::cout << "  -v <verilog>      Verilog netlist file (required)" << std::endl;
@@ -71,6 +95,10 @@ void printUsage(const char* prog_name) {
     std::cout << "  --top_n <n>       Top N timing paths (default: 100000)" << std::endl;
     std::cout << "  --extra_delay <d> Extra delay for cuts (default: 1e-9)" << std::endl;
     std::cout << "  --guardband       Enable timing guardband" << std::endl;
+    std::cout << "  --net_timing      Use net slacks only, without extracting timing paths" << std::endl;
+    std::cout << "  --threads <n>     Number of timing analysis and partitioning threads (default: all cores)" << std::endl;
+    std::cout << "  --parallel_coarsen Use parallel first-choice matching during coarsening" << std::endl;
+    std::cout << "  --cache_dir <dir> Cache the hypergraph and timing data of the inputs in <dir>" << std::endl;
     std::cout << "  -d                Enable debug logging" << std::endl;
     std::cout << "  -h, --help        Print this help" << std::endl;
     std::cout << std::endl;
@@ -82,6 +110,21 @@ void printUsage(const char* prog_name) {
     std::cout << "  --hypergraph <file>   Output hypergraph file (weighted)" << std::endl;
     std::cout << "  --hypergraph_int <f>  Output hypergraph file (integer weights, hMETIS format)" << std::endl;
     std::cout << std::endl;
+    std::cout << "Convert Mode Options:" << std::endl;
+    std::cout << "  -i <input>        Input hypergraph file (.hgrb: binary, otherwise hMETIS)" << std::endl;
+    std::cout << "  -o <output>       Output hypergraph file (.hgrb: binary, otherwise hMETIS)" << std::endl;
+    std::cout << std::endl;
+    std::cout << "Partition Hypergraph Mode Options:" << std::endl;
+    std::cout << "  -i <input>        Input hypergraph file (.hgrb: binary, otherwise hMETIS, optionally .gz)" << std::endl;
+    std::cout << "  -o <output>       Solution output file (default: partition.part)" << std::endl;
+    std::cout << "  --fixed <file>    Fixed vertices file (-1: not fixed)" << std::endl;
+    std::cout << "  --community <f>   Community file" << std::endl;
+    std::cout << "  --group <file>    Group file (vertices which stay together)" << std::endl;
+    std::cout << "  --placement <f>   Placement file" << std::endl;
+    std::cout << "  --vertex_dims <n> Number of vertex weight dimensions (default: 1)" << std::endl;
+    std::cout << "  --hyperedge_dims <n> Number of hyperedge weight dimensions (default: 1)" << std::endl;
+    std::cout << "  The -n, -b, --seed, -t, --threads and --parallel_coarsen options also apply" << std::endl;
+    std::cout << std::endl;
     std::cout << "Examples:" << std::endl;
     std::cout << "  # Partition a design" << std::endl;
     std::cout << "  " << prog_name << " partition -v design.v -m top -l lib.lib -s design.sdc -n 4 -t -o result.part" << std::endl;
@@ -89,6 +132,22 @@ void printUsage(const char* prog_name) {
     std::cout << "  # Evaluate a partition solution and generate hypergraph" << std::endl;
     std::cout << "  " << prog_name << " evaluate -v design.v -m top -l lib.lib -s design.sdc -n 4 -t \\" << std::endl;
     std::cout << "      --solution result.part --hypergraph design.hgr.wt --hypergraph_int design.hgr.int" << std::endl;
+    std::cout << std::endl;
+    std::cout << "  # Convert an hMETIS hypergraph to the binary format" << std::endl;
+    std::cout << "  " << prog_name << " convert -i design.hgr -o design.hgrb" << std::endl;
+    std::cout << std::endl;
+    std::cout << "  # Partition an hMETIS hypergraph" << std::endl;
+    std::cout << "  " << prog_name << " partition_hypergraph -i design.hgr.gz -n 4 -b 2.0 -o design.part" << std::endl;
+}
+
+// Parse a weight dimension, 0 if the text is not a positive integer
+int parseDimension(const char* text) {
+    char* end = nullptr;
+    const long value = std::strtol(text, &end, 10);
+    if (end == text || *end != '\0' || value < 1 || value > INT_MAX) {
+        return 0;
+    }
+    return static_cast<int>(value);
 }
 
 Options parseArgs(int argc, char* argv[]) {
@@ -105,6 +164,10 @@ Options parseArgs(int argc, char* argv[]) {
         opts.mode = Mode::PARTITION;
     } else if (cmd == "evaluate") {
         opts.mode = Mode::EVALUATE;
+    } else if (cmd == "convert") {
+        opts.mode = Mode::CONVERT;
+    } else if (cmd == "partition_hypergraph") {
+        opts.mode = Mode::PARTITION_HYPERGRAPH;
     } else if (cmd == "-h" || cmd == "--help" || cmd == "help") {
         opts.mode = Mode::HELP;
         return opts;
@@ -146,8 +209,31 @@ Options parseArgs(int argc, char* argv[]) {
             opts.extra_delay = std::atof(argv[++i]);
         } else if (arg == "--guardband") {
             opts.guardband = true;
+        } else if (arg == "--net_timing") {
+            opts.net_timing_only = true;
+        } else if (arg == "--threads" && i + 1 < argc) {
+            opts.num_threads = std::atoi(argv[++i]);
+        } else if (arg == "--parallel_coarsen") {
+            opts.parallel_coarsen = true;
+        } else if (arg == "--cache_dir" && i + 1 < argc) {
+            opts.cache_dir = argv[++i];
+        } else if (arg == "-i" && i + 1 < argc) {
+            opts.input_file = argv[++i];
+        } else if (arg == "--fixed" && i + 1 < argc) {
+            opts.fixed_file = argv[++i];
+        } else if (arg == "--community" && i + 1 < argc) {
+            opts.community_file = argv[++i];
+        } else if (arg == "--group" && i + 1 < argc) {
+            opts.group_file = argv[++i];
+        } else if (arg == "--placement" && i + 1 < argc) {
+            opts.placement_file = argv[++i];
+        } else if (arg == "--vertex_dims" && i + 1 < argc) {
+            opts.vertex_dimensions = parseDimension(argv[++i]);
+        } else if (arg == "--hyperedge_dims" && i + 1 < argc) {
+            opts.hyperedge_dimensions = parseDimension(argv[++i]);
         } else if (arg == "-o" && i + 1 < argc) {
             opts.solution_file = argv[++i];
+            opts.output_file = opts.solution_file;
         } else if (arg == "--solution" && i + 1 < argc) {
             opts.solution_file = argv[++i];
         } else if (arg == "--hypergraph" && i + 1 < argc) {
@@ -167,6 +253,50 @@ Options parseArgs(int argc, char* argv[]) {
     return opts;
 }
 
+// Front-end cache file of the run, empty if the cache is disabled.
+// The key covers the contents of the input files, the top module and the
+// options which change the hypergraph built from them.
+std::string getFrontEndCacheFile(const Options& opts) {
+    if (opts.cache_dir.empty()) {
+        return "";
+    }
+    
+    auto& logger = Logger::getInstance();
+    std::vector<std::string> input_files = opts.liberty_files;
+    input_files.push_back(opts.verilog_file);
+    if (!opts.sdc_file.empty()) {
+        input_files.push_back(opts.sdc_file);
+    }
+    
+    std::ostringstream options;
+    options << (opts.mode == Mode::EVALUATE ? "evaluate" : "partition")
+            << " liberty=" << opts.liberty_files.size()
+            << " sdc=" << !opts.sdc_file.empty()
+            << " timing=" << opts.timing_aware;
+    if (opts.timing_aware) {
+        options << " top_n=" << opts.top_n
+                << " net_timing=" << opts.net_timing_only
+                << " guardband=" << opts.guardband;
+        if (opts.guardband) {
+            options << " extra_delay=" << std::hexfloat << opts.extra_delay;
+        }
+    }
+    
+    const std::string key = computeFrontEndCacheKey(input_files, opts.top_module, options.str());
+    if (key.empty()) {
+        logger.warning("Cannot read the input files, front-end cache disabled");
+        return "";
+    }
+    
+    std::error_code ec;
+    std::filesystem::create_directories(opts.cache_dir, ec);
+    if (ec) {
+        logger.warning("Cannot create cache directory " + opts.cache_dir + ", front-end cache disabled");
+        return "";
+    }
+    return (std::filesystem::path(opts.cache_dir) / (key + ".tpfe")).string();
+}
+
 int runPartition(const Options& opts) {
     auto& logger = Logger::getInstance();
     
@@ -178,45 +308,78 @@ int runPartition(const Options& opts) {
     
     try {
         // Create adapter and core
-        auto adapter = std::make_shared<OpenStaAdapter>();
+        // On a front-end cache hit, the cached result replaces the OpenSTA flow
+        const std::string cache_file = getFrontEndCacheFile(opts);
+        std::shared_ptr<CachedAdapter> cached_adapter;
+        if (!cache_file.empty()) {
+            cached_adapter = CachedAdapter::load(cache_file);
+        }
+        std::shared_ptr<NetlistAdapter> adapter = cached_adapter;
+        if (!cached_adapter) {
+            adapter = std::make_shared<OpenStaAdapter>();
+        }
         TritonPartCore core;
         core.setAdapter(adapter);
         
         // Configure parameters
         core.setNumPartitions(opts.num_parts);
         core.setBalance(opts.balance_constraint);
+        core.setSeed(opts.seed);
         core.setTimingAware(opts.timing_aware);
+        core.setTopN(opts.top_n);
+        core.setExtraDelay(opts.extra_delay);
+        core.setGuardband(opts.guardband);
+        core.setNetTimingOnly(opts.net_timing_only);
+        core.setNumThreads(opts.num_threads);
+        core.setParallelCoarsening(opts.parallel_coarsen);
         
         logger.info("Configuration:");
         logger.info("  Partitions: " + std::to_string(opts.num_parts));
         logger.info("  Balance constraint: " + std::to_string(opts.balance_constraint));
         logger.info("  Timing-aware: " + std::string(opts.timing_aware ? "yes" : "no"));
+        logger.info("  Threads: " + (opts.num_threads > 0 ? std::to_string(opts.num_threads) : std::string("all")));
+        logger.info("  Coarsening: " + std::string(opts.parallel_coarsen ? "parallel first-choice" : "lazy first-choice"));
         if (opts.timing_aware) {
             logger.info("  Top N paths: " + std::to_string(opts.top_n));
             logger.info("  Extra delay: " + std::to_string(opts.extra_delay));
             logger.info("  Guardband: " + std::string(opts.guardband ? "yes" : "no"));
+            logger.info("  Timing paths: " + std::string(opts.net_timing_only ? "no (net slacks only)" : "yes"));
         }
         
         // Read input files
-        for (const auto& lib_file : opts.liberty_files) {
-            logger.info("Reading Liberty: " + lib_file);
-            if (!core.readLiberty(lib_file)) {
-                logger.error("Failed to read Liberty file: " + lib_file);
+        if (cached_adapter) {
+            logger.info("Using cached front-end result: " + cache_file);
+        } else {
+            for (const auto& lib_file : opts.liberty_files) {
+                logger.info("Reading Liberty: " + lib_file);
+                if (!core.readLiberty(lib_file)) {
+                    logger.error("Failed to read Liberty file: " + lib_file);
+                    return 1;
+                }
+            }
+            
+            logger.info("Reading Verilog: " + opts.verilog_file);
+            if (!core.readNetlist(opts.verilog_file, opts.top_module)) {
+                logger.error("Failed to read Verilog file");
                 return 1;
             }
+            
+            if (!opts.sdc_file.empty()) {
+                logger.info("Reading SDC: " + opts.sdc_file);
+                if (!core.readSDC(opts.sdc_file)) {
+                    logger.error("Failed to read SDC file");
+                    return 1;
+                }
+            }
         }
         
-        logger.info("Reading Verilog: " + opts.verilog_file);
-        if (!core.readNetlist(opts.verilog_file, opts.top_module)) {
-            logger.error("Failed to read Verilog file");
-            return 1;
-        }
-        
-        if (!opts.sdc_file.empty()) {
-            logger.info("Reading SDC: " + opts.sdc_file);
-            if (!core.readSDC(opts.sdc_file)) {
-                logger.error("Failed to read SDC file");
-                return 1;
+        // Extract timing paths
+        // The paths are extracted first so that the hypergraph is built
+        // with the timing information in one pass
+        if (opts.timing_aware) {
+            logger.info("Extracting timing paths...");
+            if (!core.extractTimingPaths()) {
+                logger.warning("Failed to extract timing paths");
             }
         }
         
@@ -227,12 +390,8 @@ int runPartition(const Options& opts) {
             return 1;
         }
         
-        // Extract timing paths
-        if (opts.timing_aware) {
-            logger.info("Extracting timing paths...");
-            if (!core.extractTimingPaths()) {
-                logger.warning("Failed to extract timing paths");
-            }
+        if (!cached_adapter && !cache_file.empty()) {
+            CachedAdapter::write(cache_file, *adapter, *core.getHypergraph(), core.getTimingPaths());
         }
         
         // Perform partitioning
@@ -279,7 +438,17 @@ int runEvaluate(const Options& opts) {
     
     try {
         // Create adapter
-        auto adapter = std::make_shared<OpenStaAdapter>();
+        // On a front-end cache hit, the cached result replaces the OpenSTA flow
+        const std::string cache_file = getFrontEndCacheFile(opts);
+        std::shared_ptr<CachedAdapter> cached_adapter;
+        if (!cache_file.empty()) {
+            cached_adapter = CachedAdapter::load(cache_file);
+        }
+        std::shared_ptr<NetlistAdapter> adapter = cached_adapter;
+        if (!cached_adapter) {
+            adapter = std::make_shared<OpenStaAdapter>();
+        }
+        adapter->setNumThreads(opts.num_threads);
         
         // Configure and read input
         logger.info("Configuration:");
@@ -289,42 +458,59 @@ int runEvaluate(const Options& opts) {
         logger.info("  Solution file: " + opts.solution_file);
         
         // Read input files
-        for (const auto& lib_file : opts.liberty_files) {
-            logger.info("Reading Liberty: " + lib_file);
-            if (!adapter->readLiberty(lib_file)) {
-                logger.error("Failed to read Liberty file: " + lib_file);
-                return 1;
+        if (cached_adapter) {
+            logger.info("Using cached front-end result: " + cache_file);
+        } else {
+            for (const auto& lib_file : opts.liberty_files) {
+                logger.info("Reading Liberty: " + lib_file);
+                if (!adapter->readLiberty(lib_file)) {
+                    logger.error("Failed to read Liberty file: " + lib_file);
+                    return 1;
+                }
             }
-        }
-        
-        logger.info("Reading Verilog: " + opts.verilog_file);
-        if (!adapter->readNetlist(opts.verilog_file, opts.top_module)) {
-            logger.error("Failed to read Verilog file");
-            return 1;
-        }
-        
-        if (!opts.sdc_file.empty()) {
-            logger.info("Reading SDC: " + opts.sdc_file);
-            if (!adapter->readSDC(opts.sdc_file)) {
-                logger.error("Failed to read SDC file");
+            
+            logger.info("Reading Verilog: " + opts.verilog_file);
+            if (!adapter->readNetlist(opts.verilog_file, opts.top_module)) {
+                logger.error("Failed to read Verilog file");
                 return 1;
             }
+            
+            if (!opts.sdc_file.empty()) {
+                logger.info("Reading SDC: " + opts.sdc_file);
+                if (!adapter->readSDC(opts.sdc_file)) {
+                    logger.error("Failed to read SDC file");
+                    return 1;
+                }
+            }
+            
+            // Run timing analysis if timing-aware
+            if (opts.timing_aware) {
+                logger.info("Running timing analysis...");
+                adapter->runTimingAnalysis();
+            }
         }
         
-        // Run timing analysis if timing-aware
+        // Build hypergraph (with the critical timing paths if timing-aware)
+        logger.info("Building hypergraph...");
+        std::shared_ptr<Hypergraph> hypergraph;
+        TimingPathStore timing_paths;
         if (opts.timing_aware) {
-            logger.info("Running timing analysis...");
-            adapter->runTimingAnalysis();
+            if (!opts.net_timing_only) {
+                timing_paths = adapter->getCriticalPaths(opts.top_n);
+            }
+            hypergraph = adapter->buildTimingHypergraph(timing_paths, opts.extra_delay, opts.guardband);
+        } else {
+            hypergraph = adapter->buildHypergraph();
         }
-        
-        // Build hypergraph
-        logger.info("Building hypergraph...");
-        auto hypergraph = adapter->buildHypergraph();
         if (!hypergraph) {
             logger.error("Failed to build hypergraph");
             return 1;
         }
         
+        if (!cached_adapter && !cache_file.empty()) {
+            CachedAdapter::write(cache_file, *adapter, *hypergraph, timing_paths);
+        }
+        
         logger.info("Hypergraph: " + std::to_string(hypergraph->GetNumVertices()) + 
                    " vertices, " + std::to_string(hypergraph->GetNumHyperedges()) + " hyperedges");
         
@@ -336,6 +522,9 @@ int runEvaluate(const Options& opts) {
         float path_timing_factor = opts.timing_aware ? 1.0f : 0.0f;
         float path_snaking_factor = opts.timing_aware ? 1.0f : 0.0f;
         float timing_exp_factor = 2.0f;
+        // The slacks of the timing graph are normalized to the clock period
+        const float clock_period = adapter->getClockPeriod();
+        const float extra_delay = clock_period > 0.0f ? opts.extra_delay / clock_period : 0.0f;
         
         auto evaluator = std::make_shared<GoldenEvaluator>(
             opts.num_parts,
@@ -346,10 +535,12 @@ int runEvaluate(const Options& opts) {
             path_timing_factor,
             path_snaking_factor,
             timing_exp_factor,
-            opts.extra_delay,
+            extra_delay,
             hypergraph,  // timing graph
             &logger
         );
+        evaluator->SetThreadPool(std::make_shared<ThreadPool>(
+            opts.num_threads > 0 ? opts.num_threads : ThreadPool::DefaultNumThreads()));
         
         // Initialize timing if enabled
         if (opts.timing_aware) {
@@ -403,8 +594,13 @@ int runEvaluate(const Options& opts) {
             logger.info("Solution loaded: " + std::to_string(solution.size()) + " vertices");
             
             if (static_cast<int>(solution.size()) != hypergraph->GetNumVertices()) {
-                logger.warning("Solution size (" + std::to_string(solution.size()) + 
+                logger.error("Solution size (" + std::to_string(solution.size()) + 
                              ") != hypergraph vertices (" + std::to_string(hypergraph->GetNumVertices()) + ")");
+                return 1;
+            }
+            if (!evaluator->IsValidSolution(hypergraph, solution)) {
+                logger.error("Solution has block ids outside 0.." + std::to_string(opts.num_parts - 1));
+                return 1;
             }
             
             // Evaluate partition
@@ -442,6 +638,141 @@ int runEvaluate(const Options& opts) {
     return 0;
 }
 
+int runConvert(const Options& opts) {
+    auto& logger = Logger::getInstance();
+    
+    auto start_time = std::chrono::high_resolution_clock::now();
+    
+    logger.info("Reading hypergraph: " + opts.input_file);
+    HGraphPtr hypergraph = IsBinaryHypergraphFile(opts.input_file)
+                               ? ReadBinaryHypergraph(opts.input_file, &logger)
+                               : ReadHMetisHypergraph(opts.input_file, "", "", "",
+                                                      opts.vertex_dimensions, opts.hyperedge_dimensions,
+                                                      opts.num_threads > 0 ? opts.num_threads : ThreadPool::DefaultNumThreads(),
+                                                      &logger);
+    if (!hypergraph) {
+        logger.error("Failed to read hypergraph file");
+        return 1;
+    }
+    logger.info("Hypergraph: " + std::to_string(hypergraph->GetNumVertices()) +
+                " vertices, " + std::to_string(hypergraph->GetNumHyperedges()) + " hyperedges");
+    
+    logger.info("Writing hypergraph: " + opts.output_file);
+    const bool written = IsBinaryHypergraphFile(opts.output_file)
+                             ? WriteBinaryHypergraph(*hypergraph, opts.output_file, &logger)
+                             : WriteHMetisHypergraph(*hypergraph, opts.output_file, &logger);
+    if (!written) {
+        logger.error("Failed to write hypergraph file");
+        return 1;
+    }
+    
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+    logger.info("Conversion completed in " + std::to_string(duration.count()) + " ms");
+    return 0;
+}
+
+int runPartitionHypergraph(const Options& opts) {
+    auto& logger = Logger::getInstance();
+    
+    logger.info("========================================");
+    logger.info("TritonPart Hypergraph Partitioning");
+    logger.info("========================================");
+    
+    auto start_time = std::chrono::high_resolution_clock::now();
+    
+    try {
+        const int num_threads = opts.num_threads > 0 ? opts.num_threads : ThreadPool::DefaultNumThreads();
+        
+        logger.info("Reading hypergraph: " + opts.input_file);
+        HGraphPtr hypergraph;
+        if (IsBinaryHypergraphFile(opts.input_file)) {
+            hypergraph = ReadBinaryHypergraph(opts.input_file, &logger);
+        } else {
+            hypergraph = ReadHMetisHypergraph(opts.input_file, opts.fixed_file, opts.community_file,
+                                              opts.placement_file, opts.vertex_dimensions,
+                                              opts.hyperedge_dimensions, num_threads, &logger);
+        }
+        if (!hypergraph) {
+            logger.error("Failed to read hypergraph file");
+            return 1;
+        }
+        std::vector<std::vector<int>> groups;
+        if (!opts.group_file.empty()
+            && !ReadGroupFile(opts.group_file, hypergraph->GetNumVertices(), groups, &logger)) {
+            logger.error("Failed to read group file");
+            return 1;
+        }
+        
+        auto read_time = std::chrono::high_resolution_clock::now();
+        auto read_duration = std::chrono::duration_cast<std::chrono::milliseconds>(read_time - start_time);
+        logger.info("Hypergraph: " + std::to_string(hypergraph->GetNumVertices()) +
+                    " vertices, " + std::to_string(hypergraph->GetNumHyperedges()) +
+                    " hyperedges (read in " + std::to_string(read_duration.count()) + " ms)");
+        
+        // The fixed vertices must be in one of the blocks (-1: not fixed)
+        const int invalid_fixed = hypergraph->FindInvalidFixedVertex(opts.num_parts);
+        if (invalid_fixed != -1) {
+            logger.error("Invalid fixed block " + std::to_string(hypergraph->GetFixedAttr(invalid_fixed)) +
+                         " of vertex " + std::to_string(invalid_fixed + 1) + " (expected -1 to " +
+                         std::to_string(opts.num_parts - 1) + ")");
+            return 1;
+        }
+        
+        // Only a .hgrb file can carry the timing information
+        const bool timing_aware = opts.timing_aware && hypergraph->HasTiming();
+        if (opts.timing_aware && !timing_aware) {
+            logger.warning("The hypergraph has no timing information, timing-aware partitioning disabled");
+        }
+        
+        TritonPartCore core;
+        core.setNumPartitions(opts.num_parts);
+        core.setBalance(opts.balance_constraint);
+        core.setSeed(opts.seed);
+        core.setTimingAware(timing_aware);
+        core.setNumThreads(opts.num_threads);
+        core.setParallelCoarsening(opts.parallel_coarsen);
+        core.setHypergraph(hypergraph);
+        core.setGroups(groups);
+        
+        logger.info("Configuration:");
+        logger.info("  Partitions: " + std::to_string(opts.num_parts));
+        logger.info("  Balance constraint: " + std::to_string(opts.balance_constraint));
+        logger.info("  Seed: " + std::to_string(opts.seed));
+        logger.info("  Timing-aware: " + std::string(timing_aware ? "yes" : "no"));
+        logger.info("  Threads: " + std::to_string(num_threads));
+        logger.info("  Groups: " + std::to_string(groups.size()));
+        
+        logger.info("Starting partitioning...");
+        if (!core.partition()) {
+            logger.error("Partitioning failed");
+            return 1;
+        }
+        
+        core.reportPartitionMetrics();
+        
+        if (!core.writePartitionResult(opts.solution_file)) {
+            logger.error("Failed to write output file");
+            return 1;
+        }
+        
+        auto end_time = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+        
+        logger.info("========================================");
+        logger.info("Partitioning completed successfully!");
+        logger.info("Total runtime: " + std::to_string(duration.count()) + " ms");
+        logger.info("Output written to: " + opts.solution_file);
+        logger.info("========================================");
+        
+    } catch (const std::exception& e) {
+        logger.error("Exception: " + std::string(e.what()));
+        return 1;
+    }
+    
+    return 0;
+}
+
 int main(int argc, char* argv[]) {
     Options opts = parseArgs(argc, argv);
     
@@ -460,6 +791,31 @@ int main(int argc, char* argv[]) {
     auto& logger = Logger::getInstance();
     logger.setLevel(opts.debug ? LogLevel::DEBUG : LogLevel::INFO);
     
+    if (opts.vertex_dimensions < 1 || opts.hyperedge_dimensions < 1) {
+        logger.error("--vertex_dims and --hyperedge_dims must be positive integers");
+        return 1;
+    }
+    
+    // The convert mode works on hypergraph files only
+    if (opts.mode == Mode::CONVERT) {
+        if (opts.input_file.empty() || opts.output_file.empty()) {
+            logger.error("Input (-i) and output (-o) hypergraph files are required");
+            printUsage(argv[0]);
+            return 1;
+        }
+        return runConvert(opts);
+    }
+    
+    // The partition_hypergraph mode works on a hypergraph file only
+    if (opts.mode == Mode::PARTITION_HYPERGRAPH) {
+        if (opts.input_file.empty()) {
+            logger.error("Input hypergraph file is required (-i)");
+            printUsage(argv[0]);
+            return 1;
+        }
+        return runPartitionHypergraph(opts);
+    }
+    
     // Validate common required options
     if (opts.verilog_file.empty()) {
         logger.error("Verilog file is required (-v)");
@@ -11,20 +11,27 @@
 #include "Coarsener.h"
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cstdint>
 #include <cstdlib>
+#include <functional>
 #include <limits>
 #include <map>
 #include <memory>
 #include <numeric>
 #include <random>
 #include <set>
+#include <thread>
+#include <tuple>
 #include <utility>
 #include <vector>
 
 #include "Evaluator.h"
 #include "Hypergraph.h"
+#include "ThreadPool.h"
 #include "Utilities.h"
+#include "WeightVector.h"
 #include "utils/Logger.h"
 using utl::PAR;
 
@@ -64,6 +71,12 @@ Coarsener::Coarsener(const int num_parts,
 // because the hgraphs returned can be edited
 // The timing cost of hgraph will be initialized if it has been not.
 CoarseGraphPtrs Coarsener::LazyFirstChoice(const HGraphPtr& hgraph) const
+{
+  return LazyFirstChoice(hgraph, random_seed_);
+}
+
+CoarseGraphPtrs Coarsener::LazyFirstChoice(const HGraphPtr& hgraph,
+                                           const int seed) const
 {
   const auto start_timestamp = std::chrono::high_resolution_clock::now();
   const bool timing_flag = hgraph->HasTiming();
@@ -99,7 +112,7 @@ CoarseGraphPtrs Coarsener::LazyFirstChoice(const HGraphPtr& hgraph) const
 
   for (int num_iter = 0; num_iter < max_coarsen_iters_; ++num_iter) {
     // do coarsening step
-    auto hg = Aggregate(hierarchy.back());
+    auto hg = Aggregate(hierarchy.back(), seed);
     const int num_vertices_pre_iter = hierarchy.back()->GetNumVertices();
     const int num_vertices_cur_iter = hg->GetNumVertices();
     if (num_vertices_pre_iter == num_vertices_cur_iter) {
@@ -208,7 +221,8 @@ HGraphPtr Coarsener::GroupVertices(
 // Single-level Coarsening
 // The input is a hypergraph
 // The output is a coarser hypergraph
-HGraphPtr Coarsener::Aggregate(const HGraphPtr& hgraph) const
+HGraphPtr Coarsener::Aggregate(const HGraphPtr& hgraph,
+                                const int seed) const
 {
   std::vector<int> vertex_cluster_id_vec;
   Matrix<float> vertex_weights_c;
@@ -217,12 +231,23 @@ HGraphPtr Coarsener::Aggregate(const HGraphPtr& hgraph) const
   Matrix<float> placement_attr_c;
 
   // find the vertex matching scheme
-  VertexMatching(hgraph,
-                 vertex_cluster_id_vec,
-                 vertex_weights_c,
-                 community_attr_c,
-                 fixed_attr_c,
-                 placement_attr_c);
+  if (coarsen_scheme_ == CoarsenScheme::kParallelFirstChoice) {
+    ParallelVertexMatching(hgraph,
+                           vertex_cluster_id_vec,
+                           vertex_weights_c,
+                           community_attr_c,
+                           fixed_attr_c,
+                           placement_attr_c,
+                           seed);
+  } else {
+    VertexMatching(hgraph,
+                   vertex_cluster_id_vec,
+                   vertex_weights_c,
+                   community_attr_c,
+                   fixed_attr_c,
+                   placement_attr_c,
+                   seed);
+  }
 
   // coarsen the input hypergraph based on vertex matching map
   auto clustered_hgraph = Contraction(hgraph,
@@ -259,7 +284,8 @@ void Coarsener::VertexMatching(
     Matrix<float>& vertex_weights_c,
     std::vector<int>& community_attr_c,
     std::vector<int>& fixed_attr_c,
-    Matrix<float>& placement_attr_c) const
+    Matrix<float>& placement_attr_c,
+    const int seed) const
 {
   // vertex_cluster_map_vec has the size of the number of vertices of hgraph
   vertex_cluster_id_vec.clear();
@@ -284,13 +310,13 @@ void Coarsener::VertexMatching(
       // mark fixed vertices as single-vertex clusters
       if (hgraph->GetFixedAttr(v) > -1) {
         vertex_cluster_id_vec[v] = cluster_id++;
-        vertex_weights_c.push_back(hgraph->GetVertexWeights(v));
+        vertex_weights_c.emplace_back(hgraph->GetVertexWeights(v));
         fixed_attr_c.push_back(hgraph->GetFixedAttr(v));
         if (hgraph->HasCommunity()) {
           community_attr_c.push_back(hgraph->GetCommunity(v));
         }
         if (hgraph->HasPlacement()) {
-          placement_attr_c.push_back(hgraph->GetPlacement(v));
+          placement_attr_c.emplace_back(hgraph->GetPlacement(v));
         }
       } else {
         unvisited.push_back(v);  // this vertex is not fixed
@@ -298,7 +324,7 @@ void Coarsener::VertexMatching(
     }
   }
   // shuffle the remaining vertices based on user-specified options
-  OrderVertices(hgraph, unvisited);
+  OrderVertices(hgraph, unvisited, seed);
   // calculate the best vertex to cluster for current vertex
   // if the number of visited vertices is larger than
   // num_early_stop_visited_vertices, then stop the coarsening process
@@ -345,12 +371,14 @@ void Coarsener::VertexMatching(
           continue;
         }
         // check the vertex weight constraint
-        const std::vector<float>& nbr_v_weight
+        const WeightView nbr_v_weight
             = vertex_cluster_id_vec[nbr_v] > -1
-                  ? vertex_weights_c[vertex_cluster_id_vec[nbr_v]]
+                  ? WeightView(vertex_weights_c[vertex_cluster_id_vec[nbr_v]])
                   : hgraph->GetVertexWeights(nbr_v);
-        // This line needs to be updated
-        if (hgraph->GetVertexWeights(v) + nbr_v_weight > thr_cluster_weight_) {
+        // merged weight > thr_cluster_weight_ (lexicographic)
+        WeightVector merged_weight(hgraph->GetVertexWeights(v));
+        merged_weight += nbr_v_weight;
+        if (LexicographicLess(thr_cluster_weight_, merged_weight)) {
           continue;  // cannot satisfy the vertex weight constraint
         }
         score_map[nbr_v] = he_score;
@@ -361,9 +389,9 @@ void Coarsener::VertexMatching(
     if (score_map.empty()) {
       num_visited_vertices++;
       vertex_cluster_id_vec[v] = cluster_id++;
-      vertex_weights_c.push_back(hgraph->GetVertexWeights(v));
+      vertex_weights_c.emplace_back(hgraph->GetVertexWeights(v));
       if (hgraph->HasPlacement()) {
-        placement_attr_c.push_back(hgraph->GetPlacement(v));
+        placement_attr_c.emplace_back(hgraph->GetPlacement(v));
       }
       if (hgraph->HasCommunity()) {
         community_attr_c.push_back(hgraph->GetCommunity(v));
@@ -435,9 +463,9 @@ void Coarsener::VertexMatching(
       num_visited_vertices += 1;
       vertex_cluster_id_vec[v] = cluster_id;
       cluster_id++;
-      vertex_weights_c.push_back(hgraph->GetVertexWeights(v));
+      vertex_weights_c.emplace_back(hgraph->GetVertexWeights(v));
       if (hgraph->HasPlacement()) {
-        placement_attr_c.push_back(hgraph->GetPlacement(v));
+        placement_attr_c.emplace_back(hgraph->GetPlacement(v));
       }
       if (hgraph->HasCommunity()) {
         community_attr_c.push_back(hgraph->GetCommunity(v));
@@ -465,8 +493,8 @@ void Coarsener::VertexMatching(
                                              hgraph->GetPlacement(v));
       }
       // update the weight of cluster
-      vertex_weights_c[best_cluster_id]
-          = vertex_weights_c[best_cluster_id] + hgraph->GetVertexWeights(v);
+      Accumulate(vertex_weights_c[best_cluster_id],
+                 hgraph->GetVertexWeights(v));
     } else {
       num_visited_vertices += 2;
       vertex_cluster_id_vec[best_vertex] = cluster_id;
@@ -498,9 +526,9 @@ void Coarsener::VertexMatching(
           continue;  // this vertex has been visited
         }
         vertex_cluster_id_vec[cur_vertex] = cluster_id++;
-        vertex_weights_c.push_back(hgraph->GetVertexWeights(cur_vertex));
+        vertex_weights_c.emplace_back(hgraph->GetVertexWeights(cur_vertex));
         if (hgraph->HasPlacement()) {
-          placement_attr_c.push_back(hgraph->GetPlacement(cur_vertex));
+          placement_attr_c.emplace_back(hgraph->GetPlacement(cur_vertex));
         }
         if (hgraph->HasCommunity()) {
           community_attr_c.push_back(hgraph->GetCommunity(cur_vertex));
@@ -514,6 +542,346 @@ void Coarsener::VertexMatching(
   }
 }
 
+// Parallel first-choice matching.
+// The vertices are visited in the order given by OrderVertices. Each thread
+// claims a small chunk of vertices at a time and moves each vertex v into
+// the cluster of its best neighbor, using the same score and the same
+// fixed-vertex, community and weight constraints as VertexMatching.
+// All the shared states are updated with atomic operations:
+// (1) match_state : a vertex is either unmatched, being matched or matched.
+//     A vertex can only be clustered after changing its state from
+//     kUnmatched to kMatching, so each vertex is clustered exactly once.
+// (2) cluster_weight : the weight of a cluster is reserved with
+//     compare-and-swap against thr_cluster_weight_ before a vertex joins
+//     the cluster, so the weight constraint holds without locking.
+// (3) conflict resolution : if the best neighbor u of v is being matched
+//     by another thread, v waits for u only if u < v, otherwise v stays as
+//     a single-vertex cluster. The waiting chains are strictly decreasing in
+//     vertex id, so two vertices selecting each other cannot deadlock.
+// The cluster ids and the cluster attributes are generated sequentially at
+// the end. The result only depends on the thread scheduling when more than
+// one thread is used.
+void Coarsener::ParallelVertexMatching(
+    const HGraphPtr& hgraph,
+    std::vector<int>&
+        vertex_cluster_id_vec,  // map current vertex_id to cluster_id
+    // the remaining arguments are related to clusters
+    Matrix<float>& vertex_weights_c,
+    std::vector<int>& community_attr_c,
+    std::vector<int>& fixed_attr_c,
+    Matrix<float>& placement_attr_c,
+    const int seed) const
+{
+  enum MatchState : int
+  {
+    kUnmatched,
+    kMatching,
+    kMatched
+  };
+
+  const int num_vertices = hgraph->GetNumVertices();
+  const int num_dims = hgraph->GetVertexDimensions();
+  std::vector<std::atomic<int>> match_state(num_vertices);
+  // the vertex representing the cluster of each vertex
+  std::vector<std::atomic<int>> leader(num_vertices);
+  // the weight of the cluster represented by each vertex
+  std::vector<std::atomic<float>> cluster_weight(
+      static_cast<size_t>(num_vertices) * num_dims);
+  std::vector<int> unvisited;
+  unvisited.reserve(num_vertices);
+  for (int v = 0; v < num_vertices; v++) {
+    leader[v].store(v, std::memory_order_relaxed);
+    const WeightView weight = hgraph->GetVertexWeights(v);
+    for (int dim = 0; dim < num_dims; dim++) {
+      cluster_weight[static_cast<size_t>(v) * num_dims + dim].store(
+          weight[dim], std::memory_order_relaxed);
+    }
+    // fixed vertices are single-vertex clusters
+    if (hgraph->HasFixedVertices() && hgraph->GetFixedAttr(v) > -1) {
+      match_state[v].store(kMatched, std::memory_order_relaxed);
+    } else {
+      match_state[v].store(kUnmatched, std::memory_order_relaxed);
+      unvisited.push_back(v);
+    }
+  }
+  // shuffle the remaining vertices based on user-specified options
+  OrderVertices(hgraph, unvisited, seed);
+  // if the number of clusters is no more than
+  // num_early_stop_visited_vertices, then stop the coarsening process
+  const int num_early_stop_visited_vertices
+      = static_cast<int>(unvisited.size()) / coarsening_ratio_;
+  std::atomic<int> num_clusters{num_vertices};
+
+  auto atomic_add = [](std::atomic<float>& value, const float delta) {
+    float old_value = value.load(std::memory_order_relaxed);
+    while (!value.compare_exchange_weak(
+        old_value, old_value + delta, std::memory_order_relaxed)) {
+    }
+  };
+
+  // check if v can be added to the cluster represented by c
+  auto fit_cluster = [&](const int c, const int v) {
+    const WeightView weight = hgraph->GetVertexWeights(v);
+    for (int dim = 0; dim < num_dims; dim++) {
+      const float c_weight
+          = cluster_weight[static_cast<size_t>(c) * num_dims + dim].load(
+              std::memory_order_relaxed);
+      if (c_weight + weight[dim] > thr_cluster_weight_[dim]) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  // reserve the weight of v in the cluster represented by c
+  auto reserve_weight = [&](const int c, const int v) {
+    const WeightView weight = hgraph->GetVertexWeights(v);
+    for (int dim = 0; dim < num_dims; dim++) {
+      std::atomic<float>& c_weight
+          = cluster_weight[static_cast<size_t>(c) * num_dims + dim];
+      float old_weight = c_weight.load(std::memory_order_relaxed);
+      do {
+        if (old_weight + weight[dim] > thr_cluster_weight_[dim]) {
+          // roll back the dimensions which have been reserved
+          for (int pre_dim = 0; pre_dim < dim; pre_dim++) {
+            atomic_add(
+                cluster_weight[static_cast<size_t>(c) * num_dims + pre_dim],
+                -weight[pre_dim]);
+          }
+          return false;
+        }
+      } while (!c_weight.compare_exchange_weak(old_weight,
+                                               old_weight + weight[dim],
+                                               std::memory_order_relaxed));
+    }
+    return true;
+  };
+
+  // move v (in state kMatching) into the cluster of u.
+  // return false if v stays as a single-vertex cluster
+  auto join_cluster = [&](const int v, const int u) {
+    while (true) {
+      int u_state = match_state[u].load(std::memory_order_acquire);
+      if (u_state == kMatched) {
+        const int c = leader[u].load(std::memory_order_relaxed);
+        if (!reserve_weight(c, v)) {
+          return false;
+        }
+        leader[v].store(c, std::memory_order_relaxed);
+        return true;
+      }
+      if (u_state == kUnmatched) {
+        // u becomes the representative of a new cluster
+        if (!match_state[u].compare_exchange_strong(
+                u_state, kMatching, std::memory_order_acq_rel)) {
+          continue;  // u has been claimed by another thread
+        }
+        const bool success = reserve_weight(u, v);
+        if (success) {
+          leader[v].store(u, std::memory_order_relaxed);
+        }
+        match_state[u].store(success ? kMatched : kUnmatched,
+                             std::memory_order_release);
+        return success;
+      }
+      // u is being matched by another thread
+      if (u > v) {
+        return false;
+      }
+      std::this_thread::yield();
+    }
+  };
+
+  // the score of each neighbor is stored in score.
+  // candidate_flag : 0 for new neighbor, 1 for candidate, 2 for the neighbor
+  // which violates the merging conditions
+  auto match_vertex = [&](const int v,
+                          std::vector<float>& score,
+                          std::vector<uint8_t>& candidate_flag,
+                          std::vector<int>& neighbors) {
+    if (match_state[v].load(std::memory_order_relaxed) != kUnmatched) {
+      return;  // this vertex has been mapped
+    }
+    // traverse all its neighbors
+    for (const int he : hgraph->Edges(v)) {
+      const auto edge_range = hgraph->Vertices(he);
+      const int he_size = edge_range.size();
+      if (he_size <= 1 || he_size > thr_coarsen_hyperedge_size_skip_) {
+        continue;
+      }
+      // get the normalized score
+      const float he_score = evaluator_->GetNormEdgeScore(he, hgraph);
+      for (const int nbr_v : edge_range) {
+        if (nbr_v == v || candidate_flag[nbr_v] == 2) {
+          continue;
+        }
+        // if the nbr_v has been identified
+        if (candidate_flag[nbr_v] == 1) {
+          score[nbr_v] += he_score;
+          continue;
+        }
+        // if the nbr_v is a new neighbor
+        // check if the merging conditions are satisfied
+        neighbors.push_back(nbr_v);
+        if ((hgraph->HasFixedVertices() && hgraph->GetFixedAttr(nbr_v) > -1)
+            || (hgraph->HasCommunity()
+                && hgraph->GetCommunity(v) != hgraph->GetCommunity(nbr_v))
+            || !fit_cluster(leader[nbr_v].load(std::memory_order_relaxed),
+                            v)) {
+          candidate_flag[nbr_v] = 2;
+          continue;
+        }
+        candidate_flag[nbr_v] = 1;
+        score[nbr_v] = he_score;
+      }
+    }  // finish traversing all the neighbors
+    // update the score based on critical timing paths
+    // (the direct neighbors of v on each path, same as VertexMatching)
+    if (hgraph->HasTiming() && hgraph->GetNumTimingPaths() > 0) {
+      for (const int p : hgraph->TimingPathsThrough(v)) {
+        const float path_timing_score
+            = evaluator_->GetPathTimingScore(p, hgraph);
+        auto path_range = hgraph->PathVertices(p);
+        for (auto iter = path_range.begin(); iter != path_range.end(); ++iter) {
+          if (*iter != v) {
+            continue;
+          }
+          if (iter != path_range.begin() && candidate_flag[*(iter - 1)] == 1) {
+            score[*(iter - 1)] += path_timing_score;  // left neighbor
+          }
+          if (iter + 1 != path_range.end()
+              && candidate_flag[*(iter + 1)] == 1) {
+            score[*(iter + 1)] += path_timing_score;  // right neighbor
+          }
+        }
+      }
+    }
+    // find the best neighbor vertex
+    float best_score = -std::numeric_limits<float>::max();
+    int best_vertex = -1;
+    for (const int u : neighbors) {
+      if (candidate_flag[u] != 1) {
+        continue;
+      }
+      // update the score based on physical location information
+      if (hgraph->HasPlacement()) {
+        score[u] += evaluator_->GetPlacementScore(v, u, hgraph);
+      }
+      if (score[u] > best_score) {
+        best_vertex = u;
+        best_score = score[u];
+      } else if (score[u] == best_score
+                 && match_state[u].load(std::memory_order_relaxed)
+                        == kUnmatched) {
+        best_vertex = u;
+      }
+    }
+    // reset the neighbors for the next vertex
+    for (const int u : neighbors) {
+      candidate_flag[u] = 0;
+      score[u] = 0.0f;
+    }
+    neighbors.clear();
+    // v may have been claimed by another thread in the meantime
+    int v_state = kUnmatched;
+    if (!match_state[v].compare_exchange_strong(
+            v_state, kMatching, std::memory_order_acq_rel)) {
+      return;
+    }
+    if (best_vertex > -1 && join_cluster(v, best_vertex)) {
+      num_clusters.fetch_sub(1, std::memory_order_relaxed);
+    }
+    match_state[v].store(kMatched, std::memory_order_release);
+  };
+
+  // each task works as one thread and claims the vertices chunk by chunk,
+  // so the vertices are visited roughly in the specified order
+  const int kChunkSize = 64;
+  const int num_tasks = thread_pool_ ? thread_pool_->GetNumThreads() : 1;
+  std::atomic<int> next_vertex{0};
+  auto matching_task = [&](int) {
+    std::vector<float> score(num_vertices, 0.0f);
+    std::vector<uint8_t> candidate_flag(num_vertices, 0);
+    std::vector<int> neighbors;
+    while (true) {
+      const int begin = next_vertex.fetch_add(kChunkSize);
+      if (begin >= static_cast<int>(unvisited.size())) {
+        return;
+      }
+      const int end
+          = std::min(begin + kChunkSize, static_cast<int>(unvisited.size()));
+      for (int i = begin; i < end; i++) {
+        // check the early-stop condition
+        if (num_clusters.load(std::memory_order_relaxed)
+            <= num_early_stop_visited_vertices) {
+          return;
+        }
+        match_vertex(unvisited[i], score, candidate_flag, neighbors);
+      }
+    }
+  };
+  if (thread_pool_) {
+    thread_pool_->ParallelFor(num_tasks, matching_task);
+  } else {
+    matching_task(0);
+  }
+
+  // assign the cluster id based on the representative vertices
+  vertex_cluster_id_vec.clear();
+  vertex_cluster_id_vec.resize(num_vertices, -1);
+  int cluster_id = 0;
+  for (int v = 0; v < num_vertices; v++) {
+    if (leader[v].load(std::memory_order_relaxed) == v) {
+      vertex_cluster_id_vec[v] = cluster_id++;
+    }
+  }
+  for (int v = 0; v < num_vertices; v++) {
+    vertex_cluster_id_vec[v]
+        = vertex_cluster_id_vec[leader[v].load(std::memory_order_relaxed)];
+  }
+  // generate the attributes of clusters
+  vertex_weights_c.clear();
+  community_attr_c.clear();
+  fixed_attr_c.clear();
+  placement_attr_c.clear();
+  vertex_weights_c.resize(cluster_id);
+  if (hgraph->HasCommunity()) {
+    community_attr_c.resize(cluster_id);
+  }
+  if (hgraph->HasFixedVertices()) {
+    fixed_attr_c.resize(cluster_id);
+  }
+  if (hgraph->HasPlacement()) {
+    placement_attr_c.resize(cluster_id);
+  }
+  for (int v = 0; v < num_vertices; v++) {
+    const int c = vertex_cluster_id_vec[v];
+    if (vertex_weights_c[c].empty()) {
+      // the first vertex of the cluster
+      vertex_weights_c[c] = std::vector<float>(hgraph->GetVertexWeights(v));
+      if (hgraph->HasPlacement()) {
+        placement_attr_c[c] = std::vector<float>(hgraph->GetPlacement(v));
+      }
+      if (hgraph->HasCommunity()) {
+        community_attr_c[c] = hgraph->GetCommunity(v);
+      }
+      if (hgraph->HasFixedVertices()) {
+        fixed_attr_c[c] = hgraph->GetFixedAttr(v);
+      }
+      continue;
+    }
+    // you cannot change the order here
+    if (hgraph->HasPlacement()) {
+      placement_attr_c[c]
+          = evaluator_->GetAvgPlacementLoc(vertex_weights_c[c],
+                                           hgraph->GetVertexWeights(v),
+                                           placement_attr_c[c],
+                                           hgraph->GetPlacement(v));
+    }
+    Accumulate(vertex_weights_c[c], hgraph->GetVertexWeights(v));
+  }
+}
+
 // handle group information
 // group fixed vertices based on each block
 // group vertices based on group_attr and hgraph->fixed_attr_
@@ -539,7 +907,7 @@ void Coarsener::ClusterBasedGroupInfo(
     vertex_cluster_id_vec.clear();
     vertex_cluster_id_vec.resize(hgraph->GetNumVertices());
     std::iota(vertex_cluster_id_vec.begin(), vertex_cluster_id_vec.end(), 0);
-    vertex_weights_c = hgraph->GetVertexWeights();
+    hgraph->CopyVertexWeights(vertex_weights_c);
     hgraph->CopyCommunity(community_attr_c);
     hgraph->CopyFixedAttr(fixed_attr_c);
     hgraph->CopyPlacement(placement_attr_c);
@@ -643,20 +1011,20 @@ void Coarsener::ClusterBasedGroupInfo(
                                            placement_attr_c[cluster_id],
                                            hgraph->GetPlacement(v));
     }
-    vertex_weights_c[cluster_id]
-        = vertex_weights_c[cluster_id] + hgraph->GetVertexWeights(v);
+    Accumulate(vertex_weights_c[cluster_id], hgraph->GetVertexWeights(v));
   }
 }
 
 // order the vertices based on user-specified parameters
 void Coarsener::OrderVertices(const HGraphPtr& hgraph,
-                              std::vector<int>& vertices) const
+                              std::vector<int>& vertices,
+                              const int seed) const
 {
   switch (vertex_order_choice_) {
     case CoarsenOrder::kRandom:
       shuffle(vertices.begin(),
               vertices.end(),
-              std::default_random_engine(random_seed_));
+              std::default_random_engine(seed));
       return;
 
     case CoarsenOrder::kDefault:
@@ -715,116 +1083,229 @@ HGraphPtr Coarsener::Contraction(
     const std::vector<int>& fixed_attr_c,
     const Matrix<float>& placement_attr_c) const
 {
-  // Step 1:  identify the contracted hyperedges
-  std::vector<int> hyperedge_cluster_id_vec;  // map the hyperedge to hyperedge
-                                              // in clustered hypergraph
-  hyperedge_cluster_id_vec.resize(hgraph->GetNumHyperedges());
-  // -1 means the hyperedge is fully within one cluster
-  std::fill(
-      hyperedge_cluster_id_vec.begin(), hyperedge_cluster_id_vec.end(), -1);
-  Matrix<int> hyperedges_c;  // represent each hyperedge as a set of clusters
-  Matrix<float> hyperedges_weights_c;  // each element represents the weight of
-                                       // the clustered hyperedge
-  std::vector<float> hyperedge_slack_c;  // the slack for clustered hyperedge.
-  std::vector<std::set<int>>
-      hyperedge_arc_set_c;  // map current hyperedge into arcs in timing graph.
-                            // We need this for propagation
-  std::map<size_t, int>
-      hash_map;  // store the hash value of each contracted hyperedge
-  std::map<size_t, std::vector<int>>
-      parallel_hash_map;  // store the hyperedges_c with the same hash_value
-                          // (candidate)
-  for (int e = 0; e < hgraph->GetNumHyperedges(); e++) {
-    const auto range = hgraph->Vertices(e);
-    const int he_size = range.size();
-    if (he_size <= 1 || he_size > thr_coarsen_hyperedge_size_skip_) {
-      continue;  // ignore the single-vertex hyperedge and large hyperedge
-    }
-    std::set<int> hyperedge_c;
-    for (const int vertex_id : range) {
-      hyperedge_c.insert(vertex_cluster_id_vec[vertex_id]);  // get cluster id
-    }
-    if (hyperedge_c.size() <= 1) {
-      continue;  // ignore the single-vertex hyperedge
-    }
-    size_t hash_value = std::inner_product(hyperedge_c.begin(),
-                                           hyperedge_c.end(),
-                                           hyperedge_c.begin(),
-                                           static_cast<size_t>(0));
-    // check if the hash value has been used
-    // for detecting parallel hyperedge
-    // hyperedge_slack_c[e] = min_slack(hyperedge_arc_set_c[e])
-    if (hash_map.find(hash_value) == hash_map.end()) {
-      const int hyperedge_c_id = static_cast<int>(hyperedges_c.size());
-      hyperedge_cluster_id_vec[e] = hyperedge_c_id;
-      hash_map[hash_value] = hyperedge_c_id;
-      hyperedges_c.push_back(
-          std::vector<int>(hyperedge_c.begin(), hyperedge_c.end()));
-      hyperedges_weights_c.push_back(hgraph->GetHyperedgeWeights(e));
-      if (hgraph->HasTiming()) {
-        hyperedge_slack_c.push_back(
-            hgraph->GetHyperedgeTimingAttr(e));  // the slack of hyperedge
-        hyperedge_arc_set_c.push_back(
-            hgraph->GetHyperedgeArcSet(e));  // map the hyperedge to timing arcs
+  const int num_hyperedges = hgraph->GetNumHyperedges();
+  // Step 1: map the vertices of each hyperedge to clusters.
+  // The pins of all the hyperedges are remapped in parallel into one flat
+  // buffer, where each hyperedge is sorted and deduplicated in place.
+  // pin_offset[e] is the first pin of hyperedge e in pins_c.
+  std::vector<int> pin_offset(num_hyperedges + 1, 0);
+  for (int e = 0; e < num_hyperedges; e++) {
+    const int he_size = hgraph->Vertices(e).size();
+    // ignore the single-vertex hyperedge and large hyperedge
+    const bool skip
+        = he_size <= 1 || he_size > thr_coarsen_hyperedge_size_skip_;
+    pin_offset[e + 1] = pin_offset[e] + (skip ? 0 : he_size);
+  }
+  std::vector<int> pins_c(pin_offset.back());
+  // the number of clusters in each hyperedge, 0 for the removed hyperedge
+  std::vector<int> num_pins_c(num_hyperedges, 0);
+  // the fingerprint of each contracted hyperedge
+  std::vector<size_t> fingerprint(num_hyperedges, 0);
+  RunChunks(num_hyperedges, [&](const int begin, const int end) {
+    for (int e = begin; e < end; e++) {
+      if (pin_offset[e] == pin_offset[e + 1]) {
+        continue;
       }
-      continue;
+      auto first = pins_c.begin() + pin_offset[e];
+      auto last = first;
+      for (const int vertex_id : hgraph->Vertices(e)) {
+        *last++ = vertex_cluster_id_vec[vertex_id];  // get cluster id
+      }
+      std::sort(first, last);
+      last = std::unique(first, last);
+      if (last - first <= 1) {
+        continue;  // ignore the single-vertex hyperedge
+      }
+      num_pins_c[e] = static_cast<int>(last - first);
+      size_t hash_value = num_pins_c[e];
+      for (auto iter = first; iter != last; ++iter) {
+        hash_value ^= static_cast<size_t>(*iter) + 0x9e3779b97f4a7c15ULL
+                      + (hash_value << 6) + (hash_value >> 2);
+      }
+      fingerprint[e] = hash_value;
     }
+  });
 
-    // there may be parallel hyperedges
-    const int hash_hyperedge_c_id
-        = hash_map[hash_value];  // the hyperedge_c has been found
-    std::vector<int> hyperedge_vec(hyperedge_c.begin(), hyperedge_c.end());
-    // check the representative hyperedge_c
-    int parallel_hyperedge_c_id
-        = -1;  // the hyperedge_c_id of parallel hyperedge
-    // find the parallel_hyperedge_c_id
-    if (hyperedge_vec == hyperedges_c[hash_hyperedge_c_id]) {
-      // check the representative hyperedge_c
-      parallel_hyperedge_c_id = hash_hyperedge_c_id;
-    } else {
-      // check the parallel hyperedge_c_id
-      for (const auto& candidate_id : parallel_hash_map[hash_value]) {
-        if (hyperedge_vec == hyperedges_c[candidate_id]) {
-          parallel_hyperedge_c_id = candidate_id;
-          break;  // found the same hyperedge_c
+  // Step 2: detect the parallel hyperedges.
+  // Sort the remaining hyperedges by their fingerprints, then only the
+  // hyperedges in the same run of fingerprints need to be compared.
+  // The hyperedges in each run are sorted by hyperedge id, so the
+  // representative of a group of parallel hyperedges is the first one.
+  std::vector<int> candidates;
+  candidates.reserve(num_hyperedges);
+  for (int e = 0; e < num_hyperedges; e++) {
+    if (num_pins_c[e] > 0) {
+      candidates.push_back(e);
+    }
+  }
+  auto compare_fingerprint = [&](const int a, const int b) {
+    return std::tie(fingerprint[a], num_pins_c[a], a)
+           < std::tie(fingerprint[b], num_pins_c[b], b);
+  };
+  if (thread_pool_) {
+    thread_pool_->ParallelSort(candidates, compare_fingerprint);
+  } else {
+    std::sort(candidates.begin(), candidates.end(), compare_fingerprint);
+  }
+  std::vector<int> run_start;  // the start of each run of fingerprints
+  for (int i = 0; i < static_cast<int>(candidates.size()); i++) {
+    if (i == 0 || fingerprint[candidates[i]] != fingerprint[candidates[i - 1]]
+        || num_pins_c[candidates[i]] != num_pins_c[candidates[i - 1]]) {
+      run_start.push_back(i);
+    }
+  }
+  const int num_runs = static_cast<int>(run_start.size());
+  run_start.push_back(static_cast<int>(candidates.size()));
+  auto same_pins = [&](const int a, const int b) {
+    return std::equal(pins_c.begin() + pin_offset[a],
+                      pins_c.begin() + pin_offset[a] + num_pins_c[a],
+                      pins_c.begin() + pin_offset[b]);
+  };
+  std::vector<int> representative(num_hyperedges, -1);
+  RunChunks(num_runs, [&](const int begin, const int end) {
+    for (int run = begin; run < end; run++) {
+      for (int i = run_start[run]; i < run_start[run + 1]; i++) {
+        const int e = candidates[i];
+        representative[e] = e;
+        // different hyperedges may have the same fingerprint
+        for (int j = run_start[run]; j < i; j++) {
+          const int rep_e = candidates[j];
+          if (representative[rep_e] == rep_e && same_pins(e, rep_e)) {
+            representative[e] = rep_e;
+            break;
+          }
         }
       }
     }
-    // check if the hyperedge has been existed
-    if (parallel_hyperedge_c_id == -1) {
-      // not existed
-      const int hyperedge_c_id = static_cast<int>(hyperedges_c.size());
-      hyperedge_cluster_id_vec[e] = hyperedge_c_id;
-      parallel_hash_map[hash_value].push_back(hyperedge_c_id);
-      hyperedges_c.push_back(hyperedge_vec);
-      hyperedges_weights_c.push_back(hgraph->GetHyperedgeWeights(e));
-      if (hgraph->HasTiming()) {
-        hyperedge_slack_c.push_back(
-            hgraph->GetHyperedgeTimingAttr(e));  // the slack of hyperedge
-        hyperedge_arc_set_c.push_back(
-            hgraph->GetHyperedgeArcSet(e));  // map the hyperedge to timing arcs
+  });
+
+  // map the hyperedge to hyperedge in clustered hypergraph.
+  // -1 means the hyperedge is fully within one cluster.
+  // The contracted hyperedges follow the order of the original hyperedges
+  std::vector<int> hyperedge_cluster_id_vec(num_hyperedges, -1);
+  std::vector<int> eptr_c(1, 0);  // the CSR of the contracted hyperedges
+  for (int e = 0; e < num_hyperedges; e++) {
+    if (num_pins_c[e] > 0 && representative[e] == e) {
+      hyperedge_cluster_id_vec[e] = static_cast<int>(eptr_c.size()) - 1;
+      eptr_c.push_back(eptr_c.back() + num_pins_c[e]);
+    }
+  }
+  const int num_hyperedges_c = static_cast<int>(eptr_c.size()) - 1;
+  const int hyperedge_dimensions = hgraph->GetHyperedgeDimensions();
+  std::vector<int> eind_c(eptr_c.back());
+  // the weights of the contracted hyperedges, row by row
+  std::vector<float> hyperedges_weights_c(
+      static_cast<size_t>(num_hyperedges_c) * hyperedge_dimensions);
+  // the slack for clustered hyperedge.
+  // hyperedge_slack_c[e] = min_slack(arcs of e)
+  std::vector<float> hyperedge_slack_c;
+  // map current hyperedge into arcs in timing graph (CSR format).
+  // We need this for propagation.
+  // arc_ptr_c first reserves room for the arcs of all the merged
+  // hyperedges, num_arcs_c is the number of arcs filled so far.
+  std::vector<int> arc_ind_c;
+  std::vector<int> arc_ptr_c;
+  std::vector<int> num_arcs_c;
+  if (hgraph->HasTiming()) {
+    hyperedge_slack_c.resize(num_hyperedges_c);
+    arc_ptr_c.assign(num_hyperedges_c + 1, 0);
+    for (int e = 0; e < num_hyperedges; e++) {
+      if (num_pins_c[e] > 0) {
+        arc_ptr_c[hyperedge_cluster_id_vec[representative[e]] + 1]
+            += hgraph->GetHyperedgeArcSet(e).size();
       }
-    } else {
-      // existed
-      hyperedges_weights_c[parallel_hyperedge_c_id]
-          = hyperedges_weights_c[parallel_hyperedge_c_id]
-            + hgraph->GetHyperedgeWeights(e);
-      hyperedge_cluster_id_vec[e] = parallel_hyperedge_c_id;
-      if (hgraph->HasTiming()) {
-        hyperedge_slack_c[parallel_hyperedge_c_id]
-            = std::min(hyperedge_slack_c[parallel_hyperedge_c_id],
-                       hgraph->GetHyperedgeTimingAttr(e));
-        hyperedge_arc_set_c[parallel_hyperedge_c_id].insert(
-            hgraph->GetHyperedgeArcSet(e).begin(),
-            hgraph->GetHyperedgeArcSet(e).end());
+    }
+    std::partial_sum(arc_ptr_c.begin(), arc_ptr_c.end(), arc_ptr_c.begin());
+    arc_ind_c.resize(arc_ptr_c.back());
+    num_arcs_c.assign(num_hyperedges_c, 0);
+  }
+  auto add_arcs = [&](const int e, const int hyperedge_c_id) {
+    const auto arcs = hgraph->GetHyperedgeArcSet(e);
+    std::copy(arcs.begin(),
+              arcs.end(),
+              arc_ind_c.begin() + arc_ptr_c[hyperedge_c_id]
+                  + num_arcs_c[hyperedge_c_id]);
+    num_arcs_c[hyperedge_c_id] += arcs.size();
+  };
+  // merge the parallel hyperedges into their representatives.
+  // The runs are independent, and the hyperedges in each run are visited in
+  // increasing order, so the weights are accumulated in the same order as
+  // the sequential implementation.
+  RunChunks(num_runs, [&](const int begin, const int end) {
+    for (int run = begin; run < end; run++) {
+      for (int i = run_start[run]; i < run_start[run + 1]; i++) {
+        const int e = candidates[i];
+        const int hyperedge_c_id = hyperedge_cluster_id_vec[representative[e]];
+        if (representative[e] == e) {
+          std::copy(pins_c.begin() + pin_offset[e],
+                    pins_c.begin() + pin_offset[e] + num_pins_c[e],
+                    eind_c.begin() + eptr_c[hyperedge_c_id]);
+          const WeightView weights = hgraph->GetHyperedgeWeights(e);
+          std::copy(weights.begin(),
+                    weights.end(),
+                    hyperedges_weights_c.begin()
+                        + static_cast<size_t>(hyperedge_c_id)
+                              * hyperedge_dimensions);
+          if (hgraph->HasTiming()) {
+            hyperedge_slack_c[hyperedge_c_id] = hgraph->GetHyperedgeTimingAttr(
+                e);                      // the slack of hyperedge
+            add_arcs(e, hyperedge_c_id);  // map the hyperedge to timing arcs
+          }
+          continue;
+        }
+        const WeightView weights = hgraph->GetHyperedgeWeights(e);
+        float* weights_c = hyperedges_weights_c.data()
+                           + static_cast<size_t>(hyperedge_c_id)
+                                 * hyperedge_dimensions;
+        for (int dim = 0; dim < hyperedge_dimensions; dim++) {
+          weights_c[dim] += weights[dim];
+        }
+        if (hgraph->HasTiming()) {
+          hyperedge_slack_c[hyperedge_c_id]
+              = std::min(hyperedge_slack_c[hyperedge_c_id],
+                         hgraph->GetHyperedgeTimingAttr(e));
+          add_arcs(e, hyperedge_c_id);
+        }
+      }
+    }
+  });
+  if (hgraph->HasTiming()) {
+    // sort and deduplicate the arcs of the merged hyperedges,
+    // then remove the unused room between the hyperedges
+    RunChunks(num_hyperedges_c, [&](const int begin, const int end) {
+      for (int c = begin; c < end; c++) {
+        auto first = arc_ind_c.begin() + arc_ptr_c[c];
+        auto last = first + num_arcs_c[c];
+        std::sort(first, last);
+        num_arcs_c[c] = static_cast<int>(std::unique(first, last) - first);
+      }
+    });
+    int num_arcs = 0;
+    for (int c = 0; c < num_hyperedges_c; c++) {
+      if (arc_ptr_c[c] != num_arcs) {
+        std::copy(arc_ind_c.begin() + arc_ptr_c[c],
+                  arc_ind_c.begin() + arc_ptr_c[c] + num_arcs_c[c],
+                  arc_ind_c.begin() + num_arcs);
       }
+      arc_ptr_c[c] = num_arcs;
+      num_arcs += num_arcs_c[c];
+    }
+    arc_ptr_c[num_hyperedges_c] = num_arcs;
+    arc_ind_c.resize(num_arcs);
+  }
+  for (int e = 0; e < num_hyperedges; e++) {
+    if (num_pins_c[e] > 0) {
+      hyperedge_cluster_id_vec[e] = hyperedge_cluster_id_vec[representative[e]];
     }
   }
 
-  // Step 2: identify all the timing paths
+  // Step 3: identify all the timing paths
   std::vector<TimingPath> timing_paths_c;
-  hash_map.clear();           // used to detect parallel timing path
-  parallel_hash_map.clear();  // used to detect parallel timing path
+  std::map<size_t, int>
+      hash_map;  // store the hash value of each contracted timing path
+  std::map<size_t, std::vector<int>>
+      parallel_hash_map;  // store the timing paths with the same hash_value
+                          // (candidate)
   if (hgraph->HasTiming() && hgraph->GetNumTimingPaths() > 0) {
     for (int p = 0; p < hgraph->GetNumTimingPaths(); ++p) {
       // check vertex representation
@@ -904,42 +1385,58 @@ HGraphPtr Coarsener::Contraction(
     }
   }
 
-  // create vertex_type for clustered hypergraph
+  // Step 4: create the contracted hypergraph.
+  // The arrays are moved into the hypergraph, and the vertex -> hyperedge
+  // incidence is built by the thread pool.
   // Since we allow the merge between different types of vertices
   // so there is no meaning of vertex_type for clusterd hypergraph
-  // so we use empty vector here
-  std::vector<VertexType> vertex_types_c;
-
-  // Step 3: create the contracted hypergraph
-  auto clustered_hgraph
-      = std::make_shared<Hypergraph>(hgraph->GetVertexDimensions(),
-                                     hgraph->GetHyperedgeDimensions(),
-                                     hgraph->GetPlacementDimensions(),
-                                     hyperedges_c,
-                                     vertex_weights_c,
-                                     hyperedges_weights_c,
-                                     // vertex attributes
-                                     fixed_attr_c,
-                                     community_attr_c,
-                                     placement_attr_c,
-                                     vertex_types_c,
-                                     // timing information
-                                     hyperedge_slack_c,
-                                     hyperedge_arc_set_c,
-                                     timing_paths_c,
-                                     logger_);
-
-  // fill vertex_c_attr which maps the vertex to its corresponding cluster
-  // To simpify the implementation, the vertex_c_attr maps the original larger
-  // hypergraph
-  clustered_hgraph->ResetVertexCAttr();
-  for (int v = 0; v < hgraph->GetNumVertices(); v++) {
-    clustered_hgraph->AddVertexCAttr(vertex_cluster_id_vec[v], v);
+  // so we leave the vertex types empty here
+  HypergraphBuilder builder;
+  builder.vertex_dimensions = hgraph->GetVertexDimensions();
+  builder.hyperedge_dimensions = hyperedge_dimensions;
+  builder.placement_dimensions = hgraph->GetPlacementDimensions();
+  builder.eind = std::move(eind_c);
+  builder.eptr = std::move(eptr_c);
+  builder.vertex_weights
+      = FlattenRows(vertex_weights_c, hgraph->GetVertexDimensions());
+  builder.hyperedge_weights = std::move(hyperedges_weights_c);
+  // vertex attributes
+  builder.fixed_attr = fixed_attr_c;
+  builder.community_attr = community_attr_c;
+  if (placement_attr_c.size() == vertex_weights_c.size()) {
+    builder.placement_attr
+        = FlattenRows(placement_attr_c, hgraph->GetPlacementDimensions());
   }
+  // timing information
+  builder.hyperedges_slack = std::move(hyperedge_slack_c);
+  builder.arc_ind = std::move(arc_ind_c);
+  builder.arc_ptr = std::move(arc_ptr_c);
+  for (const auto& timing_path : timing_paths_c) {
+    builder.timing_paths.AddPath(
+        timing_path.path, timing_path.arcs, timing_path.slack);
+  }
+  auto clustered_hgraph = builder.Build(logger_, thread_pool_.get());
+
+  // map the vertices of hgraph to their clusters
+  clustered_hgraph->SetVertexCAttr(std::vector<int>(vertex_cluster_id_vec));
 
   return clustered_hgraph;
 }
 
+void Coarsener::RunChunks(const int num_items,
+                          const std::function<void(int, int)>& task) const
+{
+  const int kChunkSize = 1024;
+  const int num_chunks = (num_items + kChunkSize - 1) / kChunkSize;
+  if (!thread_pool_ || num_chunks <= 1) {
+    task(0, num_items);
+    return;
+  }
+  thread_pool_->ParallelFor(num_chunks, [&](const int chunk) {
+    task(chunk * kChunkSize, std::min((chunk + 1) * kChunkSize, num_items));
+  });
+}
+
 // Utility functions
 std::string ToString(const CoarsenOrder order)
 {
@@ -961,4 +1458,18 @@ std::string ToString(const CoarsenOrder order)
   }
 };
 
+std::string ToString(const CoarsenScheme scheme)
+{
+  switch (scheme) {
+    case CoarsenScheme::kLazyFirstChoice:
+      return std::string("LAZY_FIRST_CHOICE");
+
+    case CoarsenScheme::kParallelFirstChoice:
+      return std::string("PARALLEL_FIRST_CHOICE");
+
+    default:
+      return std::string("LAZY_FIRST_CHOICE");
+  }
+}
+
 }  // namespace par
@@ -9,12 +9,14 @@
 // It will accept a HGraphPtr (std::shared_ptr<Hypergraph>) as input
 // and return a sequence of coarser hypergraphs
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include "Evaluator.h"
 #include "Hypergraph.h"
+#include "ThreadPool.h"
 #include "Utilities.h"
 #include "utils/Logger.h"
 
@@ -39,6 +41,16 @@ enum class CoarsenOrder
 // function : convert CoarsenOrder to string
 std::string ToString(CoarsenOrder order);
 
+// the type for vertex matching
+enum class CoarsenScheme
+{
+  kLazyFirstChoice,     // sequential first-choice matching
+  kParallelFirstChoice  // multi-threaded first-choice matching
+};
+
+// function : convert CoarsenScheme to string
+std::string ToString(CoarsenScheme scheme);
+
 // coarsening class
 // during coarsening, all the coarser hypergraph will not have vertex type
 // Because the timing information will become messy in the coarser hypergraph
@@ -74,6 +86,10 @@ class Coarsener
   // The timing cost of hgraph will be initialized if it has been not.
   CoarseGraphPtrs LazyFirstChoice(const HGraphPtr& hgraph) const;
 
+  // Same as above, but use the given random seed instead of random_seed_,
+  // so several hierarchies can be built concurrently with different seeds.
+  CoarseGraphPtrs LazyFirstChoice(const HGraphPtr& hgraph, int seed) const;
+
   // create a coarser hypergraph based on specified grouping information
   // for each vertex.
   // each vertex has been map its group
@@ -97,6 +113,17 @@ class Coarsener
   }
 
   void IncreaseRandomSeed() { random_seed_++; }
+  int GetRandomSeed() const { return random_seed_; }
+  void SetRandomSeed(int seed) { random_seed_ = seed; }
+
+  // Select the vertex matching used by each coarsening level
+  void SetCoarsenScheme(CoarsenScheme scheme) { coarsen_scheme_ = scheme; }
+
+  // The threads used by the parallel first-choice matching
+  void SetThreadPool(const ThreadPoolPtr& thread_pool)
+  {
+    thread_pool_ = thread_pool;
+  }
 
  private:
   // private functions (utilities)
@@ -105,7 +132,7 @@ class Coarsener
   // The input is a hypergraph
   // The output is a coarser hypergraph
   // The input hypergraph will be updated
-  HGraphPtr Aggregate(const HGraphPtr& hgraph) const;
+  HGraphPtr Aggregate(const HGraphPtr& hgraph, int seed) const;
 
   // find the vertex matching scheme
   // the inputs are the hgraph and the attributes of clusters
@@ -120,10 +147,28 @@ class Coarsener
       Matrix<float>& vertex_weights_c,
       std::vector<int>& community_attr_c,
       std::vector<int>& fixed_attr_c,
-      Matrix<float>& placement_attr_c) const;
+      Matrix<float>& placement_attr_c,
+      int seed) const;
+
+  // Parallel version of VertexMatching.
+  // The vertices are matched concurrently, and the cluster assignment and
+  // the cluster weights are updated with atomic operations.
+  // The outputs are the same as VertexMatching.
+  void ParallelVertexMatching(
+      const HGraphPtr& hgraph,
+      std::vector<int>&
+          vertex_cluster_id_vec,  // map current vertex_id to cluster_id
+      // the remaining arguments are related to clusters
+      Matrix<float>& vertex_weights_c,
+      std::vector<int>& community_attr_c,
+      std::vector<int>& fixed_attr_c,
+      Matrix<float>& placement_attr_c,
+      int seed) const;
 
   // order the vertices based on user-specified parameters
-  void OrderVertices(const HGraphPtr& hgraph, std::vector<int>& vertices) const;
+  void OrderVertices(const HGraphPtr& hgraph,
+                     std::vector<int>& vertices,
+                     int seed) const;
 
   // Similar to the VertexMatching,
   // handle group information
@@ -154,6 +199,11 @@ class Coarsener
       const std::vector<int>& fixed_attr_c,
       const Matrix<float>& placement_attr_c) const;
 
+  // Split [0, num_items) into chunks and run task(begin, end) on each chunk
+  // with the thread pool. Run inline if there is no thread pool.
+  void RunChunks(int num_items,
+                 const std::function<void(int, int)>& task) const;
+
   const int num_parts_ = 2;
   // coarsening related parameters (stop conditions)
 
@@ -184,6 +234,8 @@ class Coarsener
   std::vector<float> thr_cluster_weight_;  // the maximum weight of a cluster
   int random_seed_ = 0;
   CoarsenOrder vertex_order_choice_ = CoarsenOrder::kRandom;
+  CoarsenScheme coarsen_scheme_ = CoarsenScheme::kLazyFirstChoice;
+  ThreadPoolPtr thread_pool_ = nullptr;
   EvaluatorPtr evaluator_ = nullptr;
   par::Logger* logger_ = nullptr;
 };
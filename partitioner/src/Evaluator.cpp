@@ -4,9 +4,9 @@
 #include "Evaluator.h"
 
 #include <algorithm>
+#include <cassert>
 #include <cmath>
 #include <fstream>
-#include <functional>
 #include <iomanip>
 #include <ios>
 #include <limits>
@@ -20,6 +20,7 @@
 
 #include "Hypergraph.h"
 #include "Utilities.h"
+#include "WeightVector.h"
 #include "boost/range/iterator_range_core.hpp"
 #include "utils/Logger.h"
 
@@ -31,6 +32,68 @@ namespace par {
 
 using utl::PAR;
 
+namespace {
+
+// The evaluation splits the vertices, the hyperedges and the paths into
+// chunks of a fixed size. Each chunk produces its own partial sums, which
+// are combined in chunk order, so the floating-point results only depend
+// on the hypergraph (not on the number of threads).
+constexpr int kEvalChunkSize = 4096;
+
+int NumChunks(const int num_items)
+{
+  return (num_items + kEvalChunkSize - 1) / kEvalChunkSize;
+}
+
+int ChunkBegin(const int chunk)
+{
+  return chunk * kEvalChunkSize;
+}
+
+int ChunkEnd(const int chunk, const int num_items)
+{
+  return std::min((chunk + 1) * kEvalChunkSize, num_items);
+}
+
+// true if the vertices of hyperedge e are not all in the same block
+bool IsCutHyperedge(const int e,
+                    const HGraphPtr& hgraph,
+                    const std::vector<int>& solution)
+{
+  const auto range = hgraph->Vertices(e);
+  if (range.empty()) {
+    return false;
+  }
+  const int first_solution = solution[*range.begin()];
+  for (const int vertex_id :
+       boost::make_iterator_range(range.begin() + 1, range.end())) {
+    if (solution[vertex_id] != first_solution) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// the number of cuts on a path, i.e., the number of consecutive vertices
+// in different blocks
+int GetCutsOnPath(const int path_id,
+                  const HGraphPtr& hgraph,
+                  const std::vector<int>& solution)
+{
+  int num_cuts = 0;
+  int prev_block_id = -1;
+  for (const int v : hgraph->PathVertices(path_id)) {
+    const int block_id = solution[v];
+    if (prev_block_id != -1 && block_id != prev_block_id) {
+      num_cuts++;
+    }
+    prev_block_id = block_id;
+  }
+  return num_cuts;
+}
+
+}  // namespace
+
 GoldenEvaluator::GoldenEvaluator(const int num_parts,
                                  const std::vector<float>& e_wt_factors,
                                  const std::vector<float>& v_wt_factors,
@@ -56,30 +119,102 @@ GoldenEvaluator::GoldenEvaluator(const int num_parts,
   logger_ = logger;
 }
 
-// calculate the vertex distribution of each net
-Matrix<int> GoldenEvaluator::GetNetDegrees(const HGraphPtr& hgraph,
-                                           const Partitions& solution) const
+bool GoldenEvaluator::IsValidSolution(const HGraphPtr& hgraph,
+                                      const Partitions& solution) const
 {
-  Matrix<int> net_degs(hgraph->GetNumHyperedges(),
-                       std::vector<int>(num_parts_, 0));
-  for (int e = 0; e < hgraph->GetNumHyperedges(); e++) {
-    for (const int vertex_id : hgraph->Vertices(e)) {
-      net_degs[e][solution[vertex_id]]++;
-    }
+  const int num_vertices = hgraph->GetNumVertices();
+  if (static_cast<int>(solution.size()) != num_vertices) {
+    return false;
   }
-  return net_degs;
+  std::vector<char> chunk_valid(NumChunks(num_vertices), 1);
+  RunTasks(static_cast<int>(chunk_valid.size()), [&](const int chunk) {
+    for (int v = ChunkBegin(chunk); v < ChunkEnd(chunk, num_vertices); v++) {
+      if (solution[v] < 0 || solution[v] >= num_parts_) {
+        chunk_valid[chunk] = 0;
+        return;
+      }
+    }
+  });
+  return std::all_of(
+      chunk_valid.begin(), chunk_valid.end(), [](char valid) { return valid; });
+}
+
+// calculate the vertex distribution of each net
+NetDegrees GoldenEvaluator::GetNetDegrees(const HGraphPtr& hgraph,
+                                          const Partitions& solution) const
+{
+  return NetDegrees(num_parts_, hgraph, solution);
 }
 
 // Get block balance
 Matrix<float> GoldenEvaluator::GetBlockBalance(const HGraphPtr& hgraph,
                                                const Partitions& solution) const
 {
-  Matrix<float> block_balance(
-      num_parts_, std::vector<float>(hgraph->GetVertexDimensions(), 0.0));
-  // update the block_balance
-  for (int v = 0; v < hgraph->GetNumVertices(); v++) {
-    block_balance[solution[v]]
-        = block_balance[solution[v]] + hgraph->GetVertexWeights(v);
+  assert(IsValidSolution(hgraph, solution));
+  const int num_dims = hgraph->GetVertexDimensions();
+  const int num_chunks = NumChunks(hgraph->GetNumVertices());
+  const int chunk_size = num_parts_ * num_dims;
+  std::vector<float> chunk_balance(
+      static_cast<size_t>(num_chunks) * chunk_size, 0.0f);
+  RunTasks(num_chunks, [&](const int chunk) {
+    AccumulateBlockBalance(
+        hgraph, solution, chunk, &chunk_balance[chunk * chunk_size]);
+  });
+  return SumBlockBalance(chunk_balance, num_dims);
+}
+
+void GoldenEvaluator::RunTasks(const int num_tasks,
+                               const std::function<void(int)>& task) const
+{
+  if (thread_pool_ == nullptr || num_tasks <= 1) {
+    for (int i = 0; i < num_tasks; i++) {
+      task(i);
+    }
+    return;
+  }
+  thread_pool_->ParallelFor(num_tasks, task);
+}
+
+void GoldenEvaluator::AccumulateBlockBalance(const HGraphPtr& hgraph,
+                                             const Partitions& solution,
+                                             const int chunk,
+                                             float* balance) const
+{
+  const int num_dims = hgraph->GetVertexDimensions();
+  const int begin = ChunkBegin(chunk);
+  const int end = ChunkEnd(chunk, hgraph->GetNumVertices());
+  // one pass over the flat vertex weights
+  const float* weight = hgraph->GetFlatVertexWeights().data();
+  if (num_dims == 1) {
+    for (int v = begin; v < end; v++) {
+      balance[solution[v]] += weight[v];
+    }
+    return;
+  }
+  weight += static_cast<size_t>(begin) * num_dims;
+  for (int v = begin; v < end; v++) {
+    float* block_balance = balance + solution[v] * num_dims;
+    for (int dim = 0; dim < num_dims; dim++) {
+      block_balance[dim] += weight[dim];
+    }
+    weight += num_dims;
+  }
+}
+
+Matrix<float> GoldenEvaluator::SumBlockBalance(
+    const std::vector<float>& chunk_balance,
+    const int num_dims) const
+{
+  Matrix<float> block_balance(num_parts_, std::vector<float>(num_dims, 0.0));
+  const int chunk_size = num_parts_ * num_dims;
+  for (size_t offset = 0; offset < chunk_balance.size();
+       offset += chunk_size) {
+    for (int block_id = 0; block_id < num_parts_; block_id++) {
+      const float* balance = &chunk_balance[offset + block_id * num_dims];
+      for (int dim = 0; dim < num_dims; dim++) {
+        block_balance[block_id][dim] += balance[dim];
+      }
+    }
   }
   return block_balance;
 }
@@ -116,36 +251,42 @@ float GoldenEvaluator::CalculatePathCost(int path_id,
                "No timing-critical paths when calling CalculatePathsCost()!");
     return 0.0;
   }
-  float cost = 0.0;
-  std::vector<int>
-      path;  // we must use vector here.  Becuase we need to calculate the
-             // snaking factor represent the path in terms of block_id
-  std::map<int, int> block_counter;  // block_id counter
+  std::vector<int> block_counter(num_parts_, 0);
+  return CalculatePathCost(path_id, hgraph, solution, block_counter);
+}
+
+float GoldenEvaluator::CalculatePathCost(int path_id,
+                                         const HGraphPtr& hgraph,
+                                         const Partitions& solution,
+                                         std::vector<int>& block_counter) const
+{
+  // represent the path in terms of block_id: count the number of
+  // segments of the path and the number of segments in each block
+  int num_segments = 0;
+  int prev_block_id = -1;
   for (const int u : hgraph->PathVertices(path_id)) {
     const int block_id = solution[u];
-    if (path.empty() || path.back() != block_id) {
-      path.push_back(block_id);
-      if (block_counter.find(block_id) != block_counter.end()) {
-        block_counter[block_id] += 1;
-      } else {
-        block_counter[block_id] = 1;
-      }
+    if (block_id != prev_block_id) {
+      num_segments++;
+      block_counter[block_id]++;
+      prev_block_id = block_id;
     }
   }
-  // check if the entire path is within the block
-  if (path.size() <= 1) {
-    return cost;  // the path is fully within the block
-  }
-  // timing-related cost (basic path_cost * number of cut on the path)
-  cost = path_timing_factor_ * (path.size() - 1)
-         * hgraph->PathTimingCost(path_id);
   // get the snaking factor of the path (maximum repetition of block_id - 1)
+  // and clear the block_counter
   int snaking_factor = 0;
-  for (auto& [block_id, count] : block_counter) {
-    if (count > snaking_factor) {
-      snaking_factor = count;
-    }
+  for (const int u : hgraph->PathVertices(path_id)) {
+    int& count = block_counter[solution[u]];
+    snaking_factor = std::max(snaking_factor, count);
+    count = 0;
+  }
+  // check if the entire path is within the block
+  if (num_segments <= 1) {
+    return 0.0;  // the path is fully within the block
   }
+  // timing-related cost (basic path_cost * number of cut on the path)
+  float cost = path_timing_factor_ * static_cast<float>(num_segments - 1)
+               * hgraph->PathTimingCost(path_id);
   cost += path_snaking_factor_ * static_cast<float>(snaking_factor - 1);
   return cost;
 }
@@ -186,36 +327,49 @@ PathStats GoldenEvaluator::GetTimingCuts(const HGraphPtr& hgraph,
     return path_stats;
   }
 
-  // Initialize the initial values
-  path_stats.tot_num_path = hgraph->GetNumTimingPaths();
-  for (int i = 0; i < hgraph->GetNumTimingPaths(); ++i) {
-    std::vector<int> block_path;  // It must be a vector
-    for (const int v : hgraph->PathVertices(i)) {
-      const int block_id = solution[v];
-      if (block_path.empty() || block_path.back() != block_id) {
-        block_path.push_back(block_id);
-      }
-    }
-    const int cut_on_path = block_path.size() - 1;
-    float path_slack = hgraph->PathTimingSlack(i);
-    if (path_slack < 0) {  // critical path
-      path_stats.tot_num_critical_path += 1;
-      if (cut_on_path > 0) {
-        path_stats.worst_cut_critical_path
-            = std::max(cut_on_path, path_stats.worst_cut_critical_path);
-        path_stats.avg_cut_critical_path += cut_on_path;
-      }
-    } else {  // noncritical path
-      path_stats.tot_num_noncritical_path += 1;
-      // update the path slack based on extra delay
-      path_slack -= extra_cut_delay_ * cut_on_path;
-      if (path_slack < 0.0f) {
-        path_stats.number_non2critical_path += 1;
-        path_stats.worst_cut_non2critical_path
-            = std::max(cut_on_path, path_stats.worst_cut_non2critical_path);
-        path_stats.avg_cut_non2critical_path += cut_on_path;
+  assert(IsValidSolution(hgraph, solution));
+  // Each chunk of paths collects its own statistics
+  const int num_paths = hgraph->GetNumTimingPaths();
+  std::vector<PathStats> chunk_stats(NumChunks(num_paths));
+  RunTasks(static_cast<int>(chunk_stats.size()), [&](const int chunk) {
+    PathStats& stats = chunk_stats[chunk];
+    for (int i = ChunkBegin(chunk); i < ChunkEnd(chunk, num_paths); ++i) {
+      const int cut_on_path = GetCutsOnPath(i, hgraph, solution);
+      float path_slack = hgraph->PathTimingSlack(i);
+      if (path_slack < 0) {  // critical path
+        stats.tot_num_critical_path += 1;
+        if (cut_on_path > 0) {
+          stats.worst_cut_critical_path
+              = std::max(cut_on_path, stats.worst_cut_critical_path);
+          stats.avg_cut_critical_path += cut_on_path;
+        }
+      } else {  // noncritical path
+        stats.tot_num_noncritical_path += 1;
+        // update the path slack based on extra delay
+        path_slack -= extra_cut_delay_ * cut_on_path;
+        if (path_slack < 0.0f) {
+          stats.number_non2critical_path += 1;
+          stats.worst_cut_non2critical_path
+              = std::max(cut_on_path, stats.worst_cut_non2critical_path);
+          stats.avg_cut_non2critical_path += cut_on_path;
+        }
       }
     }
+  });
+
+  // combine the statistics of the chunks
+  path_stats.tot_num_path = num_paths;
+  for (const PathStats& stats : chunk_stats) {
+    path_stats.tot_num_critical_path += stats.tot_num_critical_path;
+    path_stats.tot_num_noncritical_path += stats.tot_num_noncritical_path;
+    path_stats.worst_cut_critical_path = std::max(
+        path_stats.worst_cut_critical_path, stats.worst_cut_critical_path);
+    path_stats.avg_cut_critical_path += stats.avg_cut_critical_path;
+    path_stats.number_non2critical_path += stats.number_non2critical_path;
+    path_stats.worst_cut_non2critical_path
+        = std::max(path_stats.worst_cut_non2critical_path,
+                   stats.worst_cut_non2critical_path);
+    path_stats.avg_cut_non2critical_path += stats.avg_cut_non2critical_path;
   }
 
   // normalization to calculate average
@@ -416,8 +570,9 @@ float GoldenEvaluator::GetPlacementScore(int v,
                                          int u,
                                          const HGraphPtr& hgraph) const
 {
-  const float dist = norm2(hgraph->GetPlacement(v) - hgraph->GetPlacement(u),
-                           placement_wt_factors_);
+  WeightVector diff(hgraph->GetPlacement(v));
+  diff -= hgraph->GetPlacement(u);
+  const float dist = norm2(diff, placement_wt_factors_);
   if (dist == 0.0) {
     return std::numeric_limits<float>::max() / 2.0;
   }
@@ -438,10 +593,10 @@ GoldenEvaluator::GetAvgPlacementLoc(int v, int u, const HGraphPtr& hgraph) const
 
 // calculate the average placement location
 std::vector<float> GoldenEvaluator::GetAvgPlacementLoc(
-    const std::vector<float>& vertex_weight_a,
-    const std::vector<float>& vertex_weight_b,
-    const std::vector<float>& placement_loc_a,
-    const std::vector<float>& placement_loc_b) const
+    WeightView vertex_weight_a,
+    WeightView vertex_weight_b,
+    WeightView placement_loc_a,
+    WeightView placement_loc_b) const
 {
   const float a_weight = std::inner_product(vertex_weight_a.begin(),
                                             vertex_weight_a.end(),
@@ -532,15 +687,9 @@ std::vector<int> GoldenEvaluator::GetCutHyperedges(
   std::vector<int> cut_hyperedges;
   // check the cutsize
   for (int e = 0; e < hgraph->GetNumHyperedges(); ++e) {
-    const auto range = hgraph->Vertices(e);
-    const int first_solution = solution[*range.begin()];
-    for (const int vertex_id :
-         boost::make_iterator_range(range.begin() + 1, range.end())) {
-      if (solution[vertex_id] != first_solution) {
-        cut_hyperedges.push_back(e);
-        break;  // this net has been cut
-      }
-    }  // finish hyperedge e
+    if (IsCutHyperedge(e, hgraph, solution)) {
+      cut_hyperedges.push_back(e);
+    }
   }
   return cut_hyperedges;
 }
@@ -589,18 +738,61 @@ PartitionToken GoldenEvaluator::CutEvaluator(const HGraphPtr& hgraph,
                                              const std::vector<int>& solution,
                                              bool print_flag) const
 {
-  Matrix<float> block_balance = GetBlockBalance(hgraph, solution);
+  assert(IsValidSolution(hgraph, solution));
+  // One parallel pass over the chunks of the vertices (block balance),
+  // the hyperedges (cutsize) and the paths (path related cost).
+  // The partial results of the chunks are combined in chunk order.
+  const int num_dims = hgraph->GetVertexDimensions();
+  const int num_paths = hgraph->GetTimingPathCostSize()
+                                < hgraph->GetNumTimingPaths()
+                            ? 0
+                            : hgraph->GetNumTimingPaths();
+  const int num_vertex_chunks = NumChunks(hgraph->GetNumVertices());
+  const int num_hyperedge_chunks = NumChunks(hgraph->GetNumHyperedges());
+  const int num_path_chunks = NumChunks(num_paths);
+  const int balance_size = num_parts_ * num_dims;
+  std::vector<float> chunk_balance(
+      static_cast<size_t>(num_vertex_chunks) * balance_size, 0.0f);
+  std::vector<float> chunk_edge_cost(num_hyperedge_chunks, 0.0f);
+  std::vector<float> chunk_path_cost(num_path_chunks, 0.0f);
+  RunTasks(num_vertex_chunks + num_hyperedge_chunks + num_path_chunks,
+           [&](int chunk) {
+             if (chunk < num_vertex_chunks) {
+               AccumulateBlockBalance(hgraph,
+                                      solution,
+                                      chunk,
+                                      &chunk_balance[chunk * balance_size]);
+               return;
+             }
+             chunk -= num_vertex_chunks;
+             if (chunk < num_hyperedge_chunks) {
+               // check the cutsize
+               const int end = ChunkEnd(chunk, hgraph->GetNumHyperedges());
+               for (int e = ChunkBegin(chunk); e < end; e++) {
+                 if (IsCutHyperedge(e, hgraph, solution)) {
+                   chunk_edge_cost[chunk] += CalculateHyperedgeCost(e, hgraph);
+                 }
+               }
+               return;
+             }
+             chunk -= num_hyperedge_chunks;
+             // check path related cost (the path cost has been weighted)
+             std::vector<int> block_counter(num_parts_, 0);
+             const int end = ChunkEnd(chunk, num_paths);
+             for (int path_id = ChunkBegin(chunk); path_id < end; path_id++) {
+               chunk_path_cost[chunk] += CalculatePathCost(
+                   path_id, hgraph, solution, block_counter);
+             }
+           });
+
+  Matrix<float> block_balance = SumBlockBalance(chunk_balance, num_dims);
   float edge_cost = 0.0;
-  float path_cost = 0.0;
-  // check the cutsize
-  std::vector<int> cut_hyperedges = GetCutHyperedges(hgraph, solution);
-  for (auto& e : cut_hyperedges) {
-    edge_cost += CalculateHyperedgeCost(e, hgraph);
+  for (const float chunk_cost : chunk_edge_cost) {
+    edge_cost += chunk_cost;
   }
-  // check path related cost
-  for (int path_id = 0; path_id < hgraph->GetNumTimingPaths(); path_id++) {
-    // the path cost has been weighted
-    path_cost += CalculatePathCost(path_id, hgraph, solution);
+  float path_cost = 0.0;
+  for (const float chunk_cost : chunk_path_cost) {
+    path_cost += chunk_cost;
   }
   const float cost = edge_cost + path_cost;
 
@@ -613,7 +805,7 @@ PartitionToken GoldenEvaluator::CutEvaluator(const HGraphPtr& hgraph,
     for (auto block_id = 0; block_id < num_parts_; block_id++) {
       std::string line
           = "Vertex balance of block_" + std::to_string(block_id) + " : ";
-      for (auto dim = 0; dim < tot_vertex_weights.size(); dim++) {
+      for (size_t dim = 0; dim < tot_vertex_weights.size(); dim++) {
         std::stringstream ss;  // for converting float to string
         ss << std::fixed << std::setprecision(5)
            << block_balance[block_id][dim] / tot_vertex_weights[dim] << "  ( "
@@ -762,77 +954,95 @@ void GoldenEvaluator::UpdateTiming(const HGraphPtr& hgraph,
   }
   */
 
-  // Function < return type (parameter  types) > functionName
   // Propogate the delay
+  // The propagation uses an explicit worklist instead of recursion, so long
+  // chains of combinational cells cannot overflow the stack.
+  // All the hyperedges reached from a cut arc get the slack of the arc, and
+  // a hyperedge is only visited when its slack is decreased. So the set of
+  // updated hyperedges does not depend on the traversal order, and the
+  // result is the same as a recursive depth-first traversal.
+  std::vector<int> worklist;
+
   // Functions 1: propogate forward along critical paths
-  std::function<void(int)> lambda_forward = [&](int e) -> void {
-    const auto& e_slack = timing_arc_slacks[e];
-    // check all the hyperedges connected to sink
-    // for each hyperedge, the first vertex is the source
-    // the remaining vertices are all sinks
-    // It will stop if the sink vertex is a FF or IO
-    for (const int v : timing_graph_->Vertices(e)) {
-      if (timing_graph_->GetVertexType(v) != kCombStdCell) {
-        continue;  // the current vertex is port or seq_std_cell or macro
-      }
-      // find all the hyperedges connected to this hyperedge
-      for (const int next_e : timing_graph_->Edges(v)) {
-        if (timing_arc_slacks[next_e] > e_slack) {
-          timing_arc_slacks[next_e] = e_slack;
-          lambda_forward(next_e);  // propogate forward
+  auto propagate_forward = [&](int arc_id) {
+    const float arc_slack = timing_arc_slacks[arc_id];
+    worklist.clear();
+    worklist.push_back(arc_id);
+    while (!worklist.empty()) {
+      const int e = worklist.back();
+      worklist.pop_back();
+      // check all the hyperedges connected to sink
+      // for each hyperedge, the first vertex is the source
+      // the remaining vertices are all sinks
+      // It will stop if the sink vertex is a FF or IO
+      for (const int v : timing_graph_->Vertices(e)) {
+        if (timing_graph_->GetVertexType(v) != kCombStdCell) {
+          continue;  // the current vertex is port or seq_std_cell or macro
+        }
+        // find all the hyperedges connected to this hyperedge
+        for (const int next_e : timing_graph_->Edges(v)) {
+          if (timing_arc_slacks[next_e] > arc_slack) {
+            timing_arc_slacks[next_e] = arc_slack;
+            worklist.push_back(next_e);  // propogate forward
+          }
         }
       }
     }
   };
 
   // Function 2: propogate backward along critical paths
-  std::function<void(int)> lambda_backward = [&](int e) -> void {
-    const auto& e_slack = timing_arc_slacks[e];
-    // check all the hyperedges connected to sink
-    // for each hyperedge, the first vertex is the source
-    // the remaining vertices are all sinks
-    // It will stop if the src vertex is a FF or IO
-    // ignore single-vertex hyperedge
-    const auto range = timing_graph_->Vertices(e);
-    const int he_size = range.size();
-    if (he_size <= 1) {
-      return;  // this hyperedge (net) is invalid
-    }
-    // get the vertex id of source instance
-    const int src_id = *range.begin();
-    // Stop backward traversing if the current vertex is port or seq_std_cell or
-    // macro
-    if (timing_graph_->GetVertexType(src_id) != kCombStdCell) {
-      return;  // the current vertex is port or seq_std_cell or macro
-    }
-    // find all the hyperedges driving this vertex
-    // find all the hyperedges connected to this hyperedge
-    for (const int pre_e : timing_graph_->Edges(src_id)) {
-      // check if the hyperedge drives src_id
-      const auto pre_e_range = timing_graph_->Vertices(pre_e);
-      const int pre_e_size = pre_e_range.size();
-      if (pre_e_size <= 1) {
-        return;  // this hyperedge (net) is invalid
+  auto propagate_backward = [&](int arc_id) {
+    const float arc_slack = timing_arc_slacks[arc_id];
+    worklist.clear();
+    worklist.push_back(arc_id);
+    while (!worklist.empty()) {
+      const int e = worklist.back();
+      worklist.pop_back();
+      // for each hyperedge, the first vertex is the source
+      // the remaining vertices are all sinks
+      // It will stop if the src vertex is a FF or IO
+      // ignore single-vertex hyperedge
+      const auto range = timing_graph_->Vertices(e);
+      if (range.size() <= 1) {
+        continue;  // this hyperedge (net) is invalid
       }
       // get the vertex id of source instance
-      const int pre_src_id = *pre_e_range.begin();
-      if (pre_src_id == src_id) {
-        continue;  // this hyperedge has been considered in forward propogation
+      const int src_id = *range.begin();
+      // Stop backward traversing if the current vertex is port or
+      // seq_std_cell or macro
+      if (timing_graph_->GetVertexType(src_id) != kCombStdCell) {
+        continue;  // the current vertex is port or seq_std_cell or macro
       }
-      // backward traversing
-      if (timing_arc_slacks[pre_e] > e_slack) {
-        timing_arc_slacks[pre_e] = e_slack;
-        lambda_backward(pre_e);  // propogate backward
+      // find all the hyperedges driving this vertex
+      for (const int pre_e : timing_graph_->Edges(src_id)) {
+        // check if the hyperedge drives src_id
+        const auto pre_e_range = timing_graph_->Vertices(pre_e);
+        if (pre_e_range.size() <= 1) {
+          break;  // this hyperedge (net) is invalid
+        }
+        // get the vertex id of source instance
+        const int pre_src_id = *pre_e_range.begin();
+        if (pre_src_id == src_id) {
+          continue;  // this hyperedge has been considered in forward
+                     // propogation
+        }
+        // backward traversing
+        if (timing_arc_slacks[pre_e] > arc_slack) {
+          timing_arc_slacks[pre_e] = arc_slack;
+          worklist.push_back(pre_e);  // propogate backward
+        }
       }
     }
   };
 
   // propagate the delay
+  // The cut arcs are handled one by one, because the slack of an arc
+  // depends on the propagation from the previous arcs
   for (const auto& e : cut_hyperedges) {
     for (const auto& arc_id : hgraph->GetHyperedgeArcSet(e)) {
       timing_arc_slacks[arc_id] -= extra_cut_delay_;
-      lambda_forward(arc_id);
-      lambda_backward(arc_id);
+      propagate_forward(arc_id);
+      propagate_backward(arc_id);
     }
   }
 
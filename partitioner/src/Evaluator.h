@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
@@ -10,6 +11,8 @@
 #include <vector>
 
 #include "Hypergraph.h"
+#include "NetDegrees.h"
+#include "ThreadPool.h"
 #include "Utilities.h"
 #include "utils/Logger.h"
 
@@ -73,9 +76,21 @@ class GoldenEvaluator
   GoldenEvaluator(GoldenEvaluator&) = delete;
   virtual ~GoldenEvaluator() = default;
 
+  // The threads used to evaluate a solution (CutEvaluator, GetBlockBalance
+  // and GetTimingCuts). The results do not depend on the number of threads.
+  void SetThreadPool(const ThreadPoolPtr& thread_pool)
+  {
+    thread_pool_ = thread_pool;
+  }
+
+  // true if the solution has a block in [0, num_parts) for each vertex.
+  // The evaluation functions below require a valid solution.
+  bool IsValidSolution(const HGraphPtr& hgraph,
+                       const Partitions& solution) const;
+
   // calculate the vertex distribution of each net
-  Matrix<int> GetNetDegrees(const HGraphPtr& hgraph,
-                            const Partitions& solution) const;
+  NetDegrees GetNetDegrees(const HGraphPtr& hgraph,
+                           const Partitions& solution) const;
 
   // Get block balance
   Matrix<float> GetBlockBalance(const HGraphPtr& hgraph,
@@ -145,11 +160,10 @@ class GoldenEvaluator
                                         const HGraphPtr& hgraph) const;
 
   // calculate the average placement location
-  std::vector<float> GetAvgPlacementLoc(
-      const std::vector<float>& vertex_weight_a,
-      const std::vector<float>& vertex_weight_b,
-      const std::vector<float>& placement_loc_a,
-      const std::vector<float>& placement_loc_b) const;
+  std::vector<float> GetAvgPlacementLoc(WeightView vertex_weight_a,
+                                        WeightView vertex_weight_b,
+                                        WeightView placement_loc_a,
+                                        WeightView placement_loc_b) const;
 
   // calculate the hyperedges being cut
   std::vector<int> GetCutHyperedges(const HGraphPtr& hgraph,
@@ -208,6 +222,27 @@ class GoldenEvaluator
                                 const std::string& file_name) const;
 
  private:
+  // Run task(0), ..., task(num_tasks - 1) on the thread pool (if any)
+  void RunTasks(int num_tasks, const std::function<void(int)>& task) const;
+
+  // add the weights of the vertices in the given chunk to balance,
+  // a flat num_parts_ x num_dims matrix
+  void AccumulateBlockBalance(const HGraphPtr& hgraph,
+                              const Partitions& solution,
+                              int chunk,
+                              float* balance) const;
+
+  // sum the flat balances of the chunks in chunk order
+  Matrix<float> SumBlockBalance(const std::vector<float>& chunk_balance,
+                                int num_dims) const;
+
+  // calculate the cost of a path. block_counter has num_parts_ zeros,
+  // and it is cleared again before returning
+  float CalculatePathCost(int path_id,
+                          const HGraphPtr& hgraph,
+                          const Partitions& solution,
+                          std::vector<int>& block_counter) const;
+
   // user specified parameters
   const int num_parts_ = 2;            // number of blocks in the partitioning
   const float extra_cut_delay_ = 1.0;  // the extra delay introduced by a cut
@@ -248,6 +283,7 @@ class GoldenEvaluator
   const float timing_exp_factor_ = 2.0;  // exponential factor
 
   HGraphPtr timing_graph_ = nullptr;
+  ThreadPoolPtr thread_pool_ = nullptr;
   par::Logger* logger_ = nullptr;
 };
 
@@ -0,0 +1,91 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2022-2025, The OpenROAD Authors
+
+#include "GainCache.h"
+
+#include <vector>
+
+#include "Evaluator.h"
+#include "Hypergraph.h"
+#include "NetDegrees.h"
+#include "Utilities.h"
+
+namespace par {
+
+void GainCache::Initialize(const int num_parts,
+                           const HGraphPtr& hgraph,
+                           const NetDegrees& net_degs,
+                           const EvaluatorPtr& evaluator)
+{
+  num_parts_ = num_parts;
+  const int num_vertices = hgraph->GetNumVertices();
+  const int num_hyperedges = hgraph->GetNumHyperedges();
+  hyperedge_cost_.resize(num_hyperedges);
+  benefit_.assign(static_cast<size_t>(num_vertices) * num_parts_, 0.0f);
+  penalty_.assign(num_vertices, 0.0f);
+  for (int e = 0; e < num_hyperedges; e++) {
+    hyperedge_cost_[e] = evaluator->CalculateHyperedgeCost(e, hgraph);
+    const int he_size = hgraph->Vertices(e).size();
+    if (he_size <= 1) {
+      continue;  // single-vertex hyperedge can not be cut
+    }
+    const float cost = hyperedge_cost_[e];
+    for (int block_id = 0; block_id < num_parts_; block_id++) {
+      const int num_v = net_degs.GetPinCount(e, block_id);
+      if (num_v == he_size) {
+        for (const int v : hgraph->Vertices(e)) {
+          penalty_[v] += cost;
+        }
+      } else if (num_v == he_size - 1) {
+        for (const int v : hgraph->Vertices(e)) {
+          benefit_[v * num_parts_ + block_id] += cost;
+        }
+      }
+    }
+  }
+}
+
+void GainCache::MoveVertex(const int v,
+                           const int from_pid,
+                           const int to_pid,
+                           const HGraphPtr& hgraph,
+                           NetDegrees& net_degs)
+{
+  for (const int e : hgraph->Edges(v)) {
+    const int from_deg = net_degs.DecreasePinCount(e, from_pid);
+    const int to_deg = net_degs.IncreasePinCount(e, to_pid);
+    const int he_size = hgraph->Vertices(e).size();
+    if (he_size <= 1) {
+      continue;
+    }
+    const float cost = hyperedge_cost_[e];
+    float delta_penalty = 0.0f;
+    float delta_from_benefit = 0.0f;
+    float delta_to_benefit = 0.0f;
+    // the source block: |e| -> |e| - 1 or |e| - 1 -> |e| - 2
+    if (from_deg == he_size - 1) {
+      delta_penalty -= cost;
+      delta_from_benefit += cost;
+    } else if (from_deg == he_size - 2) {
+      delta_from_benefit -= cost;
+    }
+    // the destination block: |e| - 2 -> |e| - 1 or |e| - 1 -> |e|
+    if (to_deg == he_size) {
+      delta_penalty += cost;
+      delta_to_benefit -= cost;
+    } else if (to_deg == he_size - 1) {
+      delta_to_benefit += cost;
+    }
+    if (delta_penalty == 0.0f && delta_from_benefit == 0.0f
+        && delta_to_benefit == 0.0f) {
+      continue;  // most of the large hyperedges stay cut
+    }
+    for (const int u : hgraph->Vertices(e)) {
+      penalty_[u] += delta_penalty;
+      benefit_[u * num_parts_ + from_pid] += delta_from_benefit;
+      benefit_[u * num_parts_ + to_pid] += delta_to_benefit;
+    }
+  }
+}
+
+}  // namespace par
@@ -0,0 +1,69 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2022-2025, The OpenROAD Authors
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "Evaluator.h"
+#include "Hypergraph.h"
+#include "NetDegrees.h"
+#include "Utilities.h"
+
+namespace par {
+
+// --------------------------------------------------------------------------
+// Gain cache for the cut-related part of the vertex gain.
+// For a vertex v in block from_pid, moving v to block to_pid gives
+//   cut_gain(v, to_pid) = benefit(v, to_pid) - penalty(v)
+// where
+//   benefit(v, b) = sum of cost(e) for all e containing v, such that all the
+//                   other vertices of e are in block b, i.e.,
+//                   net_degs[e][b] == |e| - 1
+//   penalty(v) = sum of cost(e) for all e containing v, such that e is
+//                not cut, i.e., net_degs[e][b] == |e| for some block b
+// This is exactly the cut score calculated by Refiner::CalculateVertexGain.
+// Both terms do not depend on the block of v itself, so after moving a
+// vertex we only need to update the entries of the neighbors through the
+// hyperedges where the net degree of the source block or the destination
+// block crosses |e| - 2, |e| - 1 or |e|.
+// Single-vertex hyperedges never contribute to the cut.
+// --------------------------------------------------------------------------
+class GainCache
+{
+ public:
+  // Build all the entries from scratch based on the current net degrees
+  void Initialize(int num_parts,
+                  const HGraphPtr& hgraph,
+                  const NetDegrees& net_degs,
+                  const EvaluatorPtr& evaluator);
+
+  float GetCutGain(int v, int to_pid) const
+  {
+    return benefit_[v * num_parts_ + to_pid] - penalty_[v];
+  }
+
+  float GetBenefit(int v, int to_pid) const
+  {
+    return benefit_[v * num_parts_ + to_pid];
+  }
+
+  float GetPenalty(int v) const { return penalty_[v]; }
+
+  // Move vertex v from from_pid to to_pid.
+  // Update net_degs and the cached gains of all the affected vertices.
+  void MoveVertex(int v,
+                  int from_pid,
+                  int to_pid,
+                  const HGraphPtr& hgraph,
+                  NetDegrees& net_degs);
+
+ private:
+  int num_parts_ = 0;
+  std::vector<float> hyperedge_cost_;  // cost(e) for each hyperedge
+  std::vector<float> benefit_;         // num_vertices * num_parts
+  std::vector<float> penalty_;         // num_vertices
+};
+
+}  // namespace par
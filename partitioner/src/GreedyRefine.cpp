@@ -4,7 +4,7 @@
 #include "GreedyRefine.h"
 
 #include <memory>
-#include <set>
+#include <utility>
 #include <vector>
 
 #include "Evaluator.h"
@@ -26,49 +26,46 @@ float GreedyRefine::Pass(
     const Matrix<float>& upper_block_balance,
     const Matrix<float>& lower_block_balance,
     Matrix<float>& block_balance,        // the current block balance
-    Matrix<int>& net_degs,               // the current net degree
+    NetDegrees& net_degs,                // the current net degree
+    GainCache& gain_cache,               // the cached cut gain
     std::vector<float>& cur_paths_cost,  // the current path cost
     Partitions& solution,
-    std::vector<bool>& visited_vertices_flag)
+    std::vector<bool>& visited_vertices_flag,
+    const int max_move)
 {
   float total_gain = 0.0;  // total gain improvement
   int num_move = 0;
   for (int hyperedge_id = 0; hyperedge_id < hgraph->GetNumHyperedges();
        hyperedge_id++) {
     // check if the hyperedge is a straddled_hyperedge
-    std::set<int> block_set;
-    for (int block_id = 0; block_id < num_parts_; block_id++) {
-      if (net_degs[hyperedge_id][block_id] > 0) {
-        block_set.insert(block_id);
-      }
-    }
     // ignore the hyperedge if it's fully within one block
-    if (block_set.size() <= 1) {
+    if (net_degs.IsCut(hyperedge_id) == false) {
       continue;
     }
     // updated the iteration
     num_move++;
-    if (num_move >= max_move_) {
+    if (num_move >= max_move) {
       return total_gain;
     }
     // find the best candidate block
     // the initialization of best_gain is 0.0
-    // define a lambda function to compare two HyperedgeGainPtr (>=)
+    // define a lambda function to compare two HyperedgeGain (>=)
     auto compare_hyperedge_gain
-        = [&](const HyperedgeGainPtr& a, const HyperedgeGainPtr& b) {
-            if (a->GetGain() > b->GetGain()) {
+        = [&](const HyperedgeGain& a, const HyperedgeGain& b) {
+            if (a.GetGain() > b.GetGain()) {
               return true;
             }
             // break ties based on vertex weight summation of
             // the hyperedge
-            return a->GetGain() == b->GetGain()
+            return a.GetGain() == b.GetGain()
                    && evaluator_->CalculateHyperedgeVertexWtSum(
-                          a->GetHyperedge(), hgraph)
+                          a.GetHyperedge(), hgraph)
                           < evaluator_->CalculateHyperedgeVertexWtSum(
-                              b->GetHyperedge(), hgraph);
+                              b.GetHyperedge(), hgraph);
           };
 
-    std::shared_ptr<HyperedgeGain> best_gain_hyperedge;
+    // the dummy hyperedge gain has no destination block
+    HyperedgeGain best_gain_hyperedge;
     for (int to_pid = 0; to_pid < num_parts_; to_pid++) {
       if (CheckHyperedgeMoveLegality(hyperedge_id,
                                      to_pid,
@@ -78,25 +75,32 @@ float GreedyRefine::Pass(
                                      upper_block_balance,
                                      lower_block_balance)
           == true) {
-        HyperedgeGainPtr gain_hyperedge = CalculateHyperedgeGain(
-            hyperedge_id, to_pid, hgraph, solution, cur_paths_cost, net_degs);
-        if (!best_gain_hyperedge
+        HyperedgeGain gain_hyperedge
+            = CalculateHyperedgeGain(hyperedge_id,
+                                     to_pid,
+                                     hgraph,
+                                     solution,
+                                     cur_paths_cost,
+                                     net_degs,
+                                     gain_cache);
+        if (best_gain_hyperedge.GetDestinationPart() == -1
             || compare_hyperedge_gain(gain_hyperedge, best_gain_hyperedge)) {
-          best_gain_hyperedge = gain_hyperedge;
+          best_gain_hyperedge = std::move(gain_hyperedge);
         }
       }
     }
 
     // We only accept positive move
-    if (best_gain_hyperedge && best_gain_hyperedge->GetDestinationPart() > -1
-        && best_gain_hyperedge->GetGain() >= 0.0f) {
+    if (best_gain_hyperedge.GetDestinationPart() > -1
+        && best_gain_hyperedge.GetGain() >= 0.0f) {
       AcceptHyperedgeGain(best_gain_hyperedge,
                           hgraph,
                           total_gain,
                           solution,
                           cur_paths_cost,
                           block_balance,
-                          net_degs);
+                          net_degs,
+                          gain_cache);
     }
   }
 
@@ -4,159 +4,248 @@
 #include "Hypergraph.h"
 
 #include <algorithm>
+#include <atomic>
+#include <functional>
 #include <limits>
-#include <set>
+#include <utility>
 #include <vector>
 
+#include "ThreadPool.h"
 #include "Utilities.h"
 #include "utils/Logger.h"
 
 namespace par {
 
-Hypergraph::Hypergraph(
-    const int vertex_dimensions,
-    const int hyperedge_dimensions,
-    const int placement_dimensions,
-    const std::vector<std::vector<int>>& hyperedges,
-    const std::vector<std::vector<float>>& vertex_weights,
-    const std::vector<std::vector<float>>& hyperedge_weights,
-    // fixed vertices
-    const std::vector<int>& fixed_attr,  // the block id of fixed vertices.
-    // community attribute
-    const std::vector<int>& community_attr,
-    // placement information
-    const std::vector<std::vector<float>>& placement_attr,
-    par::Logger* logger)
-    : num_vertices_(static_cast<int>(vertex_weights.size())),
-      num_hyperedges_(static_cast<int>(hyperedge_weights.size())),
-      vertex_dimensions_(vertex_dimensions),
-      hyperedge_dimensions_(hyperedge_dimensions),
-      vertex_weights_(vertex_weights),
-      hyperedge_weights_(hyperedge_weights)
-{
-  // add hyperedge
-  // hyperedges: each hyperedge is a set of vertices
-  eptr_.push_back(0);
-  for (const auto& hyperedge : hyperedges) {
-    eind_.insert(eind_.end(), hyperedge.begin(), hyperedge.end());
-    eptr_.push_back(static_cast<int>(eind_.size()));
-  }
-
-  // add vertex
-  // create vertices from hyperedges
-  std::vector<std::vector<int>> vertices(num_vertices_);
-  for (int e = 0; e < num_hyperedges_; e++) {
-    for (auto v : hyperedges[e]) {
-      vertices[v].push_back(e);  // e is the hyperedge id
-    }
-  }
-
-  vptr_.push_back(0);
-  for (const auto& vertex : vertices) {
-    vind_.insert(vind_.end(), vertex.begin(), vertex.end());
-    vptr_.push_back(static_cast<int>(vind_.size()));
+namespace {
+
+Matrix<float> UnflattenRows(const std::vector<float>& flat, int dimensions)
+{
+  Matrix<float> matrix;
+  if (dimensions <= 0) {
+    return matrix;
   }
+  matrix.reserve(flat.size() / dimensions);
+  for (auto row = flat.begin(); row != flat.end(); row += dimensions) {
+    matrix.emplace_back(row, row + dimensions);
+  }
+  return matrix;
+}
+
+// Run task(first, last) on the chunks of [0, num_items)
+void ParallelChunks(ThreadPool& thread_pool,
+                    const int num_items,
+                    const std::function<void(int, int)>& task)
+{
+  const int kChunkSize = 4096;
+  const int num_chunks = (num_items + kChunkSize - 1) / kChunkSize;
+  thread_pool.ParallelFor(num_chunks, [&](const int chunk) {
+    task(chunk * kChunkSize, std::min((chunk + 1) * kChunkSize, num_items));
+  });
+}
+
+}  // namespace
+
+Hypergraph::Hypergraph(HypergraphBuilder&& builder,
+                       ThreadPool* thread_pool,
+                       par::Logger* logger)
+    : num_vertices_(builder.vertex_dimensions > 0
+                        ? static_cast<int>(builder.vertex_weights.size()
+                                           / builder.vertex_dimensions)
+                        : 0),
+      num_hyperedges_(static_cast<int>(builder.eptr.size()) - 1),
+      vertex_dimensions_(builder.vertex_dimensions),
+      hyperedge_dimensions_(builder.hyperedge_dimensions),
+      vertex_weights_(std::move(builder.vertex_weights)),
+      hyperedge_weights_(std::move(builder.hyperedge_weights)),
+      eind_(std::move(builder.eind)),
+      eptr_(std::move(builder.eptr)),
+      logger_(logger)
+{
+  BuildVertexIncidence(thread_pool);
 
   // fixed vertices
-  fixed_vertex_flag_ = (fixed_attr.size() == num_vertices_);
+  fixed_vertex_flag_
+      = (builder.fixed_attr.size() == static_cast<size_t>(num_vertices_));
   if (fixed_vertex_flag_) {
-    fixed_attr_ = fixed_attr;
+    fixed_attr_ = std::move(builder.fixed_attr);
   }
 
   // community information
-  community_flag_ = (community_attr.size() == num_vertices_);
+  community_flag_
+      = (builder.community_attr.size() == static_cast<size_t>(num_vertices_));
   if (community_flag_) {
-    community_attr_ = community_attr;
+    community_attr_ = std::move(builder.community_attr);
   }
 
   // placement information
-  placement_flag_
-      = (placement_dimensions > 0 && placement_attr.size() == num_vertices_);
+  placement_flag_ = (builder.placement_dimensions > 0
+                     && builder.placement_attr.size()
+                            == static_cast<size_t>(num_vertices_)
+                                   * builder.placement_dimensions);
   if (placement_flag_) {
-    placement_dimensions_ = placement_dimensions;
-    placement_attr_ = placement_attr;
+    placement_dimensions_ = builder.placement_dimensions;
+    placement_attr_ = std::move(builder.placement_attr);
   } else {
     placement_dimensions_ = 0;
   }
 
-  logger_ = logger;
-}
-
-Hypergraph::Hypergraph(
-    const int vertex_dimensions,
-    const int hyperedge_dimensions,
-    const int placement_dimensions,
-    const std::vector<std::vector<int>>& hyperedges,
-    const std::vector<std::vector<float>>& vertex_weights,
-    const std::vector<std::vector<float>>& hyperedge_weights,
-    // fixed vertices
-    const std::vector<int>& fixed_attr,  // the block id of fixed vertices.
-    // community attribute
-    const std::vector<int>& community_attr,
-    // placement information
-    const std::vector<std::vector<float>>& placement_attr,
-    // the type of each vertex
-    const std::vector<VertexType>&
-        vertex_types,  // except the original timing graph,
-                       // users do not need to specify this
-    // slack information
-    const std::vector<float>& hyperedges_slack,
-    const std::vector<std::set<int>>& hyperedges_arc_set,
-    const std::vector<TimingPath>& timing_paths,
-    par::Logger* logger)
-    : Hypergraph(vertex_dimensions,
-                 hyperedge_dimensions,
-                 placement_dimensions,
-                 hyperedges,
-                 vertex_weights,
-                 hyperedge_weights,
-                 fixed_attr,
-                 community_attr,
-                 placement_attr,
-                 logger)
+  SetTimingInformation(std::move(builder.vertex_types),
+                       std::move(builder.hyperedges_slack),
+                       std::move(builder.arc_ind),
+                       std::move(builder.arc_ptr),
+                       std::move(builder.timing_paths));
+}
+
+HGraphPtr HypergraphBuilder::Build(Logger* logger, ThreadPool* thread_pool)
+{
+  return std::make_shared<Hypergraph>(std::move(*this), thread_pool, logger);
+}
+
+// create vertices from hyperedges.
+// The hyperedges of each vertex are sorted in increasing order.
+// With a thread pool, this is a parallel counting sort: the degrees are
+// counted with atomic increments, the pins are scattered to their vertices
+// in any order, and then the hyperedges of each vertex are sorted, so the
+// result does not depend on the number of threads.
+void Hypergraph::BuildVertexIncidence(ThreadPool* thread_pool)
+{
+  const int kMinParallelPins = 1 << 16;
+  vptr_.assign(num_vertices_ + 1, 0);
+  vind_.resize(eind_.size());
+  if (thread_pool == nullptr || thread_pool->GetNumThreads() <= 1
+      || static_cast<int>(eind_.size()) < kMinParallelPins) {
+    for (const int v : eind_) {
+      vptr_[v + 1]++;
+    }
+    for (int v = 0; v < num_vertices_; v++) {
+      vptr_[v + 1] += vptr_[v];
+    }
+    std::vector<int> next_pin(vptr_.begin(), vptr_.end() - 1);
+    for (int e = 0; e < num_hyperedges_; e++) {
+      for (int idx = eptr_[e]; idx < eptr_[e + 1]; idx++) {
+        vind_[next_pin[eind_[idx]]++] = e;  // e is the hyperedge id
+      }
+    }
+    return;
+  }
+
+  // the degree of each vertex, then the next free slot of each vertex
+  std::vector<std::atomic<int>> next_pin(num_vertices_);
+  ParallelChunks(*thread_pool, num_hyperedges_, [&](int first, int last) {
+    for (int idx = eptr_[first]; idx < eptr_[last]; idx++) {
+      next_pin[eind_[idx]].fetch_add(1, std::memory_order_relaxed);
+    }
+  });
+  for (int v = 0; v < num_vertices_; v++) {
+    vptr_[v + 1] = vptr_[v] + next_pin[v].load(std::memory_order_relaxed);
+  }
+  ParallelChunks(*thread_pool, num_vertices_, [&](int first, int last) {
+    for (int v = first; v < last; v++) {
+      next_pin[v].store(vptr_[v], std::memory_order_relaxed);
+    }
+  });
+  ParallelChunks(*thread_pool, num_hyperedges_, [&](int first, int last) {
+    for (int e = first; e < last; e++) {
+      for (int idx = eptr_[e]; idx < eptr_[e + 1]; idx++) {
+        const int slot
+            = next_pin[eind_[idx]].fetch_add(1, std::memory_order_relaxed);
+        vind_[slot] = e;
+      }
+    }
+  });
+  ParallelChunks(*thread_pool, num_vertices_, [&](int first, int last) {
+    for (int v = first; v < last; v++) {
+      std::sort(vind_.begin() + vptr_[v], vind_.begin() + vptr_[v + 1]);
+    }
+  });
+}
+
+void TimingPathStore::Append(const TimingPathStore& other)
+{
+  const int vind_offset = vptr.back();
+  const int eind_offset = eptr.back();
+  vind.insert(vind.end(), other.vind.begin(), other.vind.end());
+  eind.insert(eind.end(), other.eind.begin(), other.eind.end());
+  for (int path_id = 0; path_id < other.size(); path_id++) {
+    vptr.push_back(vind_offset + other.vptr[path_id + 1]);
+    eptr.push_back(eind_offset + other.eptr[path_id + 1]);
+  }
+  slacks.insert(slacks.end(), other.slacks.begin(), other.slacks.end());
+}
+
+void Hypergraph::SetTimingInformation(
+    std::vector<VertexType>&& vertex_types,
+    std::vector<float>&& hyperedges_slack,
+    std::vector<int>&& arc_ind,
+    std::vector<int>&& arc_ptr,
+    TimingPathStore&& timing_paths)
 {
   // add vertex types
-  vertex_types_ = vertex_types;
+  vertex_types_ = std::move(vertex_types);
 
   // slack information
-  if (hyperedges_slack.size() == num_hyperedges_
-      && hyperedges_arc_set.size() == num_hyperedges_) {
+  if (hyperedges_slack.size() == static_cast<size_t>(num_hyperedges_)
+      && arc_ptr.size() == static_cast<size_t>(num_hyperedges_) + 1) {
     timing_flag_ = true;
-    num_timing_paths_ = static_cast<int>(timing_paths.size());
-    hyperedge_timing_attr_ = hyperedges_slack;
-    hyperedge_arc_set_ = hyperedges_arc_set;
+    num_timing_paths_ = timing_paths.size();
+    hyperedge_timing_attr_ = std::move(hyperedges_slack);
+    arc_ind_ = std::move(arc_ind);
+    arc_ptr_ = std::move(arc_ptr);
+    // the paths are already in CSR format
+    vind_p_ = std::move(timing_paths.vind);
+    vptr_p_ = std::move(timing_paths.vptr);
+    eind_p_ = std::move(timing_paths.eind);
+    eptr_p_ = std::move(timing_paths.eptr);
+    path_timing_attr_ = std::move(timing_paths.slacks);
     // create the vertex Matrix which stores the paths incident to vertex
-    std::vector<std::vector<int>> incident_paths(num_vertices_);
-    vptr_p_.push_back(0);
-    eptr_p_.push_back(0);
+    // (counting sort, so the paths of each vertex are in increasing order)
+    pptr_v_.assign(num_vertices_ + 1, 0);
+    for (const int v : vind_p_) {
+      pptr_v_[v + 1]++;
+    }
+    for (int v = 0; v < num_vertices_; v++) {
+      pptr_v_[v + 1] += pptr_v_[v];
+    }
+    pind_v_.resize(vind_p_.size());
+    std::vector<int> slot(pptr_v_.begin(), pptr_v_.end() - 1);
     for (int path_id = 0; path_id < num_timing_paths_; path_id++) {
-      // view each path as a sequence of vertices
-      const auto& timing_path = timing_paths[path_id].path;
-      vind_p_.insert(vind_p_.end(), timing_path.begin(), timing_path.end());
-      vptr_p_.push_back(static_cast<int>(vind_p_.size()));
-      for (const int v : timing_path) {
-        incident_paths[v].push_back(path_id);
+      for (int idx = vptr_p_[path_id]; idx < vptr_p_[path_id + 1]; idx++) {
+        pind_v_[slot[vind_p_[idx]]++] = path_id;
       }
-      // view each path as a sequence of hyperedge
-      const auto& timing_arc = timing_paths[path_id].arcs;
-      eind_p_.insert(eind_p_.end(), timing_arc.begin(), timing_arc.end());
-      eptr_p_.push_back(static_cast<int>(eind_p_.size()));
-      // add the timing attribute
-      path_timing_attr_.push_back(timing_paths[path_id].slack);
-    }
-    pptr_v_.push_back(0);
-    for (auto& paths : incident_paths) {
-      pind_v_.insert(pind_v_.end(), paths.begin(), paths.end());
-      pptr_v_.push_back(static_cast<int>(pind_v_.size()));
     }
   }
 }
 
+void Hypergraph::CopyVertexWeights(Matrix<float>& weights) const
+{
+  weights = UnflattenRows(vertex_weights_, vertex_dimensions_);
+}
+
+void Hypergraph::CopyPlacement(Matrix<float>& attr) const
+{
+  attr = UnflattenRows(placement_attr_, placement_dimensions_);
+}
+
+// One pass over the flat weights. The values are added vertex by vertex,
+// so the totals do not depend on the storage.
 std::vector<float> Hypergraph::GetTotalVertexWeights() const
 {
   std::vector<float> total_weight(vertex_dimensions_, 0.0);
-  for (auto& weight : vertex_weights_) {
-    total_weight = total_weight + weight;
+  if (vertex_dimensions_ == 1) {
+    float total = 0.0;
+    for (const float weight : vertex_weights_) {
+      total += weight;
+    }
+    total_weight[0] = total;
+    return total_weight;
+  }
+  float* total = total_weight.data();
+  const float* weight = vertex_weights_.data();
+  for (int v = 0; v < num_vertices_; v++) {
+    for (int dim = 0; dim < vertex_dimensions_; dim++) {
+      total[dim] += weight[dim];
+    }
+    weight += vertex_dimensions_;
   }
   return total_weight;
 }
@@ -166,15 +255,14 @@ std::vector<std::vector<float>> Hypergraph::GetUpperVertexBalance(
     float ub_factor,
     std::vector<float> base_balance) const
 {
-  std::vector<float> vertex_balance = GetTotalVertexWeights();
-  for (auto& value : base_balance) {
-    value += ub_factor * 0.01;
-  }
-  std::vector<std::vector<float>> upper_block_balance(num_parts,
-                                                      vertex_balance);
+  const std::vector<float> vertex_balance = GetTotalVertexWeights();
+  std::vector<std::vector<float>> upper_block_balance(
+      num_parts, std::vector<float>(vertex_dimensions_));
   for (int i = 0; i < num_parts; i++) {
-    upper_block_balance[i]
-        = MultiplyFactor(upper_block_balance[i], base_balance[i]);
+    const float factor = base_balance[i] + ub_factor * 0.01;
+    for (int dim = 0; dim < vertex_dimensions_; dim++) {
+      upper_block_balance[i][dim] = vertex_balance[dim] * factor;
+    }
   }
   return upper_block_balance;
 }
@@ -184,26 +272,56 @@ std::vector<std::vector<float>> Hypergraph::GetLowerVertexBalance(
     float ub_factor,
     std::vector<float> base_balance) const
 {
-  std::vector<float> vertex_balance = GetTotalVertexWeights();
-  for (auto& value : base_balance) {
-    value -= ub_factor * 0.01;
-    if (value <= 0.0) {
-      value = 0.0;
-    }
-  }
-  std::vector<std::vector<float>> lower_block_balance(num_parts,
-                                                      vertex_balance);
+  const std::vector<float> vertex_balance = GetTotalVertexWeights();
+  std::vector<std::vector<float>> lower_block_balance(
+      num_parts, std::vector<float>(vertex_dimensions_));
   for (int i = 0; i < num_parts; i++) {
-    lower_block_balance[i]
-        = MultiplyFactor(lower_block_balance[i], base_balance[i]);
+    float factor = base_balance[i] - ub_factor * 0.01;
+    if (factor <= 0.0) {
+      factor = 0.0;
+    }
+    for (int dim = 0; dim < vertex_dimensions_; dim++) {
+      lower_block_balance[i][dim] = vertex_balance[dim] * factor;
+    }
   }
   return lower_block_balance;
 }
 
-void Hypergraph::ResetVertexCAttr()
+// The vertices of each cluster are sorted by counting sort
+void Hypergraph::SetVertexCAttr(std::vector<int>&& parents)
+{
+  vertex_parents_ = std::move(parents);
+  vptr_c_.assign(num_vertices_ + 1, 0);
+  for (const int c : vertex_parents_) {
+    vptr_c_[c + 1]++;
+  }
+  for (int c = 0; c < num_vertices_; c++) {
+    vptr_c_[c + 1] += vptr_c_[c];
+  }
+  vind_c_.resize(vertex_parents_.size());
+  std::vector<int> next_slot(vptr_c_.begin(), vptr_c_.end() - 1);
+  for (int v = 0; v < static_cast<int>(vertex_parents_.size()); v++) {
+    vind_c_[next_slot[vertex_parents_[v]]++] = v;
+  }
+}
+
+void Hypergraph::ProjectSolution(const std::vector<int>& solution,
+                                 std::vector<int>& fine_solution) const
+{
+  fine_solution.resize(vertex_parents_.size());
+  for (size_t v = 0; v < vertex_parents_.size(); v++) {
+    fine_solution[v] = solution[vertex_parents_[v]];
+  }
+}
+
+int Hypergraph::FindInvalidFixedVertex(const int num_parts) const
 {
-  vertex_c_attr_.clear();
-  vertex_c_attr_.resize(GetNumVertices());
+  for (int v = 0; v < static_cast<int>(fixed_attr_.size()); v++) {
+    if (fixed_attr_[v] < -1 || fixed_attr_[v] >= num_parts) {
+      return v;
+    }
+  }
+  return -1;
 }
 
 void Hypergraph::ResetHyperedgeTimingAttr()
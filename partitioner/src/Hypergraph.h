@@ -14,7 +14,6 @@
 ////////////////////////////////////////////////////////////////////////////////
 #pragma once
 #include <memory>
-#include <set>
 #include <vector>
 
 #include "Utilities.h"
@@ -27,6 +26,7 @@ namespace par {
 
 class Hypergraph;
 using HGraphPtr = std::shared_ptr<Hypergraph>;
+class ThreadPool;
 
 // The data structure for critical timing path
 // A timing path is a sequence of vertices, for example, a -> b -> c -> d
@@ -52,51 +52,97 @@ struct TimingPath
   }
 };
 
+// The critical timing paths in CSR format, i.e., the same layout as
+// the paths stored in Hypergraph. The vertices of path p are
+// vind[vptr[p]], ..., vind[vptr[p + 1] - 1], and the hyperedges of path p
+// are eind[eptr[p]], ..., eind[eptr[p + 1] - 1].
+struct TimingPathStore
+{
+  std::vector<int> vind;
+  std::vector<int> vptr{0};
+  std::vector<int> eind;
+  std::vector<int> eptr{0};
+  std::vector<float> slacks;  // slack of each path
+
+  int size() const { return static_cast<int>(slacks.size()); }
+  bool empty() const { return slacks.empty(); }
+
+  template <typename VRange, typename ERange>
+  void AddPath(const VRange& path, const ERange& arcs, float slack)
+  {
+    vind.insert(vind.end(), path.begin(), path.end());
+    vptr.push_back(static_cast<int>(vind.size()));
+    eind.insert(eind.end(), arcs.begin(), arcs.end());
+    eptr.push_back(static_cast<int>(eind.size()));
+    slacks.push_back(slack);
+  }
+
+  // append all the paths in other
+  void Append(const TimingPathStore& other);
+
+  auto PathVertices(int path_id) const
+  {
+    auto begin_iter = vind.cbegin();
+    return boost::make_iterator_range(begin_iter + vptr[path_id],
+                                      begin_iter + vptr[path_id + 1]);
+  }
+
+  auto PathEdges(int path_id) const
+  {
+    auto begin_iter = eind.cbegin();
+    return boost::make_iterator_range(begin_iter + eptr[path_id],
+                                      begin_iter + eptr[path_id + 1]);
+  }
+};
+
+// The arrays of a hypergraph, which are moved into the hypergraph by Build().
+// The hyperedges are in CSR format (see Hypergraph::Vertices), and the
+// weights and the placement are flat arrays, i.e., vertex_dimensions
+// values per vertex, hyperedge_dimensions values per hyperedge and
+// placement_dimensions values per vertex. The optional attributes are not
+// used if they are empty, and the timing information is used if there is
+// one slack per hyperedge and arc_ptr has num_hyperedges + 1 entries.
+// The timing arcs of hyperedge e are arc_ind[arc_ptr[e]], ...,
+// arc_ind[arc_ptr[e + 1] - 1], sorted and without duplicates.
+// This is the only way to create a hypergraph: no full-size copy is made,
+// and the vertex -> hyperedge incidence can be built in parallel.
+struct HypergraphBuilder
+{
+  int vertex_dimensions = 1;
+  int hyperedge_dimensions = 1;
+  int placement_dimensions = 0;
+  std::vector<int> eind;
+  std::vector<int> eptr{0};
+  std::vector<float> vertex_weights;
+  std::vector<float> hyperedge_weights;
+  std::vector<int> fixed_attr;
+  std::vector<int> community_attr;
+  std::vector<float> placement_attr;
+  std::vector<VertexType> vertex_types;
+  std::vector<float> hyperedges_slack;
+  std::vector<int> arc_ind;
+  std::vector<int> arc_ptr;
+  TimingPathStore timing_paths;
+
+  // Create the hypergraph. The arrays are moved, i.e., the builder cannot
+  // be used again.
+  // thread_pool (if not null) builds the vertex -> hyperedge incidence.
+  HGraphPtr Build(Logger* logger, ThreadPool* thread_pool = nullptr);
+};
+
 // Here we use Hypergraph class because the Hypegraph class
 // has been used by other programs.
 class Hypergraph
 {
  public:
-  Hypergraph(
-      int vertex_dimensions,
-      int hyperedge_dimensions,
-      int placement_dimensions,
-      const std::vector<std::vector<int>>& hyperedges,
-      const std::vector<std::vector<float>>& vertex_weights,
-      const std::vector<std::vector<float>>& hyperedge_weights,
-      // fixed vertices
-      const std::vector<int>& fixed_attr,  // the block id of fixed vertices.
-      // community attribute
-      const std::vector<int>& community_attr,
-      // placement information
-      const std::vector<std::vector<float>>& placement_attr,
-      par::Logger* logger);
-
-  Hypergraph(
-      int vertex_dimensions,
-      int hyperedge_dimensions,
-      int placement_dimensions,
-      const std::vector<std::vector<int>>& hyperedges,
-      const std::vector<std::vector<float>>& vertex_weights,
-      const std::vector<std::vector<float>>& hyperedge_weights,
-      // fixed vertices
-      const std::vector<int>& fixed_attr,  // the block id of fixed vertices.
-      // community attribute
-      const std::vector<int>& community_attr,
-      // placement information
-      const std::vector<std::vector<float>>& placement_attr,
-      // the type of each vertex
-      const std::vector<VertexType>&
-          vertex_types,  // except the original timing graph, users do not need
-                         // to specify this
-      // slack information
-      const std::vector<float>& hyperedges_slack,
-      const std::vector<std::set<int>>& hyperedges_arc_set,
-      const std::vector<TimingPath>& timing_paths,
-      par::Logger* logger);
+  // Take the arrays of builder, see HypergraphBuilder::Build
+  Hypergraph(HypergraphBuilder&& builder,
+             ThreadPool* thread_pool,
+             par::Logger* logger);
 
   int GetNumVertices() const { return num_vertices_; }
   int GetNumHyperedges() const { return num_hyperedges_; }
+  int GetNumPins() const { return static_cast<int>(eind_.size()); }
   int GetNumTimingPaths() const { return num_timing_paths_; }
   int GetVertexDimensions() const { return vertex_dimensions_; }
   int GetHyperedgeDimensions() const { return hyperedge_dimensions_; }
@@ -104,15 +150,35 @@ class Hypergraph
 
   std::vector<float> GetTotalVertexWeights() const;
 
-  const std::vector<float>& GetVertexWeights(const int vertex_id) const
+  WeightView GetVertexWeights(const int vertex_id) const
   {
-    return vertex_weights_[vertex_id];
+    return WeightView(
+        vertex_weights_.data()
+            + static_cast<size_t>(vertex_id) * vertex_dimensions_,
+        vertex_dimensions_);
   }
-  const Matrix<float>& GetVertexWeights() const { return vertex_weights_; }
 
-  const std::vector<float>& GetHyperedgeWeights(const int edge_id) const
+  // the weights of all the vertices, vertex_dimensions_ values per vertex
+  const std::vector<float>& GetFlatVertexWeights() const
   {
-    return hyperedge_weights_[edge_id];
+    return vertex_weights_;
+  }
+
+  void CopyVertexWeights(Matrix<float>& weights) const;
+
+  WeightView GetHyperedgeWeights(const int edge_id) const
+  {
+    return WeightView(
+        hyperedge_weights_.data()
+            + static_cast<size_t>(edge_id) * hyperedge_dimensions_,
+        hyperedge_dimensions_);
+  }
+
+  // the weights of all the hyperedges, hyperedge_dimensions_ values per
+  // hyperedge
+  const std::vector<float>& GetFlatHyperedgeWeights() const
+  {
+    return hyperedge_weights_;
   }
 
   float GetHyperedgeTimingAttr(const int edge_id) const
@@ -152,21 +218,33 @@ class Hypergraph
     hyperedge_timing_cost_ = costs;
   }
 
-  void ResetVertexCAttr();
+  // Set the clusters of the vertices of the finer hypergraph,
+  // i.e., parents[v] is the vertex of this hypergraph which contains
+  // vertex v of the finer hypergraph
+  void SetVertexCAttr(std::vector<int>&& parents);
 
-  void AddVertexCAttr(int vertex_id, int v)
+  // Returns the vertices of the finer hypergraph in the given cluster
+  // (in increasing order)
+  auto GetVertexCAttr(const int vertex_id) const
   {
-    vertex_c_attr_[vertex_id].push_back(v);
+    auto begin_iter = vind_c_.cbegin();
+    return boost::make_iterator_range(begin_iter + vptr_c_[vertex_id],
+                                      begin_iter + vptr_c_[vertex_id + 1]);
   }
 
-  const std::vector<int>& GetVertexCAttr(int vertex_id) const
-  {
-    return vertex_c_attr_[vertex_id];
-  }
+  const std::vector<int>& GetVertexParents() const { return vertex_parents_; }
+
+  // Map the solution of this hypergraph to the finer hypergraph,
+  // i.e., fine_solution[v] = solution[parents[v]]
+  void ProjectSolution(const std::vector<int>& solution,
+                       std::vector<int>& fine_solution) const;
 
-  const std::set<int>& GetHyperedgeArcSet(const int edge_id) const
+  // Returns the timing arcs of the hyperedge (in increasing order)
+  auto GetHyperedgeArcSet(const int edge_id) const
   {
-    return hyperedge_arc_set_[edge_id];
+    auto begin_iter = arc_ind_.cbegin();
+    return boost::make_iterator_range(begin_iter + arc_ptr_[edge_id],
+                                      begin_iter + arc_ptr_[edge_id + 1]);
   }
 
   bool HasFixedVertices() const { return fixed_vertex_flag_; }
@@ -177,6 +255,10 @@ class Hypergraph
 
   void CopyFixedAttr(std::vector<int>& attr) const { attr = fixed_attr_; }
 
+  // the first vertex whose fixed block is not in [-1, num_parts)
+  // (-1: not fixed), or -1 if all the fixed blocks are valid
+  int FindInvalidFixedVertex(int num_parts) const;
+
   VertexType GetVertexType(const int vertex_id) const
   {
     return vertex_types_[vertex_id];
@@ -201,12 +283,22 @@ class Hypergraph
 
   bool HasTiming() const { return timing_flag_; }
 
-  const std::vector<float>& GetPlacement(const int vertex_id) const
+  WeightView GetPlacement(const int vertex_id) const
+  {
+    return WeightView(
+        placement_attr_.data()
+            + static_cast<size_t>(vertex_id) * placement_dimensions_,
+        placement_dimensions_);
+  }
+
+  // the placement of all the vertices, placement_dimensions_ values per
+  // vertex
+  const std::vector<float>& GetFlatPlacement() const
   {
-    return placement_attr_[vertex_id];
+    return placement_attr_;
   }
 
-  void CopyPlacement(Matrix<float>& attr) const { attr = placement_attr_; }
+  void CopyPlacement(Matrix<float>& attr) const;
   float PathTimingCost(const int path_id) const
   {
     return path_timing_cost_[path_id];
@@ -287,14 +379,27 @@ class Hypergraph
       std::vector<float> base_balance) const;
 
  private:
+  // create vind_ and vptr_ from eind_ and eptr_
+  void BuildVertexIncidence(ThreadPool* thread_pool);
+
+  // set the vertex types, the slack of hyperedges and the timing paths
+  void SetTimingInformation(std::vector<VertexType>&& vertex_types,
+                            std::vector<float>&& hyperedges_slack,
+                            std::vector<int>&& arc_ind,
+                            std::vector<int>&& arc_ptr,
+                            TimingPathStore&& timing_paths);
+
   // basic hypergraph
   const int num_vertices_ = 0;
   const int num_hyperedges_ = 0;
   const int vertex_dimensions_ = 1;
   const int hyperedge_dimensions_ = 1;
 
-  const Matrix<float> vertex_weights_;
-  const Matrix<float> hyperedge_weights_;  // weights can be negative
+  // The weights are stored row by row in flat arrays
+  // (vertex_dimensions_ values per vertex, hyperedge_dimensions_ values
+  // per hyperedge), so there is no allocation per vertex or hyperedge.
+  const std::vector<float> vertex_weights_;
+  const std::vector<float> hyperedge_weights_;  // weights can be negative
 
   // slack for hyperedge
   std::vector<float> hyperedge_timing_attr_;
@@ -303,8 +408,11 @@ class Hypergraph
   std::vector<float> hyperedge_timing_cost_;
 
   // map current hyperedge into arcs in timing graph the slack of each
-  // hyperedge e is the minimum_slack_hyperedge_arc_set_[e]
-  std::vector<std::set<int>> hyperedge_arc_set_;
+  // hyperedge e is the minimum slack of its arcs.
+  // The arcs of hyperedge e are arc_ind_[arc_ptr_[e]], ...,
+  // arc_ind_[arc_ptr_[e + 1] - 1]
+  std::vector<int> arc_ind_;
+  std::vector<int> arc_ptr_;
 
   // hyperedges: each hyperedge is a set of vertices
   std::vector<int> eind_;
@@ -314,11 +422,13 @@ class Hypergraph
   std::vector<int> vind_;
   std::vector<int> vptr_;
 
-  // Fill vertex_c_attr which maps the vertex to its corresponding cluster
-  // To simpify the implementation, the vertex_c_attr maps the original larger
-  // hypergraph vertex_c_attr has hgraph->num_vertices_ elements. This is used
-  // during coarsening phase similar to hyperedge_arc_set_
-  std::vector<std::vector<int>> vertex_c_attr_;
+  // The clusters of the vertices of the finer hypergraph, set during
+  // the coarsening phase. vertex_parents_ has one entry per vertex of the
+  // finer hypergraph, and the vertices of cluster c are
+  // vind_c_[vptr_c_[c]], ..., vind_c_[vptr_c_[c + 1] - 1].
+  std::vector<int> vertex_parents_;
+  std::vector<int> vind_c_;
+  std::vector<int> vptr_c_;
 
   // fixed vertices.  If fixed_vertex_flag_ = false, fixed_attr_ is empty
   bool fixed_vertex_flag_ = false;  // If there are fixed vertices
@@ -340,8 +450,8 @@ class Hypergraph
   // If placement_flag = false, placement_attr_ is empty
   bool placement_flag_ = false;
   int placement_dimensions_ = 0;
-  // the embedding for vertices
-  std::vector<std::vector<float>> placement_attr_;
+  // the embedding for vertices (placement_dimensions_ values per vertex)
+  std::vector<float> placement_attr_;
 
   // Timing information
   bool timing_flag_ = false;
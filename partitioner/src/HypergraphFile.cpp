@@ -0,0 +1,1034 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2022-2025, The OpenROAD Authors
+
+#include "HypergraphFile.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef HAS_ZLIB
+#include <zlib.h>
+#endif
+
+#include "Hypergraph.h"
+#include "ThreadPool.h"
+#include "Utilities.h"
+#include "utils/Logger.h"
+
+namespace par {
+
+namespace {
+
+constexpr char kBinaryMagic[8] = {'T', 'P', 'H', 'G', 'R', 'B', '\0', '\0'};
+constexpr uint32_t kBinaryVersion = 1;
+constexpr uint32_t kEndianMark = 0x01020304;
+
+// flags of the optional attributes
+constexpr uint32_t kFixedFlag = 1;
+constexpr uint32_t kCommunityFlag = 2;
+constexpr uint32_t kPlacementFlag = 4;
+constexpr uint32_t kTimingFlag = 8;
+
+struct BinaryHeader
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t endian_mark;
+  uint32_t flags;
+  int32_t num_vertices;
+  int32_t num_hyperedges;
+  int32_t num_pins;
+  int32_t vertex_dimensions;
+  int32_t hyperedge_dimensions;
+  int32_t placement_dimensions;
+  int32_t num_arcs;  // total size of the hyperedge arc sets
+  int32_t num_timing_paths;
+  int32_t num_path_vertices;
+  int32_t num_path_edges;
+  uint32_t reserved;
+};
+static_assert(sizeof(BinaryHeader) % 8 == 0, "unaligned .hgrb header");
+
+// Byte offsets of the arrays (in file order). Absent arrays have size 0.
+struct BinaryLayout
+{
+  size_t eptr = 0;
+  size_t eind = 0;
+  size_t vertex_weights = 0;
+  size_t hyperedge_weights = 0;
+  size_t fixed = 0;
+  size_t community = 0;
+  size_t placement = 0;
+  size_t vertex_types = 0;
+  size_t hyperedge_slacks = 0;
+  size_t arc_ptr = 0;
+  size_t arc_ind = 0;
+  size_t path_vptr = 0;
+  size_t path_vind = 0;
+  size_t path_eptr = 0;
+  size_t path_eind = 0;
+  size_t path_slacks = 0;
+  size_t total = 0;
+};
+
+BinaryLayout GetBinaryLayout(const BinaryHeader& header)
+{
+  BinaryLayout layout;
+  size_t offset = sizeof(BinaryHeader);
+  // place an array of num_elements 4-byte elements at the next offset
+  auto place = [&offset](size_t num_elements, bool present) {
+    const size_t begin = offset;
+    if (present) {
+      offset += (num_elements * 4 + 7) / 8 * 8;
+    }
+    return begin;
+  };
+  const size_t nv = header.num_vertices;
+  const size_t ne = header.num_hyperedges;
+  const bool timing = (header.flags & kTimingFlag) != 0;
+  layout.eptr = place(ne + 1, true);
+  layout.eind = place(header.num_pins, true);
+  layout.vertex_weights = place(nv * header.vertex_dimensions, true);
+  layout.hyperedge_weights = place(ne * header.hyperedge_dimensions, true);
+  layout.fixed = place(nv, (header.flags & kFixedFlag) != 0);
+  layout.community = place(nv, (header.flags & kCommunityFlag) != 0);
+  layout.placement = place(nv * header.placement_dimensions,
+                           (header.flags & kPlacementFlag) != 0);
+  layout.vertex_types = place(nv, timing);
+  layout.hyperedge_slacks = place(ne, timing);
+  layout.arc_ptr = place(ne + 1, timing);
+  layout.arc_ind = place(header.num_arcs, timing);
+  layout.path_vptr = place(header.num_timing_paths + 1, timing);
+  layout.path_vind = place(header.num_path_vertices, timing);
+  layout.path_eptr = place(header.num_timing_paths + 1, timing);
+  layout.path_eind = place(header.num_path_edges, timing);
+  layout.path_slacks = place(header.num_timing_paths, timing);
+  layout.total = offset;
+  return layout;
+}
+
+// write the array at its offset in the layout (zero padded to 8 bytes)
+template <typename T>
+void WriteArray(std::ofstream& out, const std::vector<T>& array)
+{
+  static_assert(sizeof(T) == 4, "the .hgrb arrays have 4-byte elements");
+  out.write(reinterpret_cast<const char*>(array.data()),
+            array.size() * sizeof(T));
+  const size_t padding = (8 - array.size() * sizeof(T) % 8) % 8;
+  const char zeros[8] = {0};
+  out.write(zeros, padding);
+}
+
+// Read-only mapping of a whole file, unmapped on destruction
+class MappedFile
+{
+ public:
+  explicit MappedFile(const std::string& file_name)
+  {
+    const int fd = open(file_name.c_str(), O_RDONLY);
+    if (fd < 0) {
+      return;
+    }
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) == 0) {
+      is_open_ = true;
+      size_ = static_cast<size_t>(file_stat.st_size);
+      if (size_ > 0) {
+        void* data = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+        if (data != MAP_FAILED) {
+          data_ = static_cast<const char*>(data);
+        } else {
+          is_open_ = false;
+        }
+      }
+    }
+    close(fd);
+  }
+
+  ~MappedFile()
+  {
+    if (data_ != nullptr) {
+      munmap(const_cast<char*>(data_), size_);
+    }
+  }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  bool IsOpen() const { return is_open_; }
+  const char* Data() const { return data_; }
+  size_t Size() const { return data_ != nullptr ? size_ : 0; }
+
+ private:
+  bool is_open_ = false;
+  const char* data_ = nullptr;
+  size_t size_ = 0;
+};
+
+// check that ptr is a CSR offset array of num_entries entries
+bool IsValidOffsets(const int* ptr, int num_rows, int num_entries)
+{
+  if (ptr[0] != 0 || ptr[num_rows] != num_entries) {
+    return false;
+  }
+  for (int i = 0; i < num_rows; i++) {
+    if (ptr[i] > ptr[i + 1]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// check that all the indices are in [0, upper)
+bool IsValidIndices(const int* ind, int num_entries, int upper)
+{
+  for (int i = 0; i < num_entries; i++) {
+    if (ind[i] < 0 || ind[i] >= upper) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool HasSuffix(const std::string& file_name, const std::string& suffix)
+{
+  return file_name.size() >= suffix.size()
+         && file_name.compare(
+                file_name.size() - suffix.size(), suffix.size(), suffix)
+                == 0;
+}
+
+// Contents of a text input file: the mapped file, or the decompressed
+// contents of a .gz file
+class TextFile
+{
+ public:
+  explicit TextFile(const std::string& file_name)
+  {
+    if (HasSuffix(file_name, ".gz")) {
+#ifdef HAS_ZLIB
+      gzFile gz_file = gzopen(file_name.c_str(), "rb");
+      if (gz_file == nullptr) {
+        return;
+      }
+      gzbuffer(gz_file, 1 << 20);
+      const size_t chunk_size = 1 << 24;
+      size_t size = 0;
+      while (true) {
+        inflated_.resize(size + chunk_size);
+        const int num_read = gzread(
+            gz_file, inflated_.data() + size, static_cast<unsigned>(chunk_size));
+        if (num_read < 0) {
+          gzclose(gz_file);
+          return;
+        }
+        size += num_read;
+        if (static_cast<size_t>(num_read) < chunk_size) {
+          break;
+        }
+      }
+      gzclose(gz_file);
+      inflated_.resize(size);
+      begin_ = inflated_.data();
+      end_ = begin_ + size;
+      is_open_ = true;
+#endif
+      return;
+    }
+    mapped_ = std::make_unique<MappedFile>(file_name);
+    is_open_ = mapped_->IsOpen();
+    begin_ = mapped_->Data();
+    end_ = begin_ + mapped_->Size();
+  }
+
+  bool IsOpen() const { return is_open_; }
+  const char* Begin() const { return begin_; }
+  const char* End() const { return end_; }
+
+ private:
+  bool is_open_ = false;
+  std::unique_ptr<MappedFile> mapped_;
+  std::vector<char> inflated_;
+  const char* begin_ = nullptr;
+  const char* end_ = nullptr;
+};
+
+std::unique_ptr<TextFile> OpenTextFile(const std::string& file_name,
+                                       const std::string& file_type,
+                                       Logger* logger)
+{
+#ifndef HAS_ZLIB
+  if (HasSuffix(file_name, ".gz")) {
+    logger->error("Cannot read the compressed {} file (built without zlib) : {}",
+                  file_type,
+                  file_name);
+    return nullptr;
+  }
+#endif
+  auto file = std::make_unique<TextFile>(file_name);
+  if (!file->IsOpen()) {
+    logger->error("Cannot open the {} file : {}", file_type, file_name);
+    return nullptr;
+  }
+  return file;
+}
+
+const char* LineEnd(const char* line, const char* end)
+{
+  const void* newline = std::memchr(line, '\n', end - line);
+  return newline != nullptr ? static_cast<const char*>(newline) : end;
+}
+
+// The begin of each line in [begin, end), without the comment lines
+// (starting with %). The text is split into one chunk per thread.
+std::vector<const char*> SplitLines(const char* begin,
+                                    const char* end,
+                                    ThreadPool& pool)
+{
+  const size_t min_chunk_size = 1 << 20;
+  const size_t size = end - begin;
+  const int num_chunks = static_cast<int>(std::min<size_t>(
+      pool.GetNumThreads(), size / min_chunk_size + 1));
+  // move the boundaries to the begin of the next line
+  std::vector<const char*> bounds(num_chunks + 1, end);
+  for (int i = 0; i < num_chunks; i++) {
+    const char* bound = begin + size * i / num_chunks;
+    if (bound != begin) {
+      bound = LineEnd(bound - 1, end);
+      bound = bound == end ? end : bound + 1;
+    }
+    bounds[i] = bound;
+  }
+  std::vector<std::vector<const char*>> chunk_lines(num_chunks);
+  pool.ParallelFor(num_chunks, [&](int i) {
+    for (const char* line = bounds[i]; line < bounds[i + 1];) {
+      if (*line != '%') {
+        chunk_lines[i].push_back(line);
+      }
+      line = LineEnd(line, end) + 1;
+    }
+  });
+  std::vector<const char*> lines;
+  for (const auto& chunk : chunk_lines) {
+    lines.insert(lines.end(), chunk.begin(), chunk.end());
+  }
+  return lines;
+}
+
+// Run parse(first_line, last_line) on one chunk of lines per thread
+template <typename Func>
+void ParallelForLines(int num_lines, ThreadPool& pool, Func parse)
+{
+  const int min_chunk_lines = 4096;
+  const int num_chunks
+      = std::min(pool.GetNumThreads(), num_lines / min_chunk_lines + 1);
+  pool.ParallelFor(num_chunks, [&](int i) {
+    parse(static_cast<int>(static_cast<int64_t>(num_lines) * i / num_chunks),
+          static_cast<int>(static_cast<int64_t>(num_lines) * (i + 1)
+                           / num_chunks));
+  });
+}
+
+bool IsDelim(char c)
+{
+  return c == ' ' || c == '\t' || c == ',' || c == '\r';
+}
+
+// Parse the next token of [ptr, end) into value. Returns false at the end
+// of the line, or if the token is not a number (error is set).
+template <typename T>
+bool ParseToken(const char*& ptr, const char* end, T& value, bool& error)
+{
+  while (ptr < end && IsDelim(*ptr)) {
+    ptr++;
+  }
+  if (ptr == end) {
+    return false;
+  }
+  const auto result = std::from_chars(ptr, end, value);
+  if (result.ec != std::errc()
+      || (result.ptr != end && !IsDelim(*result.ptr))) {
+    error = true;
+    return false;
+  }
+  ptr = result.ptr;
+  return true;
+}
+
+// Read all the integers of a fixed or community file
+// (without the comment lines starting with %)
+bool ReadIntAttributes(const std::string& file_name,
+                       const std::string& file_type,
+                       std::vector<int>& attr,
+                       Logger* logger)
+{
+  const auto file = OpenTextFile(file_name, file_type, logger);
+  if (file == nullptr) {
+    return false;
+  }
+  attr.clear();
+  bool error = false;
+  const char* ptr = file->Begin();
+  while (ptr < file->End() && !error) {
+    const char* line_end = LineEnd(ptr, file->End());
+    int value = 0;
+    if (*ptr != '%') {
+      while (ParseToken(ptr, line_end, value, error)) {
+        attr.push_back(value);
+      }
+    }
+    ptr = line_end + 1;
+  }
+  if (error) {
+    logger->error("Invalid value in the {} file : {}", file_type, file_name);
+    return false;
+  }
+  return true;
+}
+
+// Read the placement file: one line of placement_dimensions values per vertex,
+// stored row by row in placement_attr.
+// Same as TritonPart::ReadHypergraph, the invalid values are set to 0.0 and
+// the embedding is normalized to the mean value of each dimension.
+bool ReadPlacement(const std::string& file_name,
+                   int num_vertices,
+                   ThreadPool& pool,
+                   int& placement_dimensions,
+                   std::vector<float>& placement_attr,
+                   Logger* logger)
+{
+  const auto file = OpenTextFile(file_name, "placement", logger);
+  if (file == nullptr) {
+    return false;
+  }
+  const std::vector<const char*> lines
+      = SplitLines(file->Begin(), file->End(), pool);
+  placement_dimensions = 0;
+  placement_attr.clear();
+  if (static_cast<int>(lines.size()) != num_vertices || lines.empty()) {
+    debugPrint(logger, PAR, "hypergraph", 1,
+               "Reset the placement attributes to NONE.");
+    return true;
+  }
+  // the dimensions are given by the first line
+  {
+    bool error = false;
+    float value = 0.0;
+    const char* ptr = lines[0];
+    const char* line_end = LineEnd(ptr, file->End());
+    while (ParseToken(ptr, line_end, value, error)) {
+      placement_dimensions++;
+    }
+  }
+  if (placement_dimensions == 0) {
+    debugPrint(logger, PAR, "hypergraph", 1,
+               "Reset the placement attributes to NONE.");
+    return true;
+  }
+
+  // We assume the embedding has been normalized, i.e., the values are in
+  // [-1, 1]. Values larger than half of it (in abs) are invalid.
+  const float invalid_placement_thr = 0.5;
+  const float default_placement_value = 0.0;
+  placement_attr.resize(static_cast<size_t>(num_vertices)
+                        * placement_dimensions);
+  std::atomic<bool> error{false};
+  ParallelForLines(num_vertices, pool, [&](int first, int last) {
+    bool chunk_error = false;
+    for (int v = first; v < last && !chunk_error; v++) {
+      const char* ptr = lines[v];
+      const char* line_end = LineEnd(ptr, file->End());
+      float* vertex_placement = placement_attr.data()
+                                + static_cast<size_t>(v) * placement_dimensions;
+      int dim = 0;
+      float value = 0.0;
+      while (ParseToken(ptr, line_end, value, chunk_error)) {
+        if (std::isnan(value) || std::abs(value) >= invalid_placement_thr) {
+          value = default_placement_value;
+        }
+        if (dim < placement_dimensions) {
+          vertex_placement[dim] = value;
+        }
+        dim++;
+      }
+      chunk_error = chunk_error || dim != placement_dimensions;
+    }
+    if (chunk_error) {
+      error = true;
+    }
+  });
+  if (error) {
+    logger->error("Invalid line in the placement file : {}", file_name);
+    return false;
+  }
+
+  // normalize the embedding with the mean value of each dimension
+  std::vector<float> mean_placement_value_list(placement_dimensions, 0.0f);
+  for (int v = 0; v < num_vertices; v++) {
+    Accumulate(mean_placement_value_list,
+               WeightView(placement_attr.data()
+                              + static_cast<size_t>(v) * placement_dimensions,
+                          placement_dimensions));
+  }
+  mean_placement_value_list
+      = DivideFactor(mean_placement_value_list, num_vertices * 1.0);
+  for (size_t i = 0; i < placement_attr.size(); i++) {
+    const float mean = mean_placement_value_list[i % placement_dimensions];
+    if (mean != 0.0) {
+      placement_attr[i] /= mean;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+bool IsBinaryHypergraphFile(const std::string& file_name)
+{
+  return HasSuffix(file_name, ".hgrb");
+}
+
+bool WriteBinaryHypergraph(const Hypergraph& hgraph,
+                           const std::string& file_name,
+                           Logger* logger)
+{
+  const int num_vertices = hgraph.GetNumVertices();
+  const int num_hyperedges = hgraph.GetNumHyperedges();
+
+  BinaryHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, kBinaryMagic, sizeof(kBinaryMagic));
+  header.version = kBinaryVersion;
+  header.endian_mark = kEndianMark;
+  header.num_vertices = num_vertices;
+  header.num_hyperedges = num_hyperedges;
+  header.num_pins = hgraph.GetNumPins();
+  header.vertex_dimensions = hgraph.GetVertexDimensions();
+  header.hyperedge_dimensions = hgraph.GetHyperedgeDimensions();
+
+  // hyperedges in CSR format
+  std::vector<int> eptr{0};
+  std::vector<int> eind;
+  eptr.reserve(num_hyperedges + 1);
+  eind.reserve(hgraph.GetNumPins());
+  for (int e = 0; e < num_hyperedges; e++) {
+    for (const int v : hgraph.Vertices(e)) {
+      eind.push_back(v);
+    }
+    eptr.push_back(static_cast<int>(eind.size()));
+  }
+
+  std::vector<int> fixed_attr;
+  if (hgraph.HasFixedVertices()) {
+    header.flags |= kFixedFlag;
+    hgraph.CopyFixedAttr(fixed_attr);
+  }
+  std::vector<int> community_attr;
+  if (hgraph.HasCommunity()) {
+    header.flags |= kCommunityFlag;
+    hgraph.CopyCommunity(community_attr);
+  }
+  if (hgraph.HasPlacement()) {
+    header.flags |= kPlacementFlag;
+    header.placement_dimensions = hgraph.GetPlacementDimensions();
+  }
+
+  // timing arrays
+  std::vector<int> vertex_types;
+  std::vector<float> hyperedge_slacks;
+  std::vector<int> arc_ptr{0};
+  std::vector<int> arc_ind;
+  TimingPathStore timing_paths;
+  if (hgraph.HasTiming()) {
+    header.flags |= kTimingFlag;
+    vertex_types.reserve(num_vertices);
+    for (int v = 0; v < num_vertices; v++) {
+      vertex_types.push_back(hgraph.GetVertexType(v));
+    }
+    hyperedge_slacks = hgraph.GetHyperedgeTimingAttr();
+    for (int e = 0; e < num_hyperedges; e++) {
+      const auto& arc_set = hgraph.GetHyperedgeArcSet(e);
+      arc_ind.insert(arc_ind.end(), arc_set.begin(), arc_set.end());
+      arc_ptr.push_back(static_cast<int>(arc_ind.size()));
+    }
+    for (int path_id = 0; path_id < hgraph.GetNumTimingPaths(); path_id++) {
+      timing_paths.AddPath(hgraph.PathVertices(path_id),
+                           hgraph.PathEdges(path_id),
+                           hgraph.PathTimingSlack(path_id));
+    }
+    header.num_arcs = static_cast<int>(arc_ind.size());
+    header.num_timing_paths = timing_paths.size();
+    header.num_path_vertices = static_cast<int>(timing_paths.vind.size());
+    header.num_path_edges = static_cast<int>(timing_paths.eind.size());
+  }
+
+  std::ofstream out(file_name, std::ios::binary);
+  if (!out.is_open()) {
+    logger->error("Cannot open the output hypergraph file : {}", file_name);
+    return false;
+  }
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  // the arrays in the order of BinaryLayout
+  WriteArray(out, eptr);
+  WriteArray(out, eind);
+  // the weights are already stored row by row
+  WriteArray(out, hgraph.GetFlatVertexWeights());
+  WriteArray(out, hgraph.GetFlatHyperedgeWeights());
+  if (header.flags & kFixedFlag) {
+    WriteArray(out, fixed_attr);
+  }
+  if (header.flags & kCommunityFlag) {
+    WriteArray(out, community_attr);
+  }
+  if (header.flags & kPlacementFlag) {
+    WriteArray(out, hgraph.GetFlatPlacement());
+  }
+  if (header.flags & kTimingFlag) {
+    WriteArray(out, vertex_types);
+    WriteArray(out, hyperedge_slacks);
+    WriteArray(out, arc_ptr);
+    WriteArray(out, arc_ind);
+    WriteArray(out, timing_paths.vptr);
+    WriteArray(out, timing_paths.vind);
+    WriteArray(out, timing_paths.eptr);
+    WriteArray(out, timing_paths.eind);
+    WriteArray(out, timing_paths.slacks);
+  }
+  out.close();
+  if (!out) {
+    logger->error("Failed to write the hypergraph file : {}", file_name);
+    return false;
+  }
+  return true;
+}
+
+HGraphPtr ReadBinaryHypergraph(const std::string& file_name, Logger* logger)
+{
+  const MappedFile file(file_name);
+  if (!file.IsOpen()) {
+    logger->error("Cannot open the input hypergraph file : {}", file_name);
+    return nullptr;
+  }
+
+  BinaryHeader header;
+  if (file.Size() < sizeof(header)) {
+    logger->error("Invalid hypergraph file : {}", file_name);
+    return nullptr;
+  }
+  std::memcpy(&header, file.Data(), sizeof(header));
+  if (std::memcmp(header.magic, kBinaryMagic, sizeof(kBinaryMagic)) != 0
+      || header.endian_mark != kEndianMark
+      || header.version != kBinaryVersion) {
+    logger->error("Unsupported hypergraph file format : {}", file_name);
+    return nullptr;
+  }
+  const int num_vertices = header.num_vertices;
+  const int num_hyperedges = header.num_hyperedges;
+  const bool timing = (header.flags & kTimingFlag) != 0;
+  if (num_vertices < 0 || num_hyperedges < 0 || header.num_pins < 0
+      || header.vertex_dimensions <= 0 || header.hyperedge_dimensions <= 0
+      || header.placement_dimensions < 0 || header.num_arcs < 0
+      || header.num_timing_paths < 0 || header.num_path_vertices < 0
+      || header.num_path_edges < 0) {
+    logger->error("Invalid hypergraph file : {}", file_name);
+    return nullptr;
+  }
+  const BinaryLayout layout = GetBinaryLayout(header);
+  if (layout.total != file.Size()) {
+    logger->error("Truncated hypergraph file : {}", file_name);
+    return nullptr;
+  }
+
+  // the arrays are read directly from the mapped pages
+  auto int_array = [&file](size_t offset) {
+    return reinterpret_cast<const int*>(file.Data() + offset);
+  };
+  auto float_array = [&file](size_t offset) {
+    return reinterpret_cast<const float*>(file.Data() + offset);
+  };
+
+  const int* eptr = int_array(layout.eptr);
+  const int* eind = int_array(layout.eind);
+  bool valid = IsValidOffsets(eptr, num_hyperedges, header.num_pins)
+               && IsValidIndices(eind, header.num_pins, num_vertices);
+  if (timing) {
+    const int num_paths = header.num_timing_paths;
+    valid = valid
+            && IsValidIndices(int_array(layout.vertex_types),
+                              num_vertices,
+                              kPort + 1)  // the VertexType values
+            && IsValidOffsets(
+                int_array(layout.arc_ptr), num_hyperedges, header.num_arcs)
+            && IsValidIndices(
+                int_array(layout.arc_ind), header.num_arcs, num_hyperedges)
+            && IsValidOffsets(int_array(layout.path_vptr),
+                              num_paths,
+                              header.num_path_vertices)
+            && IsValidIndices(int_array(layout.path_vind),
+                              header.num_path_vertices,
+                              num_vertices)
+            && IsValidOffsets(int_array(layout.path_eptr),
+                              num_paths,
+                              header.num_path_edges)
+            && IsValidIndices(int_array(layout.path_eind),
+                              header.num_path_edges,
+                              num_hyperedges);
+  }
+  if (!valid) {
+    logger->error("Corrupted hypergraph file : {}", file_name);
+    return nullptr;
+  }
+
+  // the arrays are copied once, into the arrays of the hypergraph
+  auto copy_floats = [&float_array](size_t offset, size_t size) {
+    const float* values = float_array(offset);
+    return std::vector<float>(values, values + size);
+  };
+  HypergraphBuilder builder;
+  builder.vertex_dimensions = header.vertex_dimensions;
+  builder.hyperedge_dimensions = header.hyperedge_dimensions;
+  builder.placement_dimensions = header.placement_dimensions;
+  builder.eind.assign(eind, eind + header.num_pins);
+  builder.eptr.assign(eptr, eptr + num_hyperedges + 1);
+  builder.vertex_weights = copy_floats(
+      layout.vertex_weights,
+      static_cast<size_t>(num_vertices) * header.vertex_dimensions);
+  builder.hyperedge_weights = copy_floats(
+      layout.hyperedge_weights,
+      static_cast<size_t>(num_hyperedges) * header.hyperedge_dimensions);
+  if (header.flags & kFixedFlag) {
+    const int* fixed = int_array(layout.fixed);
+    builder.fixed_attr.assign(fixed, fixed + num_vertices);
+  }
+  if (header.flags & kCommunityFlag) {
+    const int* community = int_array(layout.community);
+    builder.community_attr.assign(community, community + num_vertices);
+  }
+  if (header.flags & kPlacementFlag) {
+    builder.placement_attr = copy_floats(
+        layout.placement,
+        static_cast<size_t>(num_vertices) * header.placement_dimensions);
+  }
+
+  if (timing) {
+    const int* types = int_array(layout.vertex_types);
+    builder.vertex_types.reserve(num_vertices);
+    for (int v = 0; v < num_vertices; v++) {
+      builder.vertex_types.push_back(static_cast<VertexType>(types[v]));
+    }
+    const float* slacks = float_array(layout.hyperedge_slacks);
+    builder.hyperedges_slack.assign(slacks, slacks + num_hyperedges);
+    const int* arc_ptr = int_array(layout.arc_ptr);
+    const int* arc_ind = int_array(layout.arc_ind);
+    builder.arc_ptr.assign(arc_ptr, arc_ptr + num_hyperedges + 1);
+    builder.arc_ind.assign(arc_ind, arc_ind + header.num_arcs);
+    const int num_paths = header.num_timing_paths;
+    const int* path_vptr = int_array(layout.path_vptr);
+    const int* path_vind = int_array(layout.path_vind);
+    const int* path_eptr = int_array(layout.path_eptr);
+    const int* path_eind = int_array(layout.path_eind);
+    const float* path_slacks = float_array(layout.path_slacks);
+    TimingPathStore& timing_paths = builder.timing_paths;
+    timing_paths.vptr.assign(path_vptr, path_vptr + num_paths + 1);
+    timing_paths.vind.assign(path_vind, path_vind + header.num_path_vertices);
+    timing_paths.eptr.assign(path_eptr, path_eptr + num_paths + 1);
+    timing_paths.eind.assign(path_eind, path_eind + header.num_path_edges);
+    timing_paths.slacks.assign(path_slacks, path_slacks + num_paths);
+  }
+
+  return builder.Build(logger);
+}
+
+bool WriteHMetisHypergraph(const Hypergraph& hgraph,
+                           const std::string& file_name,
+                           Logger* logger)
+{
+  std::ofstream file_output(file_name);
+  if (!file_output.is_open()) {
+    logger->error("Cannot open the output hypergraph file : {}", file_name);
+    return false;
+  }
+  file_output << hgraph.GetNumHyperedges() << " " << hgraph.GetNumVertices()
+              << " 11" << std::endl;
+  // write hyperedge weight and hyperedge first
+  for (int e = 0; e < hgraph.GetNumHyperedges(); e++) {
+    for (const float weight : hgraph.GetHyperedgeWeights(e)) {
+      file_output << weight << " ";
+    }
+    for (const int vertex : hgraph.Vertices(e)) {
+      file_output << vertex + 1 << " ";
+    }
+    file_output << std::endl;
+  }
+  // write vertex weight
+  for (int v = 0; v < hgraph.GetNumVertices(); v++) {
+    for (const float weight : hgraph.GetVertexWeights(v)) {
+      file_output << weight << " ";
+    }
+    file_output << std::endl;
+  }
+  file_output.close();
+  return static_cast<bool>(file_output);
+}
+
+HGraphPtr ReadHMetisHypergraph(const std::string& hypergraph_file,
+                               const std::string& fixed_file,
+                               const std::string& community_file,
+                               const std::string& placement_file,
+                               int vertex_dimensions,
+                               int hyperedge_dimensions,
+                               int num_threads,
+                               Logger* logger)
+{
+  ThreadPool pool(num_threads);
+  const auto file = OpenTextFile(hypergraph_file, "hypergraph", logger);
+  if (file == nullptr) {
+    return nullptr;
+  }
+  const char* file_end = file->End();
+  const std::vector<const char*> lines
+      = SplitLines(file->Begin(), file_end, pool);
+
+  // Check the number of vertices, number of hyperedges, weight flag
+  std::vector<int> stats;
+  bool error = false;
+  if (!lines.empty()) {
+    const char* ptr = lines[0];
+    const char* line_end = LineEnd(ptr, file_end);
+    int value = 0;
+    while (ParseToken(ptr, line_end, value, error)) {
+      stats.push_back(value);
+    }
+  }
+  if (error || stats.size() < 2 || stats[0] < 0 || stats[1] < 0) {
+    logger->error("Invalid header in the hypergraph file : {}",
+                  hypergraph_file);
+    return nullptr;
+  }
+  const int num_hyperedges = stats[0];
+  const int num_vertices = stats[1];
+  const bool hyperedge_weight_flag = stats.size() == 3 && stats[2] % 10 == 1;
+  const bool vertex_weight_flag = stats.size() == 3 && stats[2] >= 10;
+  const size_t num_lines
+      = 1 + num_hyperedges + (vertex_weight_flag ? num_vertices : 0);
+  if (lines.size() < num_lines) {
+    logger->error("Truncated hypergraph file : {}", hypergraph_file);
+    return nullptr;
+  }
+
+  // Read hyperedge information: each chunk of lines is parsed into its own
+  // CSR arrays, which are then concatenated
+  struct EdgeChunk
+  {
+    int first_edge = 0;
+    std::vector<int> eind;
+    std::vector<int> sizes;
+    bool error = false;
+  };
+  const int min_chunk_lines = 4096;
+  const int num_edge_chunks = std::min(
+      pool.GetNumThreads(), num_hyperedges / min_chunk_lines + 1);
+  std::vector<EdgeChunk> edge_chunks(num_edge_chunks);
+  // missing weights are 1.0
+  std::vector<float> hyperedge_weights(
+      static_cast<size_t>(num_hyperedges) * hyperedge_dimensions, 1.0f);
+  pool.ParallelFor(num_edge_chunks, [&](int i) {
+    EdgeChunk& chunk = edge_chunks[i];
+    chunk.first_edge = static_cast<int>(static_cast<int64_t>(num_hyperedges)
+                                        * i / num_edge_chunks);
+    const int last_edge = static_cast<int>(
+        static_cast<int64_t>(num_hyperedges) * (i + 1) / num_edge_chunks);
+    chunk.sizes.reserve(last_edge - chunk.first_edge);
+    for (int e = chunk.first_edge; e < last_edge && !chunk.error; e++) {
+      const char* ptr = lines[1 + e];
+      const char* line_end = LineEnd(ptr, file_end);
+      if (hyperedge_weight_flag == true) {
+        float* hwts = hyperedge_weights.data()
+                      + static_cast<size_t>(e) * hyperedge_dimensions;
+        for (int dim = 0; dim < hyperedge_dimensions; dim++) {
+          if (!ParseToken(ptr, line_end, hwts[dim], chunk.error)) {
+            chunk.error = true;
+            break;
+          }
+        }
+      }
+      const size_t edge_begin = chunk.eind.size();
+      int vertex = 0;
+      while (ParseToken(ptr, line_end, vertex, chunk.error)) {
+        // the vertex id starts from 1 in the hypergraph file
+        if (vertex < 1 || vertex > num_vertices) {
+          chunk.error = true;
+          break;
+        }
+        chunk.eind.push_back(vertex - 1);
+      }
+      chunk.sizes.push_back(static_cast<int>(chunk.eind.size() - edge_begin));
+    }
+  });
+
+  std::vector<int> eptr(num_hyperedges + 1, 0);
+  std::vector<size_t> chunk_offsets(num_edge_chunks + 1, 0);
+  for (int i = 0; i < num_edge_chunks; i++) {
+    const EdgeChunk& chunk = edge_chunks[i];
+    if (chunk.error) {
+      logger->error("Invalid hyperedge in the hypergraph file : {}",
+                    hypergraph_file);
+      return nullptr;
+    }
+    for (size_t j = 0; j < chunk.sizes.size(); j++) {
+      const int e = chunk.first_edge + static_cast<int>(j);
+      eptr[e + 1] = eptr[e] + chunk.sizes[j];
+    }
+    chunk_offsets[i + 1] = chunk_offsets[i] + chunk.eind.size();
+  }
+  std::vector<int> eind(chunk_offsets.back());
+  pool.ParallelFor(num_edge_chunks, [&](int i) {
+    std::copy(edge_chunks[i].eind.begin(),
+              edge_chunks[i].eind.end(),
+              eind.begin() + chunk_offsets[i]);
+    // release the chunk as soon as it is copied
+    std::vector<int>().swap(edge_chunks[i].eind);
+  });
+
+  // Read weight for vertices
+  std::vector<float> vertex_weights(
+      static_cast<size_t>(num_vertices) * vertex_dimensions, 1.0f);
+  std::atomic<bool> vertex_error{false};
+  ParallelForLines(num_vertices, pool, [&](int first, int last) {
+    bool chunk_error = false;
+    for (int v = first; v < last && !chunk_error && vertex_weight_flag; v++) {
+      const char* ptr = lines[1 + num_hyperedges + v];
+      const char* line_end = LineEnd(ptr, file_end);
+      float* vwts
+          = vertex_weights.data() + static_cast<size_t>(v) * vertex_dimensions;
+      for (int dim = 0; dim < vertex_dimensions; dim++) {
+        if (!ParseToken(ptr, line_end, vwts[dim], chunk_error)) {
+          chunk_error = true;
+          break;
+        }
+      }
+    }
+    if (chunk_error) {
+      vertex_error = true;
+    }
+  });
+  if (vertex_error) {
+    logger->error("Invalid vertex weight in the hypergraph file : {}",
+                  hypergraph_file);
+    return nullptr;
+  }
+
+  // Read fixed vertices
+  std::vector<int> fixed_attr;
+  if (!fixed_file.empty()) {
+    if (!ReadIntAttributes(fixed_file, "fixed", fixed_attr, logger)) {
+      return nullptr;
+    }
+    if (static_cast<int>(fixed_attr.size()) != num_vertices) {
+      debugPrint(
+          logger, PAR, "hypergraph", 1, "Reset the fixed attributes to NONE.");
+      fixed_attr.clear();
+    }
+  }
+
+  // Read community file
+  std::vector<int> community_attr;
+  if (!community_file.empty()) {
+    if (!ReadIntAttributes(
+            community_file, "community", community_attr, logger)) {
+      return nullptr;
+    }
+    if (static_cast<int>(community_attr.size()) != num_vertices) {
+      debugPrint(logger,
+                 PAR,
+                 "hypergraph",
+                 1,
+                 "Reset the community attributes to NONE.");
+      community_attr.clear();
+    }
+  }
+
+  // Read placement file
+  int placement_dimensions = 0;
+  std::vector<float> placement_attr;
+  if (!placement_file.empty()
+      && !ReadPlacement(placement_file,
+                        num_vertices,
+                        pool,
+                        placement_dimensions,
+                        placement_attr,
+                        logger)) {
+    return nullptr;
+  }
+
+  HypergraphBuilder builder;
+  builder.vertex_dimensions = vertex_dimensions;
+  builder.hyperedge_dimensions = hyperedge_dimensions;
+  builder.placement_dimensions = placement_dimensions;
+  builder.eind = std::move(eind);
+  builder.eptr = std::move(eptr);
+  builder.vertex_weights = std::move(vertex_weights);
+  builder.hyperedge_weights = std::move(hyperedge_weights);
+  builder.fixed_attr = std::move(fixed_attr);
+  builder.community_attr = std::move(community_attr);
+  builder.placement_attr = std::move(placement_attr);
+  return builder.Build(logger, &pool);
+}
+
+bool ReadGroupFile(const std::string& group_file,
+                   int num_vertices,
+                   Matrix<int>& group_attr,
+                   Logger* logger)
+{
+  group_attr.clear();
+  const auto file = OpenTextFile(group_file, "group", logger);
+  if (file == nullptr) {
+    return false;
+  }
+  bool error = false;
+  const char* ptr = file->Begin();
+  while (ptr < file->End() && !error) {
+    const char* line_end = LineEnd(ptr, file->End());
+    std::vector<int> group_info;
+    int vertex = 0;
+    if (*ptr != '%') {
+      while (ParseToken(ptr, line_end, vertex, error)) {
+        if (vertex < 1 || vertex > num_vertices) {
+          logger->error("Invalid vertex {} in the group file : {}",
+                        vertex,
+                        group_file);
+          group_attr.clear();
+          return false;
+        }
+        group_info.push_back(vertex - 1);  // reduce by 1 because of hMETIS
+      }
+    }
+    if (group_info.size() > 1) {
+      group_attr.push_back(std::move(group_info));
+    }
+    ptr = line_end + 1;
+  }
+  if (error) {
+    logger->error("Invalid value in the group file : {}", group_file);
+    group_attr.clear();
+    return false;
+  }
+  return true;
+}
+
+}  // namespace par
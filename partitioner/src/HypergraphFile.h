@@ -0,0 +1,65 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2022-2025, The OpenROAD Authors
+
+///////////////////////////////////////////////////////////////////////////////
+// High-level description
+// This file includes the readers and writers of hypergraph files:
+// the text hMETIS format (with the fixed, community, group and placement
+// files) and the binary hypergraph format (.hgrb).
+//
+// The .hgrb file is a fixed-size header followed by the arrays of the
+// hypergraph (CSR hyperedges, weight matrices in row-major order,
+// fixed / community / placement attributes and the timing arrays).
+// Each array starts at an 8-byte aligned offset which only depends on
+// the counts in the header, so the file is read by mmap without parsing
+// and several processes share the page-cached file.
+///////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include <string>
+
+#include "Hypergraph.h"
+#include "utils/Logger.h"
+
+namespace par {
+
+// Write the hypergraph (with all its attributes) to a .hgrb file
+bool WriteBinaryHypergraph(const Hypergraph& hgraph,
+                           const std::string& file_name,
+                           Logger* logger);
+
+// Read a .hgrb file, nullptr if the file is missing or invalid
+HGraphPtr ReadBinaryHypergraph(const std::string& file_name, Logger* logger);
+
+// Write the hypergraph in hMETIS format with its original weights
+// (all the dimensions), i.e., no cost or normalization is applied
+bool WriteHMetisHypergraph(const Hypergraph& hgraph,
+                           const std::string& file_name,
+                           Logger* logger);
+
+// Read a hypergraph in hMETIS format with its optional fixed, community
+// and placement files (empty file name: not used), nullptr if a file cannot
+// be read. Missing weights are set to 1.0 in all the dimensions, and the
+// placement dimensions are given by the placement file.
+// The files are mapped (or decompressed if they end with .gz), and the
+// lines are parsed by num_threads threads.
+HGraphPtr ReadHMetisHypergraph(const std::string& hypergraph_file,
+                               const std::string& fixed_file,
+                               const std::string& community_file,
+                               const std::string& placement_file,
+                               int vertex_dimensions,
+                               int hyperedge_dimensions,
+                               int num_threads,
+                               Logger* logger);
+
+// Read the group file: each line is a group of vertices (from 1 to
+// num_vertices) which stay together. Groups with a single vertex are ignored.
+// Returns false if the file cannot be read or has an invalid vertex.
+bool ReadGroupFile(const std::string& group_file,
+                   int num_vertices,
+                   Matrix<int>& group_attr,
+                   Logger* logger);
+
+// Returns true if the file name ends with .hgrb
+bool IsBinaryHypergraphFile(const std::string& file_name);
+
+}  // namespace par
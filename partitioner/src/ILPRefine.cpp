@@ -30,10 +30,12 @@ float IlpRefine::Pass(
     const Matrix<float>& upper_block_balance,
     const Matrix<float>& lower_block_balance,
     Matrix<float>& block_balance,        // the current block balance
-    Matrix<int>& net_degs,               // the current net degree
+    NetDegrees& net_degs,                // the current net degree
+    GainCache& gain_cache,               // the cached cut gain
     std::vector<float>& cur_paths_cost,  // the current path cost
     Partitions& solution,
-    std::vector<bool>& visited_vertices_flag)
+    std::vector<bool>& visited_vertices_flag,
+    const int max_move)
 {
   // Step 1: identify all the boundary vertices (boundary vertices will not
   // include fixed vertices)
@@ -58,10 +60,9 @@ float IlpRefine::Pass(
   for (const auto& v : boundary_vertices) {
     vertices_extracted.push_back(v);
     vertices_extracted_map[v] = vertex_id++;
-    vertices_weight_extracted.push_back(hgraph->GetVertexWeights(v));
+    vertices_weight_extracted.emplace_back(hgraph->GetVertexWeights(v));
     const int block_id = solution[v];
-    block_balance[block_id]
-        = block_balance[block_id] - hgraph->GetVertexWeights(v);
+    Subtract(block_balance[block_id], hgraph->GetVertexWeights(v));
   }
   const int part_vertex_id_base = vertex_id;
   // the remaining vertices in each block are modeled as a fixed vertex
@@ -128,13 +129,14 @@ float IlpRefine::Pass(
     const int vertex_id = vertices_extracted[i];
     const int to_pid = solution_extracted[i];
     // calculate the gain
-    GainCell gain_cell = CalculateVertexGain(vertex_id,
-                                             solution[vertex_id],
-                                             to_pid,
-                                             hgraph,
-                                             solution,
-                                             cur_paths_cost,
-                                             net_degs);
+    GainCell gain_cell = CalculateCachedVertexGain(vertex_id,
+                                                   solution[vertex_id],
+                                                   to_pid,
+                                                   hgraph,
+                                                   solution,
+                                                   cur_paths_cost,
+                                                   net_degs,
+                                                   gain_cache);
     moves_trace.push_back(gain_cell);
     // accept the gain
     AcceptVertexGain(gain_cell,
@@ -144,7 +146,8 @@ float IlpRefine::Pass(
                      solution,
                      cur_paths_cost,
                      block_balance,
-                     net_degs);
+                     net_degs,
+                     gain_cache);
     if (total_gain >= best_gain) {
       best_gain = total_gain;
       best_vertex_id = vertex_id;
@@ -157,7 +160,7 @@ float IlpRefine::Pass(
        move_iter++) {
     // stop when we encounter the best_vertex_id
     auto& vertex_move = *move_iter;
-    if (vertex_move->GetVertex() == best_vertex_id) {
+    if (vertex_move.GetVertex() == best_vertex_id) {
       break;  // stop here
     }
     RollBackVertexGain(vertex_move,
@@ -166,7 +169,8 @@ float IlpRefine::Pass(
                        solution,
                        cur_paths_cost,
                        block_balance,
-                       net_degs);
+                       net_degs,
+                       gain_cache);
   }
   return best_gain;
 }
@@ -39,10 +39,12 @@ class IlpRefine : public Refiner
              const Matrix<float>& upper_block_balance,
              const Matrix<float>& lower_block_balance,
              Matrix<float>& block_balance,        // the current block balance
-             Matrix<int>& net_degs,               // the current net degree
+             NetDegrees& net_degs,                // the current net degree
+             GainCache& gain_cache,               // the cached cut gain
              std::vector<float>& cur_paths_cost,  // the current path cost
              Partitions& solution,
-             std::vector<bool>& visited_vertices_flag) override;
+             std::vector<bool>& visited_vertices_flag,
+             int max_move) override;
 };
 
 }  // namespace par
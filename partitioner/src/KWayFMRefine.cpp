@@ -6,8 +6,7 @@
 #include <functional>
 #include <limits>
 #include <memory>
-#include <set>
-#include <thread>
+#include <numeric>
 #include <utility>
 #include <vector>
 
@@ -46,10 +45,12 @@ float KWayFMRefine::Pass(
     const Matrix<float>& upper_block_balance,
     const Matrix<float>& lower_block_balance,
     Matrix<float>& block_balance,        // the current block balance
-    Matrix<int>& net_degs,               // the current net degree
+    NetDegrees& net_degs,                // the current net degree
+    GainCache& gain_cache,               // the cached cut gain
     std::vector<float>& cur_paths_cost,  // the current path cost
     Partitions& solution,
-    std::vector<bool>& visited_vertices_flag)
+    std::vector<bool>& visited_vertices_flag,
+    const int max_move)
 {
   // initialize the gain buckets
   GainBuckets buckets;
@@ -69,8 +70,13 @@ float KWayFMRefine::Pass(
   // Initialize current gain in a multi-thread manner
   // set based on max heap (k set)
   // each block has its own max heap
-  InitializeGainBucketsKWay(
-      buckets, hgraph, boundary_vertices, net_degs, cur_paths_cost, solution);
+  InitializeGainBucketsKWay(buckets,
+                            hgraph,
+                            boundary_vertices,
+                            net_degs,
+                            gain_cache,
+                            cur_paths_cost,
+                            solution);
   // Here we do not store the vertex directly,
   // because we need to restore the status to the status with   best_gain
   // Based on our experiments, the moves is usually very limited.
@@ -91,48 +97,42 @@ float KWayFMRefine::Pass(
   }
 
   int best_vertex_id = -1;  // dummy best vertex id
+  std::vector<int> all_blocks(num_parts_);
+  std::iota(all_blocks.begin(), all_blocks.end(), 0);
   // main loop of FM pass
-  for (int i = 0; i < max_move_; i++) {
+  for (int i = 0; i < max_move; i++) {
     auto candidate = PickMoveKWay(buckets,
                                   hgraph,
                                   block_balance,
                                   upper_block_balance,
                                   lower_block_balance);
     // check the status of candidate
-    const int vertex = candidate->GetVertex();  // candidate vertex
+    const int vertex = candidate.GetVertex();  // candidate vertex
     if (vertex < 0) {
       break;  // no valid vertex found
     }
     AcceptKWayMove(candidate,
-                   buckets,
                    moves_trace,
                    total_delta_gain,
                    visited_vertices_flag,
                    hgraph,
                    block_balance,
                    net_degs,
+                   gain_cache,
                    cur_paths_cost,
                    solution);
     std::vector<int> neighbors
         = FindNeighbors(hgraph, vertex, visited_vertices_flag);
     // update the neighbors of v for all gain buckets in parallel
-    std::vector<std::thread> threads;
-    threads.reserve(num_parts_);
-    for (int to_pid = 0; to_pid < num_parts_; to_pid++) {
-      threads.emplace_back(&KWayFMRefine::UpdateSingleGainBucket,
-                           this,
-                           to_pid,
-                           std::ref(buckets),
-                           hgraph,
-                           std::ref(neighbors),
-                           std::ref(net_degs),
-                           std::ref(cur_paths_cost),
-                           std::ref(solution));
-    }
-    for (auto& t : threads) {
-      t.join();  // wait for all threads to finish
-    }
-    threads.clear();
+    UpdateGainBuckets(vertex,
+                      all_blocks,
+                      buckets,
+                      hgraph,
+                      neighbors,
+                      net_degs,
+                      gain_cache,
+                      cur_paths_cost,
+                      solution);
     if (total_delta_gain >= best_gain) {
       best_gain = total_delta_gain;
       best_vertex_id = vertex;
@@ -145,7 +145,7 @@ float KWayFMRefine::Pass(
        move_iter++) {
     // stop when we encounter the best_vertex_id
     auto& vertex_move = *move_iter;
-    if (vertex_move->GetVertex() == best_vertex_id) {
+    if (vertex_move.GetVertex() == best_vertex_id) {
       break;  // stop here
     }
     RollBackVertexGain(vertex_move,
@@ -154,7 +154,8 @@ float KWayFMRefine::Pass(
                        solution,
                        cur_paths_cost,
                        block_balance,
-                       net_degs);
+                       net_degs,
+                       gain_cache);
   }
 
   // clear the move traces
@@ -174,29 +175,23 @@ void KWayFMRefine::InitializeGainBucketsKWay(
     GainBuckets& buckets,
     const HGraphPtr& hgraph,
     const std::vector<int>& boundary_vertices,
-    const Matrix<int>& net_degs,
+    const NetDegrees& net_degs,
+    const GainCache& gain_cache,
     const std::vector<float>& cur_paths_cost,
     const Partitions& solution) const
 {
-  std::vector<std::thread> threads;  // for parallel updating
-  threads.reserve(num_parts_);
   // parallel initialize the num_parts gain_buckets
-  for (int to_pid = 0; to_pid < num_parts_; to_pid++) {
-    threads.emplace_back(
-        &KWayFMRefine::InitializeSingleGainBucket,
-        this,
-        std::ref(buckets),
-        to_pid,
-        hgraph,
-        std::ref(boundary_vertices),  // we only consider boundary vertices
-        std::ref(net_degs),
-        std::ref(cur_paths_cost),
-        std::ref(solution));
-  }
-  for (auto& t : threads) {
-    t.join();  // wait for all threads to finish
-  }
-  threads.clear();
+  // we only consider boundary vertices
+  RunTasks(num_parts_, boundary_vertices.size(), [&](int to_pid) {
+    InitializeSingleGainBucket(buckets,
+                               to_pid,
+                               hgraph,
+                               boundary_vertices,
+                               net_degs,
+                               gain_cache,
+                               cur_paths_cost,
+                               solution);
+  });
 }
 
 // Initialize the single bucket
@@ -205,7 +200,8 @@ void KWayFMRefine::InitializeSingleGainBucket(
     int to_pid,  // move the vertex into this block (block_id = to_pid)
     const HGraphPtr& hgraph,
     const std::vector<int>& boundary_vertices,
-    const Matrix<int>& net_degs,
+    const NetDegrees& net_degs,
+    const GainCache& gain_cache,
     const std::vector<float>& cur_paths_cost,
     const Partitions& solution) const
 {
@@ -217,9 +213,15 @@ void KWayFMRefine::InitializeSingleGainBucket(
     if (from_part == to_pid) {
       continue;  // the boundary vertex is the current bucket
     }
-    auto gain_cell = CalculateVertexGain(
-        v, from_part, to_pid, hgraph, solution, cur_paths_cost, net_degs);
-    buckets[to_pid]->InsertIntoPQ(gain_cell);
+    auto gain_cell = CalculateCachedVertexGain(v,
+                                               from_part,
+                                               to_pid,
+                                               hgraph,
+                                               solution,
+                                               cur_paths_cost,
+                                               net_degs,
+                                               gain_cache);
+    buckets[to_pid]->InsertIntoPQ(std::move(gain_cell));
   }
   // if the current bucket is empty, set the bucket to deactive
   if (buckets[to_pid]->GetTotalElements() == 0) {
@@ -228,7 +230,7 @@ void KWayFMRefine::InitializeSingleGainBucket(
 }
 
 // Determine which vertex gain to be picked
-std::shared_ptr<VertexGain> KWayFMRefine::PickMoveKWay(
+GainCell KWayFMRefine::PickMoveKWay(
     GainBuckets& buckets,
     const HGraphPtr& hgraph,
     const Matrix<float>& curr_block_balance,
@@ -237,25 +239,25 @@ std::shared_ptr<VertexGain> KWayFMRefine::PickMoveKWay(
 {
   // dummy candidate
   int to_pid = -1;
-  auto candidate = std::make_shared<VertexGain>();
+  const GainCell* candidate = nullptr;
+  float candidate_gain = -std::numeric_limits<float>::max();
 
   // best gain bucket for "corking effect".
   // i.e., if there is no normal candidate available,
   // we will traverse the best_to_pid bucket
   int best_to_pid = -1;  // block id with best_gain
   float best_gain = -std::numeric_limits<float>::max();
-  auto dummy_cell = std::make_shared<VertexGain>();
 
   // checking the first elements in each bucket
   for (int i = 0; i < num_parts_; ++i) {
     if (buckets[i]->GetStatus() == false) {
       continue;  // This bucket is empty
     }
-    auto ele = buckets[i]->GetMax();
-    const int vertex = ele->GetVertex();
-    const float gain = ele->GetGain();
-    const int from_pid = ele->GetSourcePart();
-    if ((gain > candidate->GetGain())
+    const auto& ele = buckets[i]->GetMax();
+    const int vertex = ele.GetVertex();
+    const float gain = ele.GetGain();
+    const int from_pid = ele.GetSourcePart();
+    if ((gain > candidate_gain)
         && CheckVertexMoveLegality(vertex,
                                    i,
                                    from_pid,
@@ -265,7 +267,8 @@ std::shared_ptr<VertexGain> KWayFMRefine::PickMoveKWay(
                                    lower_block_balance)
                == true) {
       to_pid = i;
-      candidate = ele;
+      candidate = &ele;
+      candidate_gain = gain;
     }
     // record part for solving corking effect
     if (gain > best_gain) {
@@ -274,8 +277,11 @@ std::shared_ptr<VertexGain> KWayFMRefine::PickMoveKWay(
     }
   }
   // Case 1:  if there is a candidate available or no vertex to move
-  if (to_pid > -1 || best_to_pid == -1) {
-    return candidate;
+  if (to_pid > -1) {
+    return *candidate;
+  }
+  if (best_to_pid == -1) {
+    return GainCell();  // return the dummy cell
   }
   // Case 2:  "corking effect", i.e., no candidate
   return buckets.at(best_to_pid)
@@ -284,18 +290,17 @@ std::shared_ptr<VertexGain> KWayFMRefine::PickMoveKWay(
 }
 
 // move one vertex based on the calculated gain_cell
-void KWayFMRefine::AcceptKWayMove(const std::shared_ptr<VertexGain>& gain_cell,
-                                  GainBuckets& gain_buckets,
+void KWayFMRefine::AcceptKWayMove(const GainCell& gain_cell,
                                   std::vector<GainCell>& moves_trace,
                                   float& total_delta_gain,
                                   std::vector<bool>& visited_vertices_flag,
                                   const HGraphPtr& hgraph,
                                   Matrix<float>& curr_block_balance,
-                                  Matrix<int>& net_degs,
+                                  NetDegrees& net_degs,
+                                  GainCache& gain_cache,
                                   std::vector<float>& cur_paths_cost,
                                   std::vector<int>& solution) const
 {
-  const int vertex_id = gain_cell->GetVertex();
   moves_trace.push_back(gain_cell);
   AcceptVertexGain(gain_cell,
                    hgraph,
@@ -304,20 +309,8 @@ void KWayFMRefine::AcceptKWayMove(const std::shared_ptr<VertexGain>& gain_cell,
                    solution,
                    cur_paths_cost,
                    curr_block_balance,
-                   net_degs);
-  // Remove vertex from all buckets where vertex is present
-  std::vector<std::thread> deletion_threads;
-  deletion_threads.reserve(num_parts_);
-  for (int i = 0; i < num_parts_; ++i) {
-    deletion_threads.emplace_back(&par::KWayFMRefine::HeapEleDeletion,
-                                  this,
-                                  vertex_id,
-                                  i,
-                                  std::ref(gain_buckets));
-  }
-  for (auto& th : deletion_threads) {
-    th.join();
-  }
+                   net_degs,
+                   gain_cache);
 }
 
 // Remove vertex from a heap
@@ -329,6 +322,33 @@ void KWayFMRefine::HeapEleDeletion(int vertex_id,
   buckets[part]->Remove(vertex_id);
 }
 
+// Remove the moved vertex from the buckets of blocks and update the gain of
+// its neighbors. The work of each block is an independent task, so one batch
+// is dispatched to the thread pool for each move.
+void KWayFMRefine::UpdateGainBuckets(const int vertex,
+                                     const std::vector<int>& blocks,
+                                     GainBuckets& buckets,
+                                     const HGraphPtr& hgraph,
+                                     const std::vector<int>& neighbors,
+                                     const NetDegrees& net_degs,
+                                     const GainCache& gain_cache,
+                                     const std::vector<float>& cur_paths_cost,
+                                     const Partitions& solution) const
+{
+  RunTasks(blocks.size(), neighbors.size(), [&](int block_idx) {
+    const int to_pid = blocks[block_idx];
+    HeapEleDeletion(vertex, to_pid, buckets);
+    UpdateSingleGainBucket(to_pid,
+                           buckets,
+                           hgraph,
+                           neighbors,
+                           net_degs,
+                           gain_cache,
+                           cur_paths_cost,
+                           solution);
+  });
+}
+
 // After moving one vertex, the gain of its neighbors will also need
 // to be updated. This function is used to update the gain of neighbor vertices
 // notices that the neighbors has been calculated based on solution, visited
@@ -338,25 +358,31 @@ void KWayFMRefine::UpdateSingleGainBucket(
     GainBuckets& buckets,
     const HGraphPtr& hgraph,
     const std::vector<int>& neighbors,
-    const Matrix<int>& net_degs,
+    const NetDegrees& net_degs,
+    const GainCache& gain_cache,
     const std::vector<float>& cur_paths_cost,
     const Partitions& solution) const
 {
-  std::set<int> neighboring_hyperedges;
   for (const int& v : neighbors) {
     const int from_part = solution[v];
     if (from_part == part) {
       continue;
     }
     // recalculate the current gain of the vertex v
-    auto gain_cell = CalculateVertexGain(
-        v, from_part, part, hgraph, solution, cur_paths_cost, net_degs);
+    auto gain_cell = CalculateCachedVertexGain(v,
+                                               from_part,
+                                               part,
+                                               hgraph,
+                                               solution,
+                                               cur_paths_cost,
+                                               net_degs,
+                                               gain_cache);
     // check if the vertex exists in current bucket
     if (buckets[part]->CheckIfVertexExists(v) == true) {
       // update the bucket with new gain
-      buckets[part]->ChangePriority(v, gain_cell);
+      buckets[part]->ChangePriority(v, std::move(gain_cell));
     } else {
-      buckets[part]->InsertIntoPQ(gain_cell);
+      buckets[part]->InsertIntoPQ(std::move(gain_cell));
     }
   }
 }
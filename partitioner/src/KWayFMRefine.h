@@ -43,7 +43,8 @@ class KWayFMRefine : public Refiner
       int to_pid,  // move the vertex into this block (block_id = to_pid)
       const HGraphPtr& hgraph,
       const std::vector<int>& boundary_vertices,
-      const Matrix<int>& net_degs,
+      const NetDegrees& net_degs,
+      const GainCache& gain_cache,
       const std::vector<float>& cur_paths_cost,
       const Partitions& solution) const;
 
@@ -55,7 +56,8 @@ class KWayFMRefine : public Refiner
                               GainBuckets& buckets,
                               const HGraphPtr& hgraph,
                               const std::vector<int>& neighbors,
-                              const Matrix<int>& net_degs,
+                              const NetDegrees& net_degs,
+                              const GainCache& gain_cache,
                               const std::vector<float>& cur_paths_cost,
                               const Partitions& solution) const;
 
@@ -66,40 +68,55 @@ class KWayFMRefine : public Refiner
              const Matrix<float>& upper_block_balance,
              const Matrix<float>& lower_block_balance,
              Matrix<float>& block_balance,        // the current block balance
-             Matrix<int>& net_degs,               // the current net degree
+             NetDegrees& net_degs,                // the current net degree
+             GainCache& gain_cache,               // the cached cut gain
              std::vector<float>& cur_paths_cost,  // the current path cost
              Partitions& solution,
-             std::vector<bool>& visited_vertices_flag) override;
+             std::vector<bool>& visited_vertices_flag,
+             int max_move) override;
 
   // gain bucket related functions
   // Initialize the gain buckets in parallel
   void InitializeGainBucketsKWay(GainBuckets& buckets,
                                  const HGraphPtr& hgraph,
                                  const std::vector<int>& boundary_vertices,
-                                 const Matrix<int>& net_degs,
+                                 const NetDegrees& net_degs,
+                                 const GainCache& gain_cache,
                                  const std::vector<float>& cur_paths_cost,
                                  const Partitions& solution) const;
 
   // Determine which vertex gain to be picked
-  std::shared_ptr<VertexGain> PickMoveKWay(
-      GainBuckets& buckets,
-      const HGraphPtr& hgraph,
-      const Matrix<float>& curr_block_balance,
-      const Matrix<float>& upper_block_balance,
-      const Matrix<float>& lower_block_balance) const;
+  GainCell PickMoveKWay(GainBuckets& buckets,
+                        const HGraphPtr& hgraph,
+                        const Matrix<float>& curr_block_balance,
+                        const Matrix<float>& upper_block_balance,
+                        const Matrix<float>& lower_block_balance) const;
 
   // move one vertex based on the calculated gain_cell
-  void AcceptKWayMove(const std::shared_ptr<VertexGain>& gain_cell,
-                      GainBuckets& gain_buckets,
+  // the gain buckets are updated separately by UpdateGainBuckets
+  void AcceptKWayMove(const GainCell& gain_cell,
                       std::vector<GainCell>& moves_trace,
                       float& total_delta_gain,
                       std::vector<bool>& visited_vertices_flag,
                       const HGraphPtr& hgraph,
                       Matrix<float>& curr_block_balance,
-                      Matrix<int>& net_degs,
+                      NetDegrees& net_degs,
+                      GainCache& gain_cache,
                       std::vector<float>& cur_paths_cost,
                       std::vector<int>& solution) const;
 
+  // Remove the moved vertex from the buckets of blocks and update
+  // the gain of its neighbors in these buckets (one task per block)
+  void UpdateGainBuckets(int vertex,
+                         const std::vector<int>& blocks,
+                         GainBuckets& buckets,
+                         const HGraphPtr& hgraph,
+                         const std::vector<int>& neighbors,
+                         const NetDegrees& net_degs,
+                         const GainCache& gain_cache,
+                         const std::vector<float>& cur_paths_cost,
+                         const Partitions& solution) const;
+
   // Remove vertex from a heap
   // Remove the vertex id related vertex gain
   void HeapEleDeletion(int vertex_id, int part, GainBuckets& buckets) const;
@@ -7,7 +7,6 @@
 #include <functional>
 #include <map>
 #include <memory>
-#include <thread>
 #include <utility>
 #include <vector>
 
@@ -44,10 +43,12 @@ float KWayPMRefine::Pass(
     const Matrix<float>& upper_block_balance,
     const Matrix<float>& lower_block_balance,
     Matrix<float>& block_balance,    // the current block balance
-    Matrix<int>& net_degs,           // the current net degree
+    NetDegrees& net_degs,            // the current net degree
+    GainCache& gain_cache,           // the cached cut gain
     std::vector<float>& paths_cost,  // the current path cost
     Partitions& solution,
-    std::vector<bool>& visited_vertices_flag)
+    std::vector<bool>& visited_vertices_flag,
+    const int max_move)
 {
   // Step 1: determine the matching score
   std::vector<std::pair<int, int>>
@@ -72,11 +73,13 @@ float KWayPMRefine::Pass(
                                 lower_block_balance,
                                 block_balance,
                                 net_degs,
+                                gain_cache,
                                 paths_cost,
                                 solution,
                                 buckets,
                                 visited_vertices_flag,
-                                partition_pair);
+                                partition_pair,
+                                max_move);
   }
   return delta_gain;
 }
@@ -182,12 +185,14 @@ float KWayPMRefine::PerformPairFM(
     const Matrix<float>& upper_block_balance,
     const Matrix<float>& lower_block_balance,
     Matrix<float>& block_balance,    // the current block balance
-    Matrix<int>& net_degs,           // the current net degree
+    NetDegrees& net_degs,            // the current net degree
+    GainCache& gain_cache,           // the cached cut gain
     std::vector<float>& paths_cost,  // the current path cost
     Partitions& solution,
     GainBuckets& buckets,
     std::vector<bool>& visited_vertices_flag,
-    const std::pair<int, int>& partition_pair) const
+    const std::pair<int, int>& partition_pair,
+    const int max_move) const
 {
   // clear the buckets
   std::vector<int> blocks{partition_pair.first, partition_pair.second};
@@ -204,6 +209,7 @@ float KWayPMRefine::PerformPairFM(
                           hgraph,
                           boundary_vertices,
                           net_degs,
+                          gain_cache,
                           paths_cost,
                           solution,
                           partition_pair);
@@ -219,7 +225,7 @@ float KWayPMRefine::PerformPairFM(
   float best_gain = 0.0;
   int best_vertex_id = -1;  // dummy best vertex id
   // main loop of FM pass
-  for (int i = 0; i < max_move_; i++) {
+  for (int i = 0; i < max_move; i++) {
     // here we use the PickMoveKWay method inheriting from KWayPMRefine
     // directly, because the buckets cooresponding to other blocks are empty
     // Similarly, we can also use AcceptKWayMove method inheriting from
@@ -230,41 +236,33 @@ float KWayPMRefine::PerformPairFM(
                                   upper_block_balance,
                                   lower_block_balance);
     // check the status of candidate
-    const int vertex = candidate->GetVertex();  // candidate vertex
+    const int vertex = candidate.GetVertex();  // candidate vertex
     if (vertex < 0) {
       break;  // no valid vertex found
     }
     AcceptKWayMove(candidate,
-                   buckets,
                    moves_trace,
                    total_delta_gain,
                    visited_vertices_flag,
                    hgraph,
                    block_balance,
                    net_degs,
+                   gain_cache,
                    paths_cost,
                    solution);
     // find the neighbors of vertex in partition_pair blocks
     const std::vector<int> neighbors = FindNeighbors(
         hgraph, vertex, visited_vertices_flag, solution, partition_pair);
     // update the neighbors of v for all gain buckets in parallel
-    std::vector<std::thread> threads;
-    threads.reserve(blocks.size());
-    for (auto& to_pid : blocks) {
-      threads.emplace_back(&KWayFMRefine::UpdateSingleGainBucket,
-                           this,
-                           to_pid,
-                           std::ref(buckets),
-                           hgraph,
-                           std::ref(neighbors),
-                           std::ref(net_degs),
-                           std::ref(paths_cost),
-                           std::ref(solution));
-    }
-    for (auto& t : threads) {
-      t.join();  // wait for all threads to finish
-    }
-    threads.clear();
+    UpdateGainBuckets(vertex,
+                      blocks,
+                      buckets,
+                      hgraph,
+                      neighbors,
+                      net_degs,
+                      gain_cache,
+                      paths_cost,
+                      solution);
     if (total_delta_gain >= best_gain) {
       best_gain = total_delta_gain;
       best_vertex_id = vertex;
@@ -276,7 +274,7 @@ float KWayPMRefine::PerformPairFM(
        move_iter++) {
     // stop when we encounter the best_vertex_id
     auto& vertex_move = *move_iter;
-    if (vertex_move->GetVertex() == best_vertex_id) {
+    if (vertex_move.GetVertex() == best_vertex_id) {
       break;  // stop here
     }
     RollBackVertexGain(vertex_move,
@@ -285,7 +283,8 @@ float KWayPMRefine::PerformPairFM(
                        solution,
                        paths_cost,
                        block_balance,
-                       net_degs);
+                       net_degs,
+                       gain_cache);
   }
 
   // clear the move traces
@@ -304,32 +303,25 @@ void KWayPMRefine::InitializeGainBucketsPM(
     GainBuckets& buckets,
     const HGraphPtr& hgraph,
     const std::vector<int>& boundary_vertices,
-    const Matrix<int>& net_degs,
+    const NetDegrees& net_degs,
+    const GainCache& gain_cache,
     const std::vector<float>& cur_paths_cost,
     const Partitions& solution,
     const std::pair<int, int>& partition_pair) const
 {
   std::vector<int> blocks_id{partition_pair.first, partition_pair.second};
-  std::vector<std::thread> threads;  // for parallel updating
-  threads.reserve(blocks_id.size());
-
   // parallel initialize the num_parts gain_buckets
-  for (const auto to_pid : blocks_id) {
-    threads.emplace_back(
-        &KWayFMRefine::InitializeSingleGainBucket,
-        this,
-        std::ref(buckets),
-        to_pid,
-        hgraph,
-        std::ref(boundary_vertices),  // we only consider boundary vertices
-        std::ref(net_degs),
-        std::ref(cur_paths_cost),
-        std::ref(solution));
-  }
-  for (auto& t : threads) {
-    t.join();  // wait for all threads to finish
-  }
-  threads.clear();
+  // we only consider boundary vertices
+  RunTasks(blocks_id.size(), boundary_vertices.size(), [&](int block_idx) {
+    InitializeSingleGainBucket(buckets,
+                               blocks_id[block_idx],
+                               hgraph,
+                               boundary_vertices,
+                               net_degs,
+                               gain_cache,
+                               cur_paths_cost,
+                               solution);
+  });
 }
 
 }  // namespace par
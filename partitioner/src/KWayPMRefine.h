@@ -47,10 +47,12 @@ class KWayPMRefine : public KWayFMRefine
              const Matrix<float>& upper_block_balance,
              const Matrix<float>& lower_block_balance,
              Matrix<float>& block_balance,        // the current block balance
-             Matrix<int>& net_degs,               // the current net degree
+             NetDegrees& net_degs,                // the current net degree
+             GainCache& gain_cache,               // the cached cut gain
              std::vector<float>& cur_paths_cost,  // the current path cost
              Partitions& solution,
-             std::vector<bool>& visited_vertices_flag) override;
+             std::vector<bool>& visited_vertices_flag,
+             int max_move) override;
 
   // The function to calculate the matching_scores
   void CalculateMaximumMatch(
@@ -63,19 +65,22 @@ class KWayPMRefine : public KWayFMRefine
       const Matrix<float>& upper_block_balance,
       const Matrix<float>& lower_block_balance,
       Matrix<float>& block_balance,    // the current block balance
-      Matrix<int>& net_degs,           // the current net degree
+      NetDegrees& net_degs,            // the current net degree
+      GainCache& gain_cache,           // the cached cut gain
       std::vector<float>& paths_cost,  // the current path cost
       Partitions& solution,
       GainBuckets& buckets,
       std::vector<bool>& visited_vertices_flag,
-      const std::pair<int, int>& partition_pair) const;
+      const std::pair<int, int>& partition_pair,
+      int max_move) const;
 
   // gain bucket related functions
   // Initialize the gain buckets in parallel
   void InitializeGainBucketsPM(GainBuckets& buckets,
                                const HGraphPtr& hgraph,
                                const std::vector<int>& boundary_vertices,
-                               const Matrix<int>& net_degs,
+                               const NetDegrees& net_degs,
+                               const GainCache& gain_cache,
                                const std::vector<float>& cur_paths_cost,
                                const Partitions& solution,
                                const std::pair<int, int>& partition_pair) const;
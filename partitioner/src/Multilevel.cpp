@@ -4,6 +4,8 @@
 #include "Multilevel.h"
 
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <functional>
 #include <limits>
 #include <numeric>
@@ -21,6 +23,7 @@
 #include "KWayFMRefine.h"
 #include "KWayPMRefine.h"
 #include "Partitioner.h"
+#include "ThreadPool.h"
 #include "Utilities.h"
 #include "boost/random/uniform_int_distribution.hpp"
 #include "boost/range/iterator_range_core.hpp"
@@ -66,6 +69,17 @@ MultilevelPartitioner::MultilevelPartitioner(
   logger_ = logger;
 }
 
+void MultilevelPartitioner::SetThreadPool(const ThreadPoolPtr& thread_pool)
+{
+  thread_pool_ = thread_pool;
+  coarsener_->SetThreadPool(thread_pool);
+  k_way_fm_refiner_->SetThreadPool(thread_pool);
+  k_way_pm_refiner_->SetThreadPool(thread_pool);
+  greedy_refiner_->SetThreadPool(thread_pool);
+  ilp_refiner_->SetThreadPool(thread_pool);
+  evaluator_->SetThreadPool(thread_pool);
+}
+
 // Main function
 // here the hgraph should not be const
 // Because our slack-rebudgeting algorithm will change hgraph
@@ -83,15 +97,64 @@ std::vector<int> MultilevelPartitioner::Partition(
   // In experiments, we observe that the benefits of increasing number of
   // vcycles is very limited. However, the quality of solutions will change a
   // lot with different random seed
-  Matrix<int> top_solutions;
+  // Each candidate is an independent pipeline (coarsening, initial
+  // partitioning, refinement and cut-overlay clustering) with its own seed,
+  // so the pipelines are run concurrently.
+  // The timing cost of hgraph is shared by all the pipelines,
+  // so it is initialized here instead of in the coarsener.
+  if (hgraph->HasTiming() && hgraph->GetTimingPathCostSize() == 0
+      && !hgraph->HasHyperedgeTimingCost()) {
+    evaluator_->InitializeTiming(hgraph);
+  }
+  // The partitioner uses the last initial seed for the ILP fallback,
+  // set it before the pipelines start.
+  const std::vector<int> initial_seeds = GetInitialSeeds();
+  if (!initial_seeds.empty()) {
+    partitioner_->SetRandomSeed(initial_seeds.back());
+  }
+  const int base_seed = coarsener_->GetRandomSeed();
+  Matrix<int> top_solutions(num_coarsen_solutions_);
+  auto run_pipeline = [&](const int id) {
+    top_solutions[id] = SingleLevelPartition(
+        hgraph, upper_block_balance, lower_block_balance, base_seed + id + 1);
+  };
+  // memory guard: limit the number of hierarchies alive at the same time
+  const int num_threads = thread_pool_ ? thread_pool_->GetNumThreads() : 1;
+  const int64_t max_pipelines_by_memory = std::max<int64_t>(
+      pipeline_memory_limit_ / EstimateHierarchyMemory(hgraph), 1);
+  const int num_pipelines = static_cast<int>(std::min<int64_t>(
+      std::min(num_coarsen_solutions_, num_threads), max_pipelines_by_memory));
+  debugPrint(logger_,
+             PAR,
+             "multilevel_partitioning",
+             1,
+             "Running {} coarsening pipelines, {} at a time",
+             num_coarsen_solutions_,
+             num_pipelines);
+  if (num_pipelines > 1) {
+    // each task runs the pipelines one by one until none is left
+    std::atomic<int> next_id{0};
+    thread_pool_->ParallelFor(num_pipelines, [&](int) {
+      for (int id = next_id.fetch_add(1); id < num_coarsen_solutions_;
+           id = next_id.fetch_add(1)) {
+        run_pipeline(id);
+      }
+    });
+  } else {
+    for (int id = 0; id < num_coarsen_solutions_; id++) {
+      run_pipeline(id);
+    }
+  }
+  // keep the seed of the coarsener the same as a sequential run
+  coarsener_->SetRandomSeed(base_seed + num_coarsen_solutions_);
+
+  // The selection follows the order of the pipelines,
+  // so it does not depend on the thread scheduling
   float best_cost = std::numeric_limits<float>::max();
   int best_solution_id = -1;
   for (int id = 0; id < num_coarsen_solutions_; id++) {
-    coarsener_->IncreaseRandomSeed();
-    top_solutions.push_back(
-        SingleLevelPartition(hgraph, upper_block_balance, lower_block_balance));
     const float cost
-        = evaluator_->CutEvaluator(hgraph, top_solutions.back(), false).cost;
+        = evaluator_->CutEvaluator(hgraph, top_solutions[id], false).cost;
     if (cost <= best_cost) {
       best_cost = cost;
       best_solution_id = id;
@@ -105,11 +168,13 @@ std::vector<int> MultilevelPartitioner::Partition(
              "Finish Candidate Solutions Generation");
 
   // Step 2: run cut-overlay clustering to enhance the solution
-  std::vector<int> best_solution = CutOverlayILPPart(hgraph,
-                                                     upper_block_balance,
-                                                     lower_block_balance,
-                                                     top_solutions,
-                                                     best_solution_id);
+  std::vector<int> best_solution
+      = CutOverlayILPPart(hgraph,
+                          upper_block_balance,
+                          lower_block_balance,
+                          top_solutions,
+                          best_solution_id,
+                          coarsener_->GetRandomSeed());
 
   debugPrint(logger_,
              PAR,
@@ -138,7 +203,8 @@ std::vector<int> MultilevelPartitioner::Partition(
 std::vector<int> MultilevelPartitioner::SingleLevelPartition(
     const HGraphPtr& hgraph,
     const Matrix<float>& upper_block_balance,
-    const Matrix<float>& lower_block_balance) const
+    const Matrix<float>& lower_block_balance,
+    const int seed) const
 {
   // Step 1: run coarsening
   // Step 2: run initial partitioning
@@ -146,7 +212,7 @@ std::vector<int> MultilevelPartitioner::SingleLevelPartition(
   // Step 4: cut-overlay clustering and ILP-based partitioning
 
   // Step 1: run coarsening
-  CoarseGraphPtrs hierarchy = coarsener_->LazyFirstChoice(hgraph);
+  CoarseGraphPtrs hierarchy = coarsener_->LazyFirstChoice(hgraph, seed);
 
   // Step 2: run initial partitioning
   HGraphPtr coarsest_hgraph = hierarchy.back();
@@ -183,7 +249,8 @@ std::vector<int> MultilevelPartitioner::SingleLevelPartition(
                            upper_block_balance,
                            lower_block_balance,
                            top_solutions,
-                           best_solution_id);
+                           best_solution_id,
+                           seed);
 }
 
 // Use the initial solution as the community feature
@@ -199,8 +266,10 @@ void MultilevelPartitioner::VcycleRefinement(
   for (int num_cycles = 0; num_cycles < max_num_vcycle_; num_cycles++) {
     // use the initial solution as the community feature
     hgraph->SetCommunity(best_solution);
-    best_solution = SingleCycleRefinement(
-        hgraph, upper_block_balance, lower_block_balance);
+    best_solution = SingleCycleRefinement(hgraph,
+                                          upper_block_balance,
+                                          lower_block_balance,
+                                          coarsener_->GetRandomSeed());
     candidate_solutions.push_back(best_solution);
     const float cost
         = evaluator_->CutEvaluator(hgraph, best_solution, false).cost;
@@ -219,20 +288,22 @@ void MultilevelPartitioner::VcycleRefinement(
                           upper_block_balance,
                           lower_block_balance,
                           candidate_solutions,
-                          static_cast<int>(candidate_solutions.size()) - 1);
+                          static_cast<int>(candidate_solutions.size()) - 1,
+                          coarsener_->GetRandomSeed());
 }
 
 // Single Vcycle Refinement
 std::vector<int> MultilevelPartitioner::SingleCycleRefinement(
     const HGraphPtr& hgraph,
     const Matrix<float>& upper_block_balance,
-    const Matrix<float>& lower_block_balance) const
+    const Matrix<float>& lower_block_balance,
+    const int seed) const
 {
   // Step 1: run coarsening
   // Step 2: run refinement
 
   // Step 1: run coarsening
-  CoarseGraphPtrs hierarchy = coarsener_->LazyFirstChoice(hgraph);
+  CoarseGraphPtrs hierarchy = coarsener_->LazyFirstChoice(hgraph, seed);
 
   // Step 2: run initial refinement
   HGraphPtr coarsest_hgraph = hierarchy.back();
@@ -256,6 +327,47 @@ std::vector<int> MultilevelPartitioner::SingleCycleRefinement(
   return top_solutions[best_solution_id];
 }
 
+// The random seeds of the random initial partitioning.
+// random partitioning and random vile partitioning use
+// num_initial_random_solutions_ seeds each.
+std::vector<int> MultilevelPartitioner::GetInitialSeeds() const
+{
+  std::mt19937 gen;
+  gen.seed(seed_);
+  boost::random::uniform_int_distribution<> dist(
+      0, std::numeric_limits<int>::max());
+  std::vector<int> seeds(num_initial_random_solutions_ * 2);
+  for (auto& seed : seeds) {
+    seed = dist(gen);
+  }
+  return seeds;
+}
+
+// A rough estimation of the memory used by one pipeline.
+// The coarser hypergraphs shrink geometrically, so all the levels below
+// hgraph take at most about twice the memory of hgraph itself.
+int64_t MultilevelPartitioner::EstimateHierarchyMemory(
+    const HGraphPtr& hgraph) const
+{
+  const int64_t num_vertices = hgraph->GetNumVertices();
+  const int64_t num_hyperedges = hgraph->GetNumHyperedges();
+  // eind_ + vind_, eptr_ + vptr_
+  int64_t level_memory = 2 * sizeof(int) * hgraph->GetNumPins();
+  level_memory += 2 * sizeof(int) * (num_vertices + num_hyperedges);
+  // vertex weights, the clusters of the finer vertices (parents and CSR)
+  // and the other vertex attributes
+  level_memory
+      += num_vertices
+         * (sizeof(float) * hgraph->GetVertexDimensions() + 7 * sizeof(int));
+  // hyperedge weights and timing arcs
+  level_memory += num_hyperedges
+                  * (sizeof(float) * hgraph->GetHyperedgeDimensions()
+                     + (hgraph->HasTiming() ? 2 * sizeof(int) : 0));
+  // the top solutions refined on each level
+  level_memory += sizeof(int) * num_vertices * num_best_initial_solutions_;
+  return std::max<int64_t>(2 * level_memory, 1);
+}
+
 // Generate initial partitioning
 // Include random partitioning, Vile partitioning and ILP partitioning
 void MultilevelPartitioner::InitialPartition(
@@ -270,111 +382,112 @@ void MultilevelPartitioner::InitialPartition(
              "initial_partitioning",
              1,
              "Running Initial Partitioning...");
-  std::mt19937 gen;
-  gen.seed(seed_);
-  boost::random::uniform_int_distribution<> dist(
-      0, std::numeric_limits<int>::max());
-  std::vector<float> initial_solutions_cost;
-  std::vector<bool>
-      initial_solutions_flag;  // if the solutions statisfy balance constraint
+  // the candidates : random partitioning + random vile partitioning + Vile
+  const int num_random_solutions = num_initial_random_solutions_ * 2;
+  const int num_candidates = num_random_solutions + 1;
   Matrix<int> initial_solutions;
   if (hgraph->GetNumVertices() <= num_vertices_threshold_ilp_) {
     // random partitioning + Vile + ILP
-    initial_solutions.resize(num_initial_random_solutions_ * 2 + 2);
+    initial_solutions.resize(num_candidates + 1);
   } else {
     // random partitioning + Vile
-    initial_solutions.resize(num_initial_random_solutions_ * 2 + 1);
+    initial_solutions.resize(num_candidates);
   }
-  // We need k_way_fm_refiner to generate a balanced partitioning
-  k_way_fm_refiner_->SetMaxMove(hgraph->GetNumVertices());
-  // generate random seed
-  for (int i = 0; i < num_initial_random_solutions_; ++i) {
-    const int seed = dist(gen);
+  // The seeds are generated in the same order as a sequential run,
+  // so the candidates do not depend on the number of threads
+  const std::vector<int> seeds = GetInitialSeeds();
+  std::vector<float> initial_solutions_cost(num_candidates);
+  // if the solutions statisfy balance constraint
+  // (std::vector<bool> can not be written concurrently)
+  std::vector<char> balance_flags(num_candidates);
+  // All the candidates are independent, so they are generated in parallel.
+  // The partitioner and the refiner are only accessed through const-state
+  // calls (the seed and max_move are passed per call).
+  auto generate_candidate = [&](const int i) {
     auto& solution = initial_solutions[i];
-    // call random partitioning
-    partitioner_->SetRandomSeed(seed);
-    partitioner_->Partition(hgraph,
-                            upper_block_balance,
-                            lower_block_balance,
-                            solution,
-                            PartitionType::kInitRandom);
+    if (i < num_initial_random_solutions_) {
+      // call random partitioning
+      partitioner_->Partition(hgraph,
+                              upper_block_balance,
+                              lower_block_balance,
+                              solution,
+                              PartitionType::kInitRandom,
+                              seeds[i]);
+    } else if (i < num_random_solutions) {
+      // call random vile partitioning
+      partitioner_->Partition(hgraph,
+                              upper_block_balance,
+                              lower_block_balance,
+                              solution,
+                              PartitionType::kInitRandomVile,
+                              seeds[i]);
+    } else {
+      // Vile partitioning. Vile partitioning needs refiner to generated a
+      // balanced partitioning
+      partitioner_->Partition(hgraph,
+                              upper_block_balance,
+                              lower_block_balance,
+                              solution,
+                              PartitionType::kInitVile);
+    }
     // call FM refiner to improve the solution
-    k_way_fm_refiner_->Refine(
-        hgraph, upper_block_balance, lower_block_balance, solution);
+    // We need k_way_fm_refiner to generate a balanced partitioning
+    k_way_fm_refiner_->Refine(hgraph,
+                              upper_block_balance,
+                              lower_block_balance,
+                              solution,
+                              hgraph->GetNumVertices());
     const auto token = evaluator_->CutEvaluator(hgraph, solution, false);
-    initial_solutions_cost.push_back(token.cost);
+    initial_solutions_cost[i] = token.cost;
     // Here we only check the upper bound to make sure more possible solutions
-    initial_solutions_flag.push_back(token.block_balance
-                                     <= upper_block_balance);
-    debugPrint(logger_,
-               PAR,
-               "initial_partitioning",
-               1,
-               "{} :: Random part cutcost = {}, balance_flag = {}",
-               i,
-               initial_solutions_cost.back(),
-               (bool) initial_solutions_flag.back());
+    balance_flags[i] = token.block_balance <= upper_block_balance;
+  };
+  if (thread_pool_) {
+    thread_pool_->ParallelFor(num_candidates, generate_candidate);
+  } else {
+    for (int i = 0; i < num_candidates; i++) {
+      generate_candidate(i);
+    }
   }
-  // generate random vile solution
-  for (int i = 0; i < num_initial_random_solutions_; ++i) {
-    const int seed = dist(gen);
-    auto& solution = initial_solutions[i + num_initial_random_solutions_];
-    // call random partitioning
-    partitioner_->SetRandomSeed(seed);
-    partitioner_->Partition(hgraph,
-                            upper_block_balance,
-                            lower_block_balance,
-                            solution,
-                            PartitionType::kInitRandomVile);
-    // call FM refiner to improve the solution
-    k_way_fm_refiner_->Refine(
-        hgraph, upper_block_balance, lower_block_balance, solution);
-    const auto token = evaluator_->CutEvaluator(hgraph, solution, false);
-    initial_solutions_cost.push_back(token.cost);
-    // Here we only check the upper bound to make sure more possible solutions
-    initial_solutions_flag.push_back(token.block_balance
-                                     <= upper_block_balance);
-    debugPrint(logger_,
-               PAR,
-               "initial_partitioning",
-               1,
-               "{} :: Random VILE part cutcost = {}, balance_flag = {}",
-               i,
-               initial_solutions_cost.back(),
-               (bool) initial_solutions_flag.back());
+  std::vector<bool> initial_solutions_flag(balance_flags.begin(),
+                                           balance_flags.end());
+  for (int i = 0; i < num_candidates; i++) {
+    if (i < num_initial_random_solutions_) {
+      debugPrint(logger_,
+                 PAR,
+                 "initial_partitioning",
+                 1,
+                 "{} :: Random part cutcost = {}, balance_flag = {}",
+                 i,
+                 initial_solutions_cost[i],
+                 (bool) initial_solutions_flag[i]);
+    } else if (i < num_random_solutions) {
+      debugPrint(logger_,
+                 PAR,
+                 "initial_partitioning",
+                 1,
+                 "{} :: Random VILE part cutcost = {}, balance_flag = {}",
+                 i - num_initial_random_solutions_,
+                 initial_solutions_cost[i],
+                 (bool) initial_solutions_flag[i]);
+    } else {
+      debugPrint(logger_,
+                 PAR,
+                 "initial_partitioning",
+                 1,
+                 "VILE part cutcost = {}, balance_flag = {}",
+                 initial_solutions_cost[i],
+                 (bool) initial_solutions_flag[i]);
+    }
   }
-
-  // Vile partitioning. Vile partitioning needs refiner to generated a balanced
-  // partitioning
-  auto& vile_solution = initial_solutions[num_initial_random_solutions_ * 2L];
-  partitioner_->Partition(hgraph,
-                          upper_block_balance,
-                          lower_block_balance,
-                          vile_solution,
-                          PartitionType::kInitVile);
-  // We need k_way_fm_refiner to generate a balanced partitioning
-  k_way_fm_refiner_->Refine(
-      hgraph, upper_block_balance, lower_block_balance, vile_solution);
-  k_way_fm_refiner_->RestoreDefaultParameters();
-  const auto vile_token
-      = evaluator_->CutEvaluator(hgraph, vile_solution, false);
-  initial_solutions_cost.push_back(vile_token.cost);
-  initial_solutions_flag.push_back(vile_token.block_balance
-                                   <= upper_block_balance);
-  debugPrint(logger_,
-             PAR,
-             "initial_partitioning",
-             1,
-             "VILE part cutcost = {}, balance_flag = {}",
-             initial_solutions_cost.back(),
-             (bool) initial_solutions_flag.back());
   // ILP partitioning
   if (hgraph->GetNumVertices() <= num_vertices_threshold_ilp_) {
     auto& ilp_solution = initial_solutions.back();
     // Use previous best solution as a starting point
     int ilp_solution_id = 0;
     float ilp_solution_cost = std::numeric_limits<float>::max();
-    for (auto id = 0; id < initial_solutions_cost.size(); id++) {
+    for (int id = 0; id < static_cast<int>(initial_solutions_cost.size());
+         id++) {
       if (initial_solutions_flag[id] == true
           && initial_solutions_cost[id] < ilp_solution_cost) {
         ilp_solution_id = id;
@@ -443,7 +556,8 @@ void MultilevelPartitioner::InitialPartition(
   }
 
   // remove invalid solution
-  while (top_initial_solutions.size() > num_chosen_best_init_solution) {
+  while (static_cast<int>(top_initial_solutions.size())
+         > num_chosen_best_init_solution) {
     top_initial_solutions.pop_back();
   }
 
@@ -489,15 +603,8 @@ void MultilevelPartitioner::RefinePartition(
     // convert the solution in coarse_hgraph to the solution of hgraph
     for (auto& top_solution : top_solutions) {
       std::vector<int> refined_solution;
-      refined_solution.resize(hgraph->GetNumVertices());
-      for (int cluster_id = 0; cluster_id < coarse_hgraph->GetNumVertices();
-           cluster_id++) {
-        const int part_id = top_solution[cluster_id];
-        for (const auto& v : coarse_hgraph->GetVertexCAttr(cluster_id)) {
-          refined_solution[v] = part_id;
-        }
-      }
-      top_solution = refined_solution;
+      coarse_hgraph->ProjectSolution(top_solution, refined_solution);
+      top_solution = std::move(refined_solution);
     }
 
     // Parallel refine all the solutions
@@ -518,7 +625,7 @@ void MultilevelPartitioner::RefinePartition(
 
     // update the best_solution_id
     float best_cost = std::numeric_limits<float>::max();
-    for (auto i = 0; i < top_solutions.size(); i++) {
+    for (int i = 0; i < static_cast<int>(top_solutions.size()); i++) {
       const float cost
           = evaluator_->CutEvaluator(hgraph, top_solutions[i], false).cost;
       if (best_cost > cost) {
@@ -567,7 +674,8 @@ std::vector<int> MultilevelPartitioner::CutOverlayILPPart(
     const Matrix<float>& upper_block_balance,
     const Matrix<float>& lower_block_balance,
     const Matrix<int>& top_solutions,
-    int best_solution_id) const
+    int best_solution_id,
+    const int seed) const
 {
   std::vector<int> optimal_solution = top_solutions[best_solution_id];
   std::vector<int> vertex_cluster_vec(hgraph->GetNumVertices(), -1);
@@ -655,16 +763,11 @@ std::vector<int> MultilevelPartitioner::CutOverlayILPPart(
   } else {
     clustered_hgraph->SetCommunity(init_solution);
     init_solution = SingleCycleRefinement(
-        clustered_hgraph, upper_block_balance, lower_block_balance);
+        clustered_hgraph, upper_block_balance, lower_block_balance, seed);
   }
 
   // map the solution back to the original hypergraph
-  for (int c_id = 0; c_id < clustered_hgraph->GetNumVertices(); c_id++) {
-    const int block_id = init_solution[c_id];
-    for (const auto& v : clustered_hgraph->GetVertexCAttr(c_id)) {
-      optimal_solution[v] = block_id;
-    }
-  }
+  clustered_hgraph->ProjectSolution(init_solution, optimal_solution);
 
   debugPrint(logger_,
              PAR,
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <vector>
 
@@ -14,6 +15,7 @@
 #include "KWayFMRefine.h"
 #include "KWayPMRefine.h"
 #include "Partitioner.h"
+#include "ThreadPool.h"
 #include "Utilities.h"
 #include "utils/Logger.h"
 
@@ -45,6 +47,20 @@ class MultilevelPartitioner
                         EvaluatorPtr evaluator,
                         par::Logger* logger);
 
+  // Share one long-lived thread pool among the coarsener, all the refiners,
+  // the initial partitioning and the evaluator, such that no threads are
+  // created during partitioning
+  void SetThreadPool(const ThreadPoolPtr& thread_pool);
+
+  // The candidate solutions of Partition are generated by independent
+  // coarsening pipelines running concurrently. Each pipeline keeps its own
+  // hierarchy alive, so the number of concurrent pipelines is limited such
+  // that the estimated memory of all the hierarchies stays below this limit.
+  void SetPipelineMemoryLimit(int64_t memory_limit)
+  {
+    pipeline_memory_limit_ = memory_limit;
+  }
+
   // Main function
   // here the hgraph should not be const
   // Because our slack-rebudgeting algorithm will change hgraph
@@ -61,16 +77,27 @@ class MultilevelPartitioner
 
  private:
   // Run single-level partitioning
+  // seed is the random seed used for coarsening
   std::vector<int> SingleLevelPartition(
       const HGraphPtr& hgraph,
       const Matrix<float>& upper_block_balance,
-      const Matrix<float>& lower_block_balance) const;
+      const Matrix<float>& lower_block_balance,
+      int seed) const;
+
+  // The random seeds of the random initial partitioning
+  std::vector<int> GetInitialSeeds() const;
+
+  // A rough estimation of the memory (in bytes) used by one coarsening
+  // hierarchy of hgraph and the solutions refined on it
+  int64_t EstimateHierarchyMemory(const HGraphPtr& hgraph) const;
 
   // We expose this interface for the last-minute improvement
+  // seed is the random seed used for coarsening
   std::vector<int> SingleCycleRefinement(
       const HGraphPtr& hgraph,
       const Matrix<float>& upper_block_balance,
-      const Matrix<float>& lower_block_balance) const;
+      const Matrix<float>& lower_block_balance,
+      int seed) const;
 
   // Generate initial partitioning
   // Include random partitioning, Vile partitioning and ILP partitioning
@@ -100,11 +127,13 @@ class MultilevelPartitioner
   // Perform cut-overlay clustering and ILP-based partitioning
   // The ILP-based partitioning uses top_solutions[best_solution_id] as a hint,
   // such that the runtime can be signficantly reduced
+  // seed is the random seed used for coarsening
   std::vector<int> CutOverlayILPPart(const HGraphPtr& hgraph,
                                      const Matrix<float>& upper_block_balance,
                                      const Matrix<float>& lower_block_balance,
                                      const Matrix<int>& top_solutions,
-                                     int best_solution_id) const;
+                                     int best_solution_id,
+                                     int seed) const;
 
   // basic parameters
   const int num_parts_ = 2;
@@ -119,6 +148,7 @@ class MultilevelPartitioner
       = 3;  // number of coarsening solutions with different random seed
   const int seed_ = 0;  // random seed
   const bool v_cycle_flag_ = true;
+  int64_t pipeline_memory_limit_ = int64_t{4} << 30;  // 4 GB
 
   // pointers
   CoarseningPtr coarsener_ = nullptr;
@@ -128,6 +158,7 @@ class MultilevelPartitioner
   GreedyRefinerPtr greedy_refiner_ = nullptr;
   IlpRefinerPtr ilp_refiner_ = nullptr;
   EvaluatorPtr evaluator_ = nullptr;
+  ThreadPoolPtr thread_pool_ = nullptr;
   par::Logger* logger_ = nullptr;
 };
 
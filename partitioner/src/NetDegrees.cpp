@@ -0,0 +1,125 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2022-2025, The OpenROAD Authors
+
+#include "NetDegrees.h"
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "Hypergraph.h"
+
+namespace par {
+
+NetDegrees::NetDegrees(const int num_parts,
+                       const HGraphPtr& hgraph,
+                       const std::vector<int>& solution)
+    : num_parts_(num_parts), num_words_((num_parts + 63) / 64)
+{
+  const int num_hyperedges = hgraph->GetNumHyperedges();
+  offsets_.resize(num_hyperedges);
+  widths_.resize(num_hyperedges);
+  // assign the counters of each hyperedge based on its size
+  uint32_t num_counts_8 = 0;
+  uint32_t num_counts_16 = 0;
+  uint32_t num_counts_32 = 0;
+  for (int e = 0; e < num_hyperedges; e++) {
+    const size_t he_size = hgraph->Vertices(e).size();
+    if (he_size <= std::numeric_limits<uint8_t>::max()) {
+      widths_[e] = kWidth8;
+      offsets_[e] = num_counts_8;
+      num_counts_8 += num_parts_;
+    } else if (he_size <= std::numeric_limits<uint16_t>::max()) {
+      widths_[e] = kWidth16;
+      offsets_[e] = num_counts_16;
+      num_counts_16 += num_parts_;
+    } else {
+      widths_[e] = kWidth32;
+      offsets_[e] = num_counts_32;
+      num_counts_32 += num_parts_;
+    }
+  }
+  counts_8_.resize(num_counts_8, 0);
+  counts_16_.resize(num_counts_16, 0);
+  counts_32_.resize(num_counts_32, 0);
+  block_sets_.resize(static_cast<size_t>(num_hyperedges) * num_words_, 0);
+  connectivity_.resize(num_hyperedges, 0);
+  for (int e = 0; e < num_hyperedges; e++) {
+    for (const int vertex_id : hgraph->Vertices(e)) {
+      IncreasePinCount(e, solution[vertex_id]);
+    }
+  }
+}
+
+std::vector<int> NetDegrees::GetPinCounts(const int e) const
+{
+  std::vector<int> pin_counts(num_parts_);
+  for (int block_id = 0; block_id < num_parts_; block_id++) {
+    pin_counts[block_id] = GetPinCount(e, block_id);
+  }
+  return pin_counts;
+}
+
+int NetDegrees::IncreasePinCount(const int e, const int block_id)
+{
+  const uint32_t offset = offsets_[e] + block_id;
+  int pin_count = 0;
+  switch (widths_[e]) {
+    case kWidth8:
+      pin_count = AddPinCount(counts_8_, offset, 1);
+      break;
+    case kWidth16:
+      pin_count = AddPinCount(counts_16_, offset, 1);
+      break;
+    default:
+      pin_count = AddPinCount(counts_32_, offset, 1);
+      break;
+  }
+  if (pin_count == 1) {
+    ToggleBlock(e, block_id, 1);  // the hyperedge enters block_id
+  }
+  return pin_count;
+}
+
+int NetDegrees::DecreasePinCount(const int e, const int block_id)
+{
+  const uint32_t offset = offsets_[e] + block_id;
+  int pin_count = 0;
+  switch (widths_[e]) {
+    case kWidth8:
+      pin_count = AddPinCount(counts_8_, offset, -1);
+      break;
+    case kWidth16:
+      pin_count = AddPinCount(counts_16_, offset, -1);
+      break;
+    default:
+      pin_count = AddPinCount(counts_32_, offset, -1);
+      break;
+  }
+  if (pin_count == 0) {
+    ToggleBlock(e, block_id, -1);  // the hyperedge leaves block_id
+  }
+  return pin_count;
+}
+
+template <typename T>
+T NetDegrees::AddPinCount(std::vector<T>& counts,
+                          const uint32_t offset,
+                          const int delta)
+{
+  counts[offset] += delta;
+  return counts[offset];
+}
+
+// Each transition 0 -> 1 or 1 -> 0 of a pin count flips the bit of the block.
+void NetDegrees::ToggleBlock(const int e,
+                             const int block_id,
+                             const int delta_connectivity)
+{
+  uint64_t& word = block_sets_[e * num_words_ + block_id / 64];
+  const uint64_t mask = 1ULL << (block_id % 64);
+  word ^= mask;
+  connectivity_[e] += delta_connectivity;
+}
+
+}  // namespace par
@@ -0,0 +1,91 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2022-2025, The OpenROAD Authors
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Hypergraph.h"
+
+namespace par {
+
+// --------------------------------------------------------------------------
+// The net degrees (pin counts) of all the hyperedges for a given solution,
+// i.e., the number of vertices of hyperedge e in each block.
+// All the counters are stored in flat arrays. The width of the counters of a
+// hyperedge (8, 16 or 32 bits) is chosen based on its size, such that the
+// counters of most hyperedges fit in a few bytes. Besides the counters, we
+// also maintain the set of blocks spanned by each hyperedge (a bitset) and
+// its connectivity, so checking whether a hyperedge is cut is O(1).
+// --------------------------------------------------------------------------
+class NetDegrees
+{
+ public:
+  NetDegrees() = default;
+  NetDegrees(int num_parts,
+             const HGraphPtr& hgraph,
+             const std::vector<int>& solution);
+
+  int GetNumParts() const { return num_parts_; }
+  int GetNumHyperedges() const { return static_cast<int>(offsets_.size()); }
+
+  // the number of vertices of hyperedge e in block_id
+  int GetPinCount(int e, int block_id) const
+  {
+    const uint32_t offset = offsets_[e] + block_id;
+    switch (widths_[e]) {
+      case kWidth8:
+        return counts_8_[offset];
+      case kWidth16:
+        return counts_16_[offset];
+      default:
+        return counts_32_[offset];
+    }
+  }
+
+  // the pin counts of hyperedge e in all the blocks
+  std::vector<int> GetPinCounts(int e) const;
+
+  // check if hyperedge e has any vertex in block_id
+  bool HasPins(int e, int block_id) const
+  {
+    return (block_sets_[e * num_words_ + block_id / 64]
+            >> (block_id % 64) & 1ULL)
+           != 0;
+  }
+
+  // the number of blocks spanned by hyperedge e
+  int GetConnectivity(int e) const { return connectivity_[e]; }
+
+  bool IsCut(int e) const { return connectivity_[e] > 1; }
+
+  // Update the pin counts of hyperedge e.
+  // Return the pin count of block_id after the update
+  int IncreasePinCount(int e, int block_id);
+  int DecreasePinCount(int e, int block_id);
+
+ private:
+  enum CounterWidth : uint8_t
+  {
+    kWidth8,
+    kWidth16,
+    kWidth32
+  };
+
+  template <typename T>
+  T AddPinCount(std::vector<T>& counts, uint32_t offset, int delta);
+  void ToggleBlock(int e, int block_id, int delta_connectivity);
+
+  int num_parts_ = 0;
+  int num_words_ = 0;  // number of 64-bit words of the bitset of a hyperedge
+  std::vector<uint32_t> offsets_;  // the first counter of each hyperedge
+  std::vector<CounterWidth> widths_;
+  std::vector<uint8_t> counts_8_;
+  std::vector<uint16_t> counts_16_;
+  std::vector<uint32_t> counts_32_;
+  std::vector<uint64_t> block_sets_;  // blocks spanned by each hyperedge
+  std::vector<uint16_t> connectivity_;
+};
+
+}  // namespace par
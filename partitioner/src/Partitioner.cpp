@@ -58,6 +58,21 @@ void Partitioner::Partition(const HGraphPtr& hgraph,
                             const Matrix<float>& lower_block_balance,
                             std::vector<int>& solution,
                             PartitionType partitioner_choice) const
+{
+  Partition(hgraph,
+            upper_block_balance,
+            lower_block_balance,
+            solution,
+            partitioner_choice,
+            seed_);
+}
+
+void Partitioner::Partition(const HGraphPtr& hgraph,
+                            const Matrix<float>& upper_block_balance,
+                            const Matrix<float>& lower_block_balance,
+                            std::vector<int>& solution,
+                            PartitionType partitioner_choice,
+                            const int seed) const
 {
   if (static_cast<int>(solution.size()) != hgraph->GetNumVertices()) {
     solution.clear();
@@ -66,12 +81,17 @@ void Partitioner::Partition(const HGraphPtr& hgraph,
   }
   switch (partitioner_choice) {
     case PartitionType::kInitRandom:
-      RandomPart(hgraph, upper_block_balance, lower_block_balance, solution);
+      RandomPart(
+          hgraph, upper_block_balance, lower_block_balance, solution, seed);
       break;
 
     case PartitionType::kInitRandomVile:
-      RandomPart(
-          hgraph, upper_block_balance, lower_block_balance, solution, true);
+      RandomPart(hgraph,
+                 upper_block_balance,
+                 lower_block_balance,
+                 solution,
+                 seed,
+                 true);
       break;
 
     case PartitionType::kInitVile:
@@ -83,7 +103,8 @@ void Partitioner::Partition(const HGraphPtr& hgraph,
       break;
 
     default:
-      RandomPart(hgraph, upper_block_balance, lower_block_balance, solution);
+      RandomPart(
+          hgraph, upper_block_balance, lower_block_balance, solution, seed);
       break;
   }
 }
@@ -101,6 +122,7 @@ void Partitioner::RandomPart(const HGraphPtr& hgraph,
                              const Matrix<float>& upper_block_balance,
                              const Matrix<float>& lower_block_balance,
                              std::vector<int>& solution,
+                             const int seed,
                              bool vile_mode) const
 {
   // the summation of vertex weights for vertices in current block
@@ -134,7 +156,7 @@ void Partitioner::RandomPart(const HGraphPtr& hgraph,
     }  // finish all the paths
     std::shuffle(path_vertices.begin(),
                  path_vertices.end(),
-                 std::default_random_engine(seed_));
+                 std::default_random_engine(seed));
   }
   // Step 3: check remaining vertices
   for (int v = 0; v < hgraph->GetNumVertices(); v++) {
@@ -143,7 +165,7 @@ void Partitioner::RandomPart(const HGraphPtr& hgraph,
     }
   }
   std::shuffle(
-      vertices.begin(), vertices.end(), std::default_random_engine(seed_));
+      vertices.begin(), vertices.end(), std::default_random_engine(seed));
   // Step 4: concatenate path_vertices and vertices
   // Here we insert path_vertices at the beginning,
   // Hopefully we can push all the path_vertices into one block
@@ -202,7 +224,7 @@ void Partitioner::ILPPart(const HGraphPtr& hgraph,
   std::vector<float> hyperedge_weights;  // one-dimensional
   // set vertices
   for (int v = 0; v < hgraph->GetNumVertices(); v++) {
-    vertex_weights.push_back(hgraph->GetVertexWeights(v));
+    vertex_weights.emplace_back(hgraph->GetVertexWeights(v));
   }
   // check fixed vertices
   if (hgraph->HasFixedVertices()) {
@@ -305,7 +327,8 @@ void Partitioner::ILPPart(const HGraphPtr& hgraph,
         "partitioning",
         1,
         "Optimal ILP-based Partitioning failed. Calling random partitioning.");
-    RandomPart(hgraph, upper_block_balance, lower_block_balance, solution);
+    RandomPart(
+        hgraph, upper_block_balance, lower_block_balance, solution, seed_);
   }
 }
 
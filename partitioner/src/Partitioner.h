@@ -50,6 +50,15 @@ class Partitioner
                  std::vector<int>& solution,
                  PartitionType partitioner_choice) const;
 
+  // Same as above, but use the given random seed instead of seed_,
+  // such that multiple random partitions can be generated concurrently
+  void Partition(const HGraphPtr& hgraph,
+                 const Matrix<float>& upper_block_balance,
+                 const Matrix<float>& lower_block_balance,
+                 std::vector<int>& solution,
+                 PartitionType partitioner_choice,
+                 int seed) const;
+
   void SetRandomSeed(int seed) { seed_ = seed; }
 
   void EnableIlpAcceleration(float acceleration_factor);
@@ -66,6 +75,7 @@ class Partitioner
                   const Matrix<float>& upper_block_balance,
                   const Matrix<float>& lower_block_balance,
                   std::vector<int>& solution,
+                  int seed,
                   bool vile_mode = false) const;
 
   // ILP-based partitioning
@@ -9,6 +9,7 @@
 
 #include "Hypergraph.h"
 #include "Utilities.h"
+#include "WeightVector.h"
 
 namespace par {
 
@@ -17,140 +18,146 @@ PriorityQueue::PriorityQueue(const int total_elements,
                              HGraphPtr hypergraph)
     : maximum_traverse_level_(maximum_traverse_level)
 {
-  vertices_map_.resize(total_elements);
-  std::fill(vertices_map_.begin(), vertices_map_.end(), -1);
-  total_elements_ = 0;
+  positions_.resize(total_elements, -1);
   hypergraph_ = std::move(hypergraph);
   active_ = false;
 }
 
+// only the vertices in the heap need to be reset
+// The capacity of the pool is kept, so the cells can be reused.
 void PriorityQueue::Clear()
 {
   active_ = false;
-  vertices_.clear();
-  total_elements_ = 0;
-  std::fill(vertices_map_.begin(), vertices_map_.end(), -1);
+  for (const auto& entry : heap_) {
+    positions_[entry.vertex] = -1;
+  }
+  heap_.clear();
+  cells_.clear();
+  free_slots_.clear();
 }
 
 // insert one element into the priority queue
-void PriorityQueue::InsertIntoPQ(const std::shared_ptr<VertexGain>& element)
+void PriorityQueue::InsertIntoPQ(VertexGain element)
 {
-  total_elements_++;
-  vertices_.push_back(element);
-  vertices_map_[element->GetVertex()] = total_elements_ - 1;
-  HeapifyUp(total_elements_ - 1);
+  const int vertex = element.GetVertex();
+  const float gain = element.GetGain();
+  int slot = -1;
+  if (free_slots_.empty()) {
+    slot = static_cast<int>(cells_.size());
+    cells_.push_back(std::move(element));
+  } else {
+    slot = free_slots_.back();
+    free_slots_.pop_back();
+    cells_[slot] = std::move(element);
+  }
+  heap_.push_back({gain, vertex, slot});
+  positions_[vertex] = static_cast<int>(heap_.size()) - 1;
+  HeapifyUp(positions_[vertex]);
 }
 
 // get the largest element
-std::shared_ptr<VertexGain> PriorityQueue::ExtractMax()
+VertexGain PriorityQueue::ExtractMax()
 {
-  auto max_element = vertices_.front();
-  // replace the first element with the last element, then
-  // call HeapifyDown to update the order of elements
-  vertices_[0] = vertices_[total_elements_ - 1];
-  vertices_map_[vertices_[total_elements_ - 1]->GetVertex()] = 0;
-  total_elements_--;
-  vertices_.pop_back();
-  HeapifyDown(0);
-  // Set location of this vertex to -1 in the map
-  vertices_map_[max_element->GetVertex()] = -1;
+  VertexGain max_element = std::move(cells_[heap_.front().slot]);
+  RemoveAt(0);
   return max_element;
 }
 
 // find the vertex gain which can satisfy the balance constraint
-std::shared_ptr<VertexGain> PriorityQueue::GetBestCandidate(
+VertexGain PriorityQueue::GetBestCandidate(
     const Matrix<float>& curr_block_balance,
     const Matrix<float>& upper_block_balance,
     const Matrix<float>& lower_block_balance,
-    const HGraphPtr& hgraph)
+    const HGraphPtr& hgraph) const
 {
-  if (total_elements_ <= 0) {               // empty
-    return std::make_shared<VertexGain>();  // return the dummy cell
+  const int total_elements = GetTotalElements();
+  if (total_elements <= 0) {  // empty
+    return VertexGain();      // return the dummy cell
   }
-  int pass = 0;
-  int candidate_index = -1;  // the index of the candidate vertex gain
-  int index = 0;             // starting from the first index
 
   // define the lambda function to check the balance constraint
   auto check_balance = [&](int index) {
-    const int vertex_id = vertices_[index]->GetVertex();
-    const int to_pid = vertices_[index]->GetDestinationPart();
-    const int from_pid = vertices_[index]->GetSourcePart();
-    if ((curr_block_balance[to_pid] + hgraph->GetVertexWeights(vertex_id)
-         < upper_block_balance[to_pid])
-        && (curr_block_balance[from_pid] - hgraph->GetVertexWeights(vertex_id)
-            > lower_block_balance[from_pid])) {
-      return true;
-    }
-    return false;
+    const int vertex_id = heap_[index].vertex;
+    const int to_pid = cells_[heap_[index].slot].GetDestinationPart();
+    const int from_pid = cells_[heap_[index].slot].GetSourcePart();
+    const WeightView vertex_weight = hgraph->GetVertexWeights(vertex_id);
+    WeightVector to_block_balance(curr_block_balance[to_pid]);
+    to_block_balance += vertex_weight;
+    WeightVector from_block_balance(curr_block_balance[from_pid]);
+    from_block_balance -= vertex_weight;
+    // all the dimensions below the upper bound,
+    // and above the lower bound in the lexicographic order
+    return to_block_balance < upper_block_balance[to_pid]
+           && LexicographicLess(lower_block_balance[from_pid],
+                                from_block_balance);
   };
 
   // check the first index
+  int index = 0;  // starting from the first index
   if (check_balance(index) == true) {
-    return vertices_[index];
+    return cells_[heap_[index].slot];
   }
 
   // traverse the max heap
-  while (pass < maximum_traverse_level_) {
-    pass++;
-    // Step 1: check the left child first
-    const int left_child = LeftChild(index);
-    if (left_child < total_elements_ && check_balance(left_child) == true) {
-      candidate_index = left_child;
+  for (int pass = 0; pass < maximum_traverse_level_; pass++) {
+    const int first_child = FirstChild(index);
+    if (first_child >= total_elements) {
+      break;  // no valid candidate
     }
-
-    // Step 2: check the right child second
-    const int right_child = RightChild(index);
-    if (right_child < total_elements_ && check_balance(right_child) == true
-        && (candidate_index == -1
-            || CompareElementLargeThan(right_child, candidate_index))) {
-      candidate_index = right_child;  // use the right index
+    const int last_child = std::min(first_child + kArity, total_elements);
+    // the best child satisfying the balance constraint
+    int candidate_index = -1;
+    // the best child, where the traversal continues
+    int best_child = first_child;
+    for (int child = first_child; child < last_child; child++) {
+      if (check_balance(child) == true
+          && (candidate_index == -1
+              || CompareElementLargeThan(heap_[child],
+                                         heap_[candidate_index]))) {
+        candidate_index = child;
+      }
+      if (CompareElementLargeThan(heap_[child], heap_[best_child])) {
+        best_child = child;
+      }
     }
-
-    if (candidate_index > 0) {
-      return vertices_[candidate_index];  // return the candidate gain cell
+    if (candidate_index > -1) {
+      return cells_[heap_[candidate_index].slot];  // the candidate gain cell
     }
-    if (left_child >= total_elements_ || right_child >= total_elements_) {
-      // no valid candidate
-      return std::make_shared<VertexGain>();  // return the dummy cell
+    // Same as the binary heap: the traversal stops at a node with missing
+    // children instead of continuing into them
+    if (last_child - first_child < kArity) {
+      break;  // no valid candidate
     }
-    index = CompareElementLargeThan(right_child, left_child) == true
-                ? right_child
-                : left_child;
+    index = best_child;
   }
-  return std::make_shared<VertexGain>();  // return the dummy cell
+  return VertexGain();  // return the dummy cell
 }
 
 // Remove the specifid vertex
 void PriorityQueue::Remove(int vertex_id)
 {
-  const int index = vertices_map_[vertex_id];
+  const int index = positions_[vertex_id];
   if (index == -1) {
     return;  // This vertex does not exists
   }
-  // set the gain of this element to maximum + 1
-  vertices_[index]->SetGain(GetMax()->GetGain() + 1.0);
-  // Shift the element to top of the heap
-  HeapifyUp(index);
-  // Extract the element from the heap
-  ExtractMax();
-  if (total_elements_ <= 0) {
+  RemoveAt(index);
+  if (heap_.empty()) {
     active_ = false;
   }
 }
 
 // Update the priority (gain) for the specified vertex
-void PriorityQueue::ChangePriority(
-    int vertex_id,
-    const std::shared_ptr<VertexGain>& new_element)
+void PriorityQueue::ChangePriority(int vertex_id, VertexGain new_element)
 {
-  const int index = vertices_map_[vertex_id];
+  const int index = positions_[vertex_id];
   if (index == -1) {
     return;  // This vertex does not exists
   }
-  const float old_priority = vertices_[index]->GetGain();
-  vertices_[index] = new_element;
-  if (new_element->GetGain() > old_priority) {
+  const float old_priority = heap_[index].gain;
+  const float new_priority = new_element.GetGain();
+  cells_[heap_[index].slot] = std::move(new_element);
+  heap_[index].gain = new_priority;
+  if (new_priority > old_priority) {
     HeapifyUp(index);
   } else {
     HeapifyDown(index);
@@ -164,68 +171,83 @@ void PriorityQueue::ChangePriority(
 // Compare the two elements
 // If the gains are equal then pick the vertex with the smaller weight
 // The hope is doing this will incentivize in preventing corking effect
-bool PriorityQueue::CompareElementLargeThan(int index_a, int index_b)
+bool PriorityQueue::CompareElementLargeThan(const HeapEntry& a,
+                                            const HeapEntry& b) const
 {
-  if (vertices_[index_a]->GetGain() > vertices_[index_b]->GetGain()) {
+  if (a.gain > b.gain) {
     return true;
   }
-  return (
-      (vertices_[index_a]->GetGain() == vertices_[index_b]->GetGain())
-      && (hypergraph_->GetVertexWeights(vertices_[index_a]->GetVertex())
-          < hypergraph_->GetVertexWeights(vertices_[index_b]->GetVertex())));
+  return (a.gain == b.gain)
+         && (hypergraph_->GetVertexWeights(a.vertex)
+             < hypergraph_->GetVertexWeights(b.vertex));
+}
+
+// Replace the element at location index with the last element,
+// then move the last element to its ordered location
+void PriorityQueue::RemoveAt(int index)
+{
+  positions_[heap_[index].vertex] = -1;
+  free_slots_.push_back(heap_[index].slot);
+  const HeapEntry last = heap_.back();
+  heap_.pop_back();
+  if (index == static_cast<int>(heap_.size())) {
+    return;  // the last element is removed
+  }
+  heap_[index] = last;
+  positions_[last.vertex] = index;
+  if (index > 0 && CompareElementLargeThan(last, heap_[Parent(index)])) {
+    HeapifyUp(index);
+  } else {
+    HeapifyDown(index);
+  }
 }
 
 // push the element at location index to its ordered location
-// This function is called when we insert a new element
+// The element is moved once at the end, and the elements on the way
+// are shifted down by one level
 void PriorityQueue::HeapifyUp(int index)
 {
-  while (index > 0 && CompareElementLargeThan(index, Parent(index)) == true) {
-    // Update the map (exchange parent and child)
-    auto& parent_heap_element = vertices_[Parent(index)];
-    auto& child_heap_element = vertices_[index];
-    vertices_map_[child_heap_element->GetVertex()] = Parent(index);
-    vertices_map_[parent_heap_element->GetVertex()] = index;
-    // Swap the elements
-    std::swap(parent_heap_element, child_heap_element);
-    // Next iteration
-    index = Parent(index);
+  const HeapEntry entry = heap_[index];
+  while (index > 0) {
+    const int parent = Parent(index);
+    if (CompareElementLargeThan(entry, heap_[parent]) == false) {
+      break;
+    }
+    heap_[index] = heap_[parent];
+    positions_[heap_[index].vertex] = index;
+    index = parent;
   }
+  heap_[index] = entry;
+  positions_[entry.vertex] = index;
 }
 
-// This function is called when we delete an existing element
+// push the element at location index down to its ordered location
 void PriorityQueue::HeapifyDown(int index)
 {
-  int max_index = index;
-
-  // Basically, we need order index, left child and right child
-  // Step 1: check if current index is less than left child
-  const int left_child = LeftChild(index);
-  if (left_child < total_elements_
-      && CompareElementLargeThan(left_child, max_index) == true) {
-    max_index = left_child;
-  }
-
-  // Step 2: check if the max index is less than right child
-  const int right_child = RightChild(index);
-  if (right_child < total_elements_
-      && CompareElementLargeThan(right_child, max_index) == true) {
-    max_index = right_child;
-  }
-
-  if (index == max_index) {
-    return;  // we do not need to further heapifydown
+  const int total_elements = GetTotalElements();
+  const HeapEntry entry = heap_[index];
+  while (true) {
+    const int first_child = FirstChild(index);
+    if (first_child >= total_elements) {
+      break;
+    }
+    // find the largest child
+    const int last_child = std::min(first_child + kArity, total_elements);
+    int max_child = first_child;
+    for (int child = first_child + 1; child < last_child; child++) {
+      if (CompareElementLargeThan(heap_[child], heap_[max_child]) == true) {
+        max_child = child;
+      }
+    }
+    if (CompareElementLargeThan(heap_[max_child], entry) == false) {
+      break;  // we do not need to further heapifydown
+    }
+    heap_[index] = heap_[max_child];
+    positions_[heap_[index].vertex] = index;
+    index = max_child;
   }
-
-  // swap index and max_index
-  auto& cur_heap_element = vertices_[index];
-  auto& large_heap_element = vertices_[max_index];
-  // Update the map
-  vertices_map_[cur_heap_element->GetVertex()] = max_index;
-  vertices_map_[large_heap_element->GetVertex()] = index;
-  // Swap the elements
-  std::swap(cur_heap_element, large_heap_element);
-  // Next recursive iteration
-  HeapifyDown(max_index);
+  heap_[index] = entry;
+  positions_[entry.vertex] = index;
 }
 
 }  // namespace par
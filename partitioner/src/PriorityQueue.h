@@ -3,10 +3,10 @@
 
 #pragma once
 
-#include <cmath>
+#include <array>
 #include <limits>
-#include <map>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "Hypergraph.h"
@@ -14,6 +14,53 @@
 
 namespace par {
 
+// The DELTA path cost of a move, i.e., a list of (path_id, delta) pairs.
+// Most vertices are only on a few timing paths, so the first few pairs are
+// stored inline without allocating memory. Without timing paths, the list
+// is always empty. The path ids in the list are unique.
+class PathCostDelta
+{
+ public:
+  using Element = std::pair<int, float>;
+
+  void PushBack(int path_id, float delta)
+  {
+    if (size_ < kInlineSize) {
+      inline_[size_++] = Element(path_id, delta);
+      return;
+    }
+    if (size_ == kInlineSize) {
+      // move all the pairs to overflow_
+      overflow_.assign(inline_.begin(), inline_.end());
+    }
+    overflow_.emplace_back(path_id, delta);
+    size_++;
+  }
+
+  void Clear()
+  {
+    size_ = 0;
+    overflow_.clear();
+  }
+
+  bool Empty() const { return size_ == 0; }
+  int Size() const { return size_; }
+  const Element& Back() const { return begin()[size_ - 1]; }
+
+  const Element* begin() const
+  {
+    return size_ <= kInlineSize ? inline_.data() : overflow_.data();
+  }
+  const Element* end() const { return begin() + size_; }
+
+ private:
+  static constexpr int kInlineSize = 4;
+
+  int size_ = 0;
+  std::array<Element, kInlineSize> inline_;
+  std::vector<Element> overflow_;  // all the pairs if size_ > kInlineSize
+};
+
 // Vertex Gain is the basic elements of FM
 // We do not use the classical gain-bucket data structure
 // We design our own priority-queue based gain-bucket data structure
@@ -28,7 +75,7 @@ class VertexGain
              int src_block_id,
              int destination_block_id,
              float gain,
-             const std::map<int, float>& path_cost);
+             PathCostDelta path_cost);
 
   // accessor functions
   int GetVertex() const { return vertex_; }
@@ -38,7 +85,7 @@ class VertexGain
   void SetGain(float gain) { gain_ = gain; }
 
   // get the delta path cost
-  const std::map<int, float>& GetPathCost() const { return path_cost_; }
+  const PathCostDelta& GetPathCost() const { return path_cost_; }
 
   int GetSourcePart() const { return source_part_; }
   int GetDestinationPart() const { return destination_part_; }
@@ -49,7 +96,7 @@ class VertexGain
   int destination_part_ = -1;  // the destination block id
   float gain_
       = -std::numeric_limits<float>::max();  // gain value of moving this vertex
-  std::map<int, float>
+  PathCostDelta
       path_cost_;  // the updated DELTA path cost after moving vertex
                    // the path_cost will change because we will dynamically
                    // update the the weight of the path based on the number of
@@ -58,9 +105,14 @@ class VertexGain
 
 // ------------------------------------------------------------
 // Priority-queue based gain bucket (Only for VertexGain)
-// Actually we implement the priority queue with Max Heap
-// We did not use the STL priority queue becuase we need
-// to record the location of each element (vertex gain)
+// Actually we implement the priority queue with an addressable 4-ary
+// Max Heap. We did not use the STL priority queue becuase we need
+// to record the location of each element (vertex gain).
+// The heap only stores (gain, vertex, slot) entries inline. The VertexGain
+// of each element is kept in a pool of cells (cells_[slot]) and does not
+// move while the vertex is in the heap. The slots of removed elements are
+// reused, so no memory is allocated once the pool has grown to the maximum
+// number of elements in the heap.
 // -------------------------------------------------------------
 class PriorityQueue
 {
@@ -70,37 +122,37 @@ class PriorityQueue
                 int maximum_traverse_level,
                 HGraphPtr hypergraph);
 
-  // insert one element (std::shared_ptr<VertexGain>) into the priority queue
-  void InsertIntoPQ(const std::shared_ptr<VertexGain>& element);
+  // insert one element (VertexGain) into the priority queue
+  void InsertIntoPQ(VertexGain element);
 
   // extract the largest element, i.e.,
   // get the largest element and remove it from the heap
-  std::shared_ptr<VertexGain> ExtractMax();
+  VertexGain ExtractMax();
 
   // get the largest element without removing it from the heap
-  std::shared_ptr<VertexGain> GetMax() { return vertices_.front(); }
+  const VertexGain& GetMax() const { return cells_[heap_.front().slot]; }
 
   // find the vertex gain which can satisfy the balance constraint
-  std::shared_ptr<VertexGain> GetBestCandidate(
+  // A dummy cell (vertex = -1) is returned if there is no such vertex gain
+  VertexGain GetBestCandidate(
       const Matrix<float>& curr_block_balance,
       const Matrix<float>& upper_block_balance,
       const Matrix<float>& lower_block_balance,
-      const HGraphPtr& hgraph);
+      const HGraphPtr& hgraph) const;
 
   // update the priority (gain) for the specified vertex
-  void ChangePriority(int vertex_id,
-                      const std::shared_ptr<VertexGain>& new_element);
+  void ChangePriority(int vertex_id, VertexGain new_element);
 
   // Remove the specified vertex
   void Remove(int vertex_id);
 
   // Basic accessors
-  bool CheckIfEmpty() const { return vertices_.empty(); }
-  int GetTotalElements() const { return total_elements_; }
-  // the size of the max heap
-  int GetSizeOfMap() const { return vertices_map_.size(); }
+  bool CheckIfEmpty() const { return heap_.empty(); }
+  int GetTotalElements() const { return static_cast<int>(heap_.size()); }
+  // the size of the map from vertices to their locations
+  int GetSizeOfMap() const { return positions_.size(); }
   // check if the vertex exists
-  bool CheckIfVertexExists(int v) const { return vertices_map_[v] > -1; }
+  bool CheckIfVertexExists(int v) const { return positions_[v] > -1; }
   // check the status of the heap
   void SetActive() { active_ = true; }
   void SetDeactive() { active_ = false; }
@@ -109,34 +161,45 @@ class PriorityQueue
   void Clear();
 
  private:
-  // The max heap (priority queue) is organized as a binary tree
-  // Get parent, left child and right child index
-  // Generic functions of max heap
-  int Parent(int element) const { return std::floor((element - 1) / 2); }
-
-  int LeftChild(int& element) const { return 2 * element + 1; }
-
-  int RightChild(int& element) const { return 2 * element + 2; }
-
-  // This is called when we add a new element
+  // The element of the max heap
+  struct HeapEntry
+  {
+    float gain;
+    int vertex;
+    int slot;  // the location of the VertexGain in cells_
+  };
+
+  // The number of children of each node.
+  // A wider heap is shallower, so fewer elements are moved on each update,
+  // and the children of a node share one cache line.
+  static constexpr int kArity = 4;
+
+  // Get parent and the first child index
+  static int Parent(int index) { return (index - 1) / kArity; }
+  static int FirstChild(int index) { return kArity * index + 1; }
+
+  // This is called when the priority of an element increases
   void HeapifyUp(int index);
 
-  // This is called when we remove an existing element
+  // This is called when the priority of an element decreases
   void HeapifyDown(int index);
 
+  // Remove the element at location index and release its slot
+  void RemoveAt(int index);
+
   // Compare the two elements
   // If the gains are equal then pick the vertex with the smaller weight
   // The hope is doing this will incentivize in preventing corking effect
-  bool CompareElementLargeThan(int index_a, int index_b);
+  bool CompareElementLargeThan(const HeapEntry& a, const HeapEntry& b) const;
 
   // private variables
-  bool active_;
+  bool active_ = false;
   HGraphPtr hypergraph_;
-  std::vector<std::shared_ptr<VertexGain>> vertices_;  // elements
-  std::vector<int> vertices_map_;  // store the location of vertex_gain for each
-                                   // vertex vertices_map_ always has the size
-                                   // of hypergraph_->num_vertices_
-  int total_elements_;             // number of elements in the priority queue
+  std::vector<HeapEntry> heap_;  // elements
+  // positions_ always has the size of hypergraph_->num_vertices_
+  std::vector<int> positions_;     // the location of each vertex in heap_
+  std::vector<VertexGain> cells_;  // the pool of gain cells
+  std::vector<int> free_slots_;    // the unused slots in cells_
   int maximum_traverse_level_ = 25;  // the maximum level of traversing the
                                      // buckets to solve the "corking effect"
 };
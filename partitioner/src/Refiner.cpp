@@ -3,15 +3,21 @@
 
 #include "Refiner.h"
 
+#include <algorithm>
+#include <cmath>
+#include <functional>
 #include <map>
 #include <memory>
+#include <numeric>
 #include <set>
 #include <utility>
 #include <vector>
 
 #include "Evaluator.h"
+#include "GainCache.h"
 #include "Hypergraph.h"
 #include "Utilities.h"
+#include "WeightVector.h"
 #include "utils/Logger.h"
 
 namespace par {
@@ -22,23 +28,23 @@ VertexGain::VertexGain(const int vertex,
                        const int src_block_id,
                        const int destination_block_id,
                        const float gain,
-                       const std::map<int, float>& path_cost)
+                       PathCostDelta path_cost)
     : vertex_(vertex),
       source_part_(src_block_id),
       destination_part_(destination_block_id),
       gain_(gain),
-      path_cost_(path_cost)
+      path_cost_(std::move(path_cost))
 {
 }
 
 HyperedgeGain::HyperedgeGain(const int hyperedge_id,
                              const int destination_part,
                              const float gain,
-                             const std::map<int, float>& path_cost)
+                             PathCostDelta path_cost)
     : hyperedge_id_(hyperedge_id),
       destination_part_(destination_part),
       gain_(gain),
-      path_cost_(path_cost)
+      path_cost_(std::move(path_cost))
 {
 }
 
@@ -94,25 +100,55 @@ void Refiner::RestoreDefaultParameters()
              refiner_iters_);
 }
 
+void Refiner::SetThreadPool(ThreadPoolPtr thread_pool)
+{
+  thread_pool_ = std::move(thread_pool);
+}
+
+void Refiner::RunTasks(const int num_tasks,
+                       const int workload,
+                       const std::function<void(int)>& task) const
+{
+  if (thread_pool_ == nullptr || workload < kMinParallelWorkload) {
+    for (int i = 0; i < num_tasks; i++) {
+      task(i);
+    }
+    return;
+  }
+  thread_pool_->ParallelFor(num_tasks, task);
+}
+
 // The main function of refinement class
 void Refiner::Refine(const HGraphPtr& hgraph,
                      const Matrix<float>& upper_block_balance,
                      const Matrix<float>& lower_block_balance,
                      Partitions& solution)
 {
-  if (max_move_ <= 0) {
+  Refine(hgraph, upper_block_balance, lower_block_balance, solution, max_move_);
+}
+
+void Refiner::Refine(const HGraphPtr& hgraph,
+                     const Matrix<float>& upper_block_balance,
+                     const Matrix<float>& lower_block_balance,
+                     Partitions& solution,
+                     const int max_move)
+{
+  if (max_move <= 0) {
     debugPrint(logger_,
                PAR,
                "refinement",
                1,
                "max_move = {}. Exiting Refinement.",
-               max_move_);
+               max_move);
     return;
   }
   // calculate the basic statistics of current solution
   Matrix<float> cur_block_balance
       = evaluator_->GetBlockBalance(hgraph, solution);
-  Matrix<int> net_degs = evaluator_->GetNetDegrees(hgraph, solution);
+  NetDegrees net_degs = evaluator_->GetNetDegrees(hgraph, solution);
+  // the gain cache is updated with net_degs during the whole refinement
+  GainCache gain_cache;
+  gain_cache.Initialize(num_parts_, hgraph, net_degs, evaluator_);
   std::vector<float> cur_paths_cost;
   if (hgraph->HasTiming()) {
     cur_paths_cost = evaluator_->GetPathsCost(hgraph, solution);
@@ -134,9 +170,11 @@ void Refiner::Refine(const HGraphPtr& hgraph,
                             lower_block_balance,
                             cur_block_balance,
                             net_degs,
+                            gain_cache,
                             cur_paths_cost,
                             solution,
-                            visited_vertices_flag);
+                            visited_vertices_flag,
+                            max_move);
     if (gain <= 0.0) {
       return;  // stop if there is no improvement
     }
@@ -202,31 +240,18 @@ float Refiner::CalculatePathCost(int path_id,
 // The boundary vertices do not include fixed vertices
 std::vector<int> Refiner::FindBoundaryVertices(
     const HGraphPtr& hgraph,
-    const Matrix<int>& net_degs,
+    const NetDegrees& net_degs,
     const std::vector<bool>& visited_vertices_flag) const
 {
-  // Step 1 : found all the boundary hyperedges
-  std::vector<bool> boundary_net_flag(hgraph->GetNumHyperedges(), false);
-  for (int e = 0; e < hgraph->GetNumHyperedges(); e++) {
-    int num_span_part = 0;
-    for (int i = 0; i < num_parts_; i++) {
-      if (net_degs[e][i] > 0) {
-        num_span_part++;
-        if (num_span_part >= 2) {
-          boundary_net_flag[e] = true;
-          break;
-        }
-      }
-    }
-  }
-  // Step 2: check all the non-fixed vertices
+  // check all the non-fixed vertices.
+  // A boundary hyperedge spans at least two blocks.
   std::vector<int> boundary_vertices;
   for (int v = 0; v < hgraph->GetNumVertices(); v++) {
     if (visited_vertices_flag[v] == true) {
       continue;  // This vertex has been visited
     }
     for (const int edge_id : hgraph->Edges(v)) {
-      if (boundary_net_flag[edge_id]) {
+      if (net_degs.IsCut(edge_id)) {
         boundary_vertices.push_back(v);
         break;
       }
@@ -237,27 +262,21 @@ std::vector<int> Refiner::FindBoundaryVertices(
 
 std::vector<int> Refiner::FindBoundaryVertices(
     const HGraphPtr& hgraph,
-    const Matrix<int>& net_degs,
+    const NetDegrees& net_degs,
     const std::vector<bool>& visited_vertices_flag,
     const std::vector<int>& solution,
     const std::pair<int, int>& partition_pair) const
 {
-  // Step 1 : found all the boundary hyperedges
-  std::vector<bool> boundary_net_flag(hgraph->GetNumHyperedges(), false);
-  for (int e = 0; e < hgraph->GetNumHyperedges(); e++) {
-    if (net_degs[e][partition_pair.first] > 0
-        && net_degs[e][partition_pair.second] > 0) {
-      boundary_net_flag[e] = true;
-    }
-  }
-  // Step 2: check all the non-fixed vertices
+  // check all the non-fixed vertices.
+  // A boundary hyperedge spans both blocks of partition_pair.
   std::vector<int> boundary_vertices;
   for (int v = 0; v < hgraph->GetNumVertices(); v++) {
     if (visited_vertices_flag[v] == true) {
       continue;
     }
     for (const int edge_id : hgraph->Edges(v)) {
-      if (boundary_net_flag[edge_id]) {
+      if (net_degs.HasPins(edge_id, partition_pair.first)
+          && net_degs.HasPins(edge_id, partition_pair.second)) {
         boundary_vertices.push_back(v);
         break;
       }
@@ -325,64 +344,104 @@ GainCell Refiner::CalculateVertexGain(int v,
                                       const HGraphPtr& hgraph,
                                       const std::vector<int>& solution,
                                       const std::vector<float>& cur_paths_cost,
-                                      const Matrix<int>& net_degs) const
+                                      const NetDegrees& net_degs) const
 {
   // We assume from_pid == solution[v] when we call CalculateGain
   // we need solution argument to update the score related to path
   float cut_score = 0.0;
-  float path_score = 0.0;
-  std::map<int, float>
-      delta_path_cost;       // map path_id to the change of path cost
-  if (from_pid == to_pid) {  // no gain for this case
-    return std::make_shared<VertexGain>(
-        v, from_pid, to_pid, 0.0f, delta_path_cost);
+  PathCostDelta delta_path_cost;  // the change of path cost of each path
+  if (from_pid == to_pid) {       // no gain for this case
+    return VertexGain(v, from_pid, to_pid, 0.0f, std::move(delta_path_cost));
   }
-  // define lambda function
-  // for checking connectivity (number of blocks connected by a hyperedge)
-  // function : check the connectivity for the hyperedge
-  auto get_connectivity = [&](int e) {
-    int connectivity = 0;
-    for (auto& num_v : net_degs[e]) {
-      if (num_v > 0) {
-        connectivity++;
-      }
-    }
-    return connectivity;
-  };
   // traverse all the hyperedges connected to v
   for (const int e : hgraph->Edges(v)) {
-    const int connectivity = get_connectivity(e);
+    // number of blocks connected by the hyperedge
+    const int connectivity = net_degs.GetConnectivity(e);
     const float e_score = evaluator_->CalculateHyperedgeCost(e, hgraph);
     if (connectivity == 0) {
       // ignore the hyperedge consisting of multiple vertices
       // ignore single-vertex hyperedge
       continue;
     }
-    if (connectivity == 1 && net_degs[e][from_pid] > 1) {
+    if (connectivity == 1 && net_degs.GetPinCount(e, from_pid) > 1) {
       // move from_pid to to_pid will have negative score
       // all the vertices are with block from_id
       cut_score -= e_score;
-    } else if (connectivity == 2 && net_degs[e][from_pid] == 1
-               && net_degs[e][to_pid] > 0) {
+    } else if (connectivity == 2 && net_degs.GetPinCount(e, from_pid) == 1
+               && net_degs.HasPins(e, to_pid)) {
       // all the vertices excluding v are all within block to_pid
       // move from_pid to to_pid will increase the score
       cut_score += e_score;
     }
   }
   // check the timing path
+  const float path_score = CalculatePathGain(
+      v, to_pid, hgraph, solution, cur_paths_cost, delta_path_cost);
+  const float score = cut_score + path_score;
+  return VertexGain(v, from_pid, to_pid, score, std::move(delta_path_cost));
+}
+
+GainCell Refiner::CalculateCachedVertexGain(
+    int v,
+    int from_pid,
+    int to_pid,
+    const HGraphPtr& hgraph,
+    const std::vector<int>& solution,
+    const std::vector<float>& cur_paths_cost,
+    const NetDegrees& net_degs,
+    const GainCache& gain_cache) const
+{
+  PathCostDelta delta_path_cost;  // the change of path cost of each path
+  if (from_pid == to_pid) {       // no gain for this case
+    return VertexGain(v, from_pid, to_pid, 0.0f, std::move(delta_path_cost));
+  }
+  const float cut_score = gain_cache.GetCutGain(v, to_pid);
+  const float path_score = CalculatePathGain(
+      v, to_pid, hgraph, solution, cur_paths_cost, delta_path_cost);
+  const float score = cut_score + path_score;
+  if (logger_->debugCheck(PAR, "gain_cache", 1)) {
+    const float expected_score
+        = CalculateVertexGain(
+              v, from_pid, to_pid, hgraph, solution, cur_paths_cost, net_degs)
+              .GetGain();
+    const float tolerance = 1e-4 * std::max(1.0f, std::abs(expected_score));
+    if (std::abs(score - expected_score) > tolerance) {
+      logger_->report(
+          "[WARNING] Gain cache mismatch : vertex = {}, from_pid = {}, "
+          "to_pid = {}, cached gain = {}, expected gain = {}",
+          v,
+          from_pid,
+          to_pid,
+          score,
+          expected_score);
+    }
+  }
+  return VertexGain(v, from_pid, to_pid, score, std::move(delta_path_cost));
+}
+
+float Refiner::CalculatePathGain(int v,
+                                 int to_pid,
+                                 const HGraphPtr& hgraph,
+                                 const std::vector<int>& solution,
+                                 const std::vector<float>& cur_paths_cost,
+                                 PathCostDelta& delta_path_cost) const
+{
+  float path_score = 0.0;
   if (hgraph->GetNumTimingPaths() > 0) {
     for (const int path_id : hgraph->TimingPathsThrough(v)) {
       // Get updated path costs if vertex is moved to a different partition
       const float cost
           = CalculatePathCost(path_id, hgraph, solution, v, to_pid);
-      delta_path_cost[path_id] = cost - cur_paths_cost[path_id];
+      // A coarse vertex can appear several times in a path. The path ids
+      // through v are sorted, so the repeated ones are adjacent.
+      if (delta_path_cost.Empty() || delta_path_cost.Back().first != path_id) {
+        delta_path_cost.PushBack(path_id, cost - cur_paths_cost[path_id]);
+      }
       // gain accomodates for the change in the cost of the timing path
       path_score += cur_paths_cost[path_id] - cost;  // score in minus cost
     }
   }
-  const float score = cut_score + path_score;
-  return std::make_shared<VertexGain>(
-      v, from_pid, to_pid, score, delta_path_cost);
+  return path_score;
 }
 
 // move one vertex based on the calculated gain_cell
@@ -393,30 +452,27 @@ void Refiner::AcceptVertexGain(const GainCell& gain_cell,
                                std::vector<int>& solution,
                                std::vector<float>& cur_paths_cost,
                                Matrix<float>& curr_block_balance,
-                               Matrix<int>& net_degs) const
+                               NetDegrees& net_degs,
+                               GainCache& gain_cache) const
 {
-  const int vertex_id = gain_cell->GetVertex();
+  const int vertex_id = gain_cell.GetVertex();
   visited_vertices_flag[vertex_id] = true;
-  total_delta_gain += gain_cell->GetGain();  // increase the total gain
+  total_delta_gain += gain_cell.GetGain();  // increase the total gain
   // Update the path cost first
-  for (const auto& [path_id, delta_path_cost] : gain_cell->GetPathCost()) {
+  for (const auto& [path_id, delta_path_cost] : gain_cell.GetPathCost()) {
     cur_paths_cost[path_id] += delta_path_cost;
   }
   // get partition id
-  const int pre_part_id = gain_cell->GetSourcePart();
-  const int new_part_id = gain_cell->GetDestinationPart();
+  const int pre_part_id = gain_cell.GetSourcePart();
+  const int new_part_id = gain_cell.GetDestinationPart();
   // update the solution vector
   solution[vertex_id] = new_part_id;
   // Update the partition balance
-  curr_block_balance[pre_part_id]
-      = curr_block_balance[pre_part_id] - hgraph->GetVertexWeights(vertex_id);
-  curr_block_balance[new_part_id]
-      = curr_block_balance[new_part_id] + hgraph->GetVertexWeights(vertex_id);
-  // update net_degs
-  for (const int he : hgraph->Edges(vertex_id)) {
-    --net_degs[he][pre_part_id];
-    ++net_degs[he][new_part_id];
-  }
+  Subtract(curr_block_balance[pre_part_id], hgraph->GetVertexWeights(vertex_id));
+  Accumulate(curr_block_balance[new_part_id],
+             hgraph->GetVertexWeights(vertex_id));
+  // update net_degs and the gain cache
+  gain_cache.MoveVertex(vertex_id, pre_part_id, new_part_id, hgraph, net_degs);
 }
 
 // restore one vertex based on the calculated gain_cell
@@ -426,29 +482,26 @@ void Refiner::RollBackVertexGain(const GainCell& gain_cell,
                                  std::vector<int>& solution,
                                  std::vector<float>& cur_paths_cost,
                                  Matrix<float>& curr_block_balance,
-                                 Matrix<int>& net_degs) const
+                                 NetDegrees& net_degs,
+                                 GainCache& gain_cache) const
 {
-  const int vertex_id = gain_cell->GetVertex();
+  const int vertex_id = gain_cell.GetVertex();
   visited_vertices_flag[vertex_id] = false;
   // Update the path cost first
-  for (const auto& [path_id, delta_path_cost] : gain_cell->GetPathCost()) {
+  for (const auto& [path_id, delta_path_cost] : gain_cell.GetPathCost()) {
     cur_paths_cost[path_id] -= delta_path_cost;
   }
   // get partition id
-  const int pre_part_id = gain_cell->GetSourcePart();
-  const int new_part_id = gain_cell->GetDestinationPart();
+  const int pre_part_id = gain_cell.GetSourcePart();
+  const int new_part_id = gain_cell.GetDestinationPart();
   // update the solution vector
   solution[vertex_id] = pre_part_id;
   // Update the partition balance
-  curr_block_balance[pre_part_id]
-      = curr_block_balance[pre_part_id] + hgraph->GetVertexWeights(vertex_id);
-  curr_block_balance[new_part_id]
-      = curr_block_balance[new_part_id] - hgraph->GetVertexWeights(vertex_id);
-  // update net_degs
-  for (const int he : hgraph->Edges(vertex_id)) {
-    ++net_degs[he][pre_part_id];
-    --net_degs[he][new_part_id];
-  }
+  Accumulate(curr_block_balance[pre_part_id],
+             hgraph->GetVertexWeights(vertex_id));
+  Subtract(curr_block_balance[new_part_id], hgraph->GetVertexWeights(vertex_id));
+  // update net_degs and the gain cache
+  gain_cache.MoveVertex(vertex_id, new_part_id, pre_part_id, hgraph, net_degs);
 }
 
 // check if we can move the vertex to some block
@@ -462,52 +515,59 @@ bool Refiner::CheckVertexMoveLegality(
     const Matrix<float>& upper_block_balance,
     const Matrix<float>& lower_block_balance) const
 {
-  const std::vector<float> total_wt_to_block
-      = curr_block_balance[to_pid] + hgraph->GetVertexWeights(v);
-  const std::vector<float> total_wt_from_block
-      = curr_block_balance[from_pid] - hgraph->GetVertexWeights(v);
-  return total_wt_to_block <= upper_block_balance[to_pid]
-         && lower_block_balance[from_pid] <= total_wt_from_block;
+  const WeightView vertex_weight = hgraph->GetVertexWeights(v);
+  WeightVector total_wt_to_block(curr_block_balance[to_pid]);
+  total_wt_to_block += vertex_weight;
+  WeightVector total_wt_from_block(curr_block_balance[from_pid]);
+  total_wt_from_block -= vertex_weight;
+  // total_wt_to_block <= upper and lower <= total_wt_from_block
+  return !LexicographicLess(upper_block_balance[to_pid], total_wt_to_block)
+         && !LexicographicLess(total_wt_from_block,
+                               lower_block_balance[from_pid]);
 }
 
 // calculate the possible gain of moving a entire hyperedge
 // We can view the process of moving the vertices in hyperege
 // one by one, then restore the moving sequence to make sure that
 // the current status is not changed. Solution should not be const
-HyperedgeGainPtr Refiner::CalculateHyperedgeGain(
+HyperedgeGain Refiner::CalculateHyperedgeGain(
     int hyperedge_id,
     int to_pid,
     const HGraphPtr& hgraph,
     std::vector<int>& solution,
     const std::vector<float>& cur_paths_cost,
-    const Matrix<int>& net_degs) const
+    const NetDegrees& net_degs,
+    const GainCache& gain_cache) const
 {
   // We assume from_pid == solution[v] when we call CalculateGain
   // we need solution argument to update the score related to path
   float cut_score = 0.0;
   float path_score = 0.0;
   float score = 0.0;
-  std::map<int, float>
-      delta_path_cost;  // map path_id to the change of path cost
+  PathCostDelta delta_path_cost;  // the change of path cost of each path
   // find the all the vertices of hyperedge,
   // which are not in the to_pid block
   std::vector<std::pair<int, int>> vertices;  // vertex_id, from_pid
-  // We need to modify these net degrees
-  std::map<int, std::vector<int>> net_deg_map;
   for (const int vertex_id : hgraph->Vertices(hyperedge_id)) {
     if (solution[vertex_id] != to_pid) {
       vertices.emplace_back(vertex_id, solution[vertex_id]);
-      for (const int e : hgraph->Edges(vertex_id)) {
+    }
+  }
+  if (vertices.empty() == true) {
+    return HyperedgeGain(
+        hyperedge_id, to_pid, score, std::move(delta_path_cost));
+  }
+  // We need to modify these net degrees
+  std::map<int, std::vector<int>> net_deg_map;
+  if (vertices.size() > 1) {
+    for (const auto& vertex_pair : vertices) {
+      for (const int e : hgraph->Edges(vertex_pair.first)) {
         if (net_deg_map.find(e) == net_deg_map.end()) {
-          net_deg_map[e] = net_degs[e];
+          net_deg_map[e] = net_degs.GetPinCounts(e);
         }
       }
     }
   }
-  if (vertices.empty() == true) {
-    return std::make_shared<HyperedgeGain>(
-        hyperedge_id, to_pid, score, delta_path_cost);
-  }
   // define lambda function
   // for checking connectivity (number of blocks connected by a hyperedge)
   // function : check the connectivity for the hyperedge
@@ -522,30 +582,36 @@ HyperedgeGainPtr Refiner::CalculateHyperedgeGain(
   };
   // check all the vertices
   // Step 1: check the cut cost
-  for (const auto& vertex_pair : vertices) {
-    const int v = vertex_pair.first;
-    const int from_pid = vertex_pair.second;
-    // traverse all the hyperedges connected to v
-    for (const int e : hgraph->Edges(v)) {
-      const int connectivity = get_connectivity(e);
-      const float e_score = evaluator_->CalculateHyperedgeCost(e, hgraph);
-      if (connectivity == 0) {
-        // ignore the hyperedge consisting of multiple vertices
-        // ignore single-vertex hyperedge
-        continue;
-      }
-      if (connectivity == 1 && net_deg_map[e][from_pid] > 1) {
-        // move from_pid to to_pid will have negative score
-        // all the vertices are with block from_id
-        cut_score -= e_score;
-      } else if (connectivity == 2 && net_deg_map[e][from_pid] == 1
-                 && net_deg_map[e][to_pid] > 0) {
-        // all the vertices excluding v are all within block to_pid
-        // move from_pid to to_pid will increase the score
-        cut_score += e_score;
+  // Moving a single vertex is the most common case (e.g., two-pin nets),
+  // where the cut cost is available in the gain cache
+  if (vertices.size() == 1) {
+    cut_score = gain_cache.GetCutGain(vertices.front().first, to_pid);
+  } else {
+    for (const auto& vertex_pair : vertices) {
+      const int v = vertex_pair.first;
+      const int from_pid = vertex_pair.second;
+      // traverse all the hyperedges connected to v
+      for (const int e : hgraph->Edges(v)) {
+        const int connectivity = get_connectivity(e);
+        const float e_score = evaluator_->CalculateHyperedgeCost(e, hgraph);
+        if (connectivity == 0) {
+          // ignore the hyperedge consisting of multiple vertices
+          // ignore single-vertex hyperedge
+          continue;
+        }
+        if (connectivity == 1 && net_deg_map[e][from_pid] > 1) {
+          // move from_pid to to_pid will have negative score
+          // all the vertices are with block from_id
+          cut_score -= e_score;
+        } else if (connectivity == 2 && net_deg_map[e][from_pid] == 1
+                   && net_deg_map[e][to_pid] > 0) {
+          // all the vertices excluding v are all within block to_pid
+          // move from_pid to to_pid will increase the score
+          cut_score += e_score;
+        }
+        net_deg_map[e][from_pid]--;
+        net_deg_map[e][to_pid]++;
       }
-      net_deg_map[e][from_pid]--;
-      net_deg_map[e][to_pid]++;
     }
   }
   // Step 2: check timing cost
@@ -554,19 +620,37 @@ HyperedgeGainPtr Refiner::CalculateHyperedgeGain(
     for (const auto& vertex_pair : vertices) {
       solution[vertex_pair.first] = to_pid;
     }
+    // A path may go through several vertices of the hyperedge.
+    // Only the first (path_id, vertex) pair of each path is kept,
+    // in the order of traversal.
+    std::vector<std::pair<int, int>> path_vertices;  // path_id, vertex_id
     for (const auto& vertex_pair : vertices) {
-      const int v = vertex_pair.first;
-      for (const int path_id : hgraph->TimingPathsThrough(v)) {
-        if (delta_path_cost.find(path_id) == delta_path_cost.end()) {
-          // Get updated path costs if vertex is moved to a different partition
-          const float cost
-              = CalculatePathCost(path_id, hgraph, solution, v, to_pid);
-          delta_path_cost[path_id] = cost - cur_paths_cost[path_id];
-          // gain accomodates for the change in the cost of the timing path
-          path_score += cur_paths_cost[path_id] - cost;  // score in minus cost
-        }
+      for (const int path_id : hgraph->TimingPathsThrough(vertex_pair.first)) {
+        path_vertices.emplace_back(path_id, vertex_pair.first);
       }
     }
+    std::vector<int> order(path_vertices.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+      return path_vertices[a].first < path_vertices[b].first;
+    });
+    order.erase(std::unique(order.begin(),
+                            order.end(),
+                            [&](int a, int b) {
+                              return path_vertices[a].first
+                                     == path_vertices[b].first;
+                            }),
+                order.end());
+    std::sort(order.begin(), order.end());
+    for (const int id : order) {
+      const auto [path_id, v] = path_vertices[id];
+      // Get updated path costs if vertex is moved to a different partition
+      const float cost
+          = CalculatePathCost(path_id, hgraph, solution, v, to_pid);
+      delta_path_cost.PushBack(path_id, cost - cur_paths_cost[path_id]);
+      // gain accomodates for the change in the cost of the timing path
+      path_score += cur_paths_cost[path_id] - cost;  // score in minus cost
+    }
     // restore the solution to from_id
     for (const auto& vertex_pair : vertices) {
       solution[vertex_pair.first] = vertex_pair.second;
@@ -574,27 +658,27 @@ HyperedgeGainPtr Refiner::CalculateHyperedgeGain(
   }
 
   score = cut_score + path_score;
-  return std::make_shared<HyperedgeGain>(
-      hyperedge_id, to_pid, score, delta_path_cost);
+  return HyperedgeGain(hyperedge_id, to_pid, score, std::move(delta_path_cost));
 }
 
 // accpet the hyperedge gain
-void Refiner::AcceptHyperedgeGain(const HyperedgeGainPtr& hyperedge_gain,
+void Refiner::AcceptHyperedgeGain(const HyperedgeGain& hyperedge_gain,
                                   const HGraphPtr& hgraph,
                                   float& total_delta_gain,
                                   std::vector<int>& solution,
                                   std::vector<float>& cur_paths_cost,
                                   Matrix<float>& cur_block_balance,
-                                  Matrix<int>& net_degs) const
+                                  NetDegrees& net_degs,
+                                  GainCache& gain_cache) const
 {
-  const int hyperedge_id = hyperedge_gain->GetHyperedge();
-  total_delta_gain += hyperedge_gain->GetGain();
+  const int hyperedge_id = hyperedge_gain.GetHyperedge();
+  total_delta_gain += hyperedge_gain.GetGain();
   // Update the path cost first
-  for (const auto& [path_id, delta_path_cost] : hyperedge_gain->GetPathCost()) {
+  for (const auto& [path_id, delta_path_cost] : hyperedge_gain.GetPathCost()) {
     cur_paths_cost[path_id] += delta_path_cost;
   }
   // get block id
-  const int new_part_id = hyperedge_gain->GetDestinationPart();
+  const int new_part_id = hyperedge_gain.GetDestinationPart();
   // update the solution vector block_balance and net_degs
   for (const int vertex_id : hgraph->Vertices(hyperedge_id)) {
     const int pre_part_id = solution[vertex_id];
@@ -604,16 +688,14 @@ void Refiner::AcceptHyperedgeGain(const HyperedgeGainPtr& hyperedge_gain,
     // update solution
     solution[vertex_id] = new_part_id;
     // Update the partition balance
-    cur_block_balance[pre_part_id]
-        = cur_block_balance[pre_part_id] - hgraph->GetVertexWeights(vertex_id);
-    cur_block_balance[new_part_id]
-        = cur_block_balance[new_part_id] + hgraph->GetVertexWeights(vertex_id);
-    // update net_degs
+    Subtract(cur_block_balance[pre_part_id],
+             hgraph->GetVertexWeights(vertex_id));
+    Accumulate(cur_block_balance[new_part_id],
+               hgraph->GetVertexWeights(vertex_id));
+    // update net_degs and the gain cache
     // not just this hyperedge, we need to update all the related hyperedges
-    for (const int he : hgraph->Edges(vertex_id)) {
-      --net_degs[he][pre_part_id];
-      ++net_degs[he][new_part_id];
-    }
+    gain_cache.MoveVertex(
+        vertex_id, pre_part_id, new_part_id, hgraph, net_degs);
   }
 }
 
@@ -626,7 +708,11 @@ bool Refiner::CheckHyperedgeMoveLegality(
     const Matrix<float>& upper_block_balance,
     const Matrix<float>& lower_block_balance) const
 {
-  Matrix<float> update_block_balance = curr_block_balance;
+  std::vector<WeightVector> update_block_balance;
+  update_block_balance.reserve(curr_block_balance.size());
+  for (const auto& block_balance : curr_block_balance) {
+    update_block_balance.emplace_back(block_balance);
+  }
   for (const int v : hgraph->Vertices(e)) {
     // check if satisfies the fixed vertices constraint
     if (hgraph->HasFixedVertices() && hgraph->GetFixedAttr(v) != to_pid) {
@@ -634,10 +720,8 @@ bool Refiner::CheckHyperedgeMoveLegality(
     }
     const int pid = solution[v];
     if (solution[v] != to_pid) {
-      update_block_balance[to_pid]
-          = update_block_balance[to_pid] + hgraph->GetVertexWeights(v);
-      update_block_balance[pid]
-          = update_block_balance[pid] - hgraph->GetVertexWeights(v);
+      update_block_balance[to_pid] += hgraph->GetVertexWeights(v);
+      update_block_balance[pid] -= hgraph->GetVertexWeights(v);
     }
   }
   // Violate the upper bound
@@ -3,24 +3,25 @@
 
 #pragma once
 
+#include <functional>
 #include <map>
 #include <memory>
 #include <utility>
 #include <vector>
 
 #include "Evaluator.h"
+#include "GainCache.h"
 #include "Hypergraph.h"
 #include "PriorityQueue.h"
+#include "ThreadPool.h"
 #include "Utilities.h"
 #include "utils/Logger.h"
 
 namespace par {
 
-class VertexGain;
-using GainCell = std::shared_ptr<VertexGain>;  // for abbreviation
-
-class HyperedgeGain;
-using HyperedgeGainPtr = std::shared_ptr<HyperedgeGain>;
+// The gain cells are plain values, so calculating a gain does not allocate
+// memory (except for vertices on many timing paths)
+using GainCell = VertexGain;  // for abbreviation
 
 // Priority-queue based gain bucket
 using GainBucket = std::shared_ptr<PriorityQueue>;
@@ -32,10 +33,11 @@ using GainBuckets = std::vector<GainBucket>;
 class HyperedgeGain
 {
  public:
+  HyperedgeGain() = default;
   HyperedgeGain(int hyperedge_id,
                 int destination_part,
                 float gain,
-                const std::map<int, float>& path_cost);
+                PathCostDelta path_cost);
 
   float GetGain() const { return gain_; }
   void SetGain(float gain) { gain_ = gain; }
@@ -44,17 +46,17 @@ class HyperedgeGain
 
   int GetDestinationPart() const { return destination_part_; }
 
-  const std::map<int, float>& GetPathCost() const { return path_cost_; }
+  const PathCostDelta& GetPathCost() const { return path_cost_; }
 
  private:
-  const int hyperedge_id_ = -1;
-  const int destination_part_ = -1;  // the destination block id
+  int hyperedge_id_ = -1;
+  int destination_part_ = -1;  // the destination block id
   float gain_ = 0.0;
 
   // The updated DELTA path cost after moving vertex the path_cost
   // will change because we will dynamically update the the weight of
   // the path based on the number of the cut on the path
-  const std::map<int, float> path_cost_;
+  PathCostDelta path_cost_;
 };
 
 // ------------------------------------------------------------------------
@@ -85,22 +87,45 @@ class Refiner
               const Matrix<float>& lower_block_balance,
               Partitions& solution);
 
+  // Same as above, but use max_move instead of max_move_.
+  // The state of the refiner is not changed, so multiple solutions can be
+  // refined concurrently with different max_move.
+  void Refine(const HGraphPtr& hgraph,
+              const Matrix<float>& upper_block_balance,
+              const Matrix<float>& lower_block_balance,
+              Partitions& solution,
+              int max_move);
+
   void SetMaxMove(int max_move);
   void SetRefineIters(int refiner_iters);
 
   void RestoreDefaultParameters();
 
+  // The refiner dispatches its per-block work to the thread pool.
+  // Without a thread pool, all the work is done in the calling thread.
+  void SetThreadPool(ThreadPoolPtr thread_pool);
+
  protected:
   virtual float Pass(const HGraphPtr& hgraph,
                      const Matrix<float>& upper_block_balance,
                      const Matrix<float>& lower_block_balance,
                      Matrix<float>& block_balance,  // the current block balance
-                     Matrix<int>& net_degs,         // the current net degree
+                     NetDegrees& net_degs,          // the current net degree
+                     GainCache& gain_cache,         // the cached cut gain
                      std::vector<float>& paths_cost,  // the current path cost
                      Partitions& solution,
-                     std::vector<bool>& visited_vertices_flag)
+                     std::vector<bool>& visited_vertices_flag,
+                     int max_move)  // the maximum number of moves
       = 0;
 
+  // Run task(0), ..., task(num_tasks - 1) on the thread pool.
+  // workload is a rough estimation of the work in each task (e.g. the number
+  // of vertices to be updated). Small workloads are executed inline, because
+  // dispatching them costs more than the work itself.
+  void RunTasks(int num_tasks,
+                int workload,
+                const std::function<void(int)>& task) const;
+
   // If to_pid == -1, we are calculate the current cost of the path;
   // else if to_pid != -1, we are calculate the cost of the path
   // after moving v to block to_pid
@@ -114,12 +139,12 @@ class Refiner
   // fixed vertices
   std::vector<int> FindBoundaryVertices(
       const HGraphPtr& hgraph,
-      const Matrix<int>& net_degs,
+      const NetDegrees& net_degs,
       const std::vector<bool>& visited_vertices_flag) const;
 
   std::vector<int> FindBoundaryVertices(
       const HGraphPtr& hgraph,
-      const Matrix<int>& net_degs,
+      const NetDegrees& net_degs,
       const std::vector<bool>& visited_vertices_flag,
       const std::vector<int>& solution,
       const std::pair<int, int>& partition_pair) const;
@@ -155,7 +180,29 @@ class Refiner
                                const HGraphPtr& hgraph,
                                const std::vector<int>& solution,
                                const std::vector<float>& cur_paths_cost,
-                               const Matrix<int>& net_degs) const;
+                               const NetDegrees& net_degs) const;
+
+  // Same as CalculateVertexGain, but the cut score is read from the gain
+  // cache instead of traversing all the hyperedges connected to v.
+  // With "set_debug_level PAR gain_cache 1", the cached value is checked
+  // against CalculateVertexGain.
+  GainCell CalculateCachedVertexGain(int v,
+                                     int from_pid,
+                                     int to_pid,
+                                     const HGraphPtr& hgraph,
+                                     const std::vector<int>& solution,
+                                     const std::vector<float>& cur_paths_cost,
+                                     const NetDegrees& net_degs,
+                                     const GainCache& gain_cache) const;
+
+  // Calculate the path score of moving v to block to_pid
+  // and record the change of the path cost in delta_path_cost
+  float CalculatePathGain(int v,
+                          int to_pid,
+                          const HGraphPtr& hgraph,
+                          const std::vector<int>& solution,
+                          const std::vector<float>& cur_paths_cost,
+                          PathCostDelta& delta_path_cost) const;
 
   // accept the vertex gain
   void AcceptVertexGain(const GainCell& gain_cell,
@@ -165,7 +212,8 @@ class Refiner
                         std::vector<int>& solution,
                         std::vector<float>& cur_paths_cost,
                         Matrix<float>& curr_block_balance,
-                        Matrix<int>& net_degs) const;
+                        NetDegrees& net_degs,
+                        GainCache& gain_cache) const;
 
   // restore the vertex gain
   void RollBackVertexGain(const GainCell& gain_cell,
@@ -174,7 +222,8 @@ class Refiner
                           std::vector<int>& solution,
                           std::vector<float>& cur_paths_cost,
                           Matrix<float>& curr_block_balance,
-                          Matrix<int>& net_degs) const;
+                          NetDegrees& net_degs,
+                          GainCache& gain_cache) const;
 
   // check if we can move the vertex to some block
   bool CheckVertexMoveLegality(int v,         // vertex_id
@@ -190,13 +239,14 @@ class Refiner
   // one by one, then restore the moving sequence to make sure that
   // the current status is not changed. Solution should not be const
   // calculate the possible gain of moving a hyperedge
-  HyperedgeGainPtr CalculateHyperedgeGain(
+  HyperedgeGain CalculateHyperedgeGain(
       int hyperedge_id,
       int to_pid,
       const HGraphPtr& hgraph,
       std::vector<int>& solution,
       const std::vector<float>& cur_paths_cost,
-      const Matrix<int>& net_degs) const;
+      const NetDegrees& net_degs,
+      const GainCache& gain_cache) const;
 
   // check if we can move the hyperegde into some block
   bool CheckHyperedgeMoveLegality(
@@ -209,13 +259,14 @@ class Refiner
       const Matrix<float>& lower_block_balance) const;
 
   // accpet the hyperedge gain
-  void AcceptHyperedgeGain(const HyperedgeGainPtr& hyperedge_gain,
+  void AcceptHyperedgeGain(const HyperedgeGain& hyperedge_gain,
                            const HGraphPtr& hgraph,
                            float& total_delta_gain,
                            std::vector<int>& solution,
                            std::vector<float>& cur_paths_cost,
                            Matrix<float>& cur_block_balance,
-                           Matrix<int>& net_degs) const;
+                           NetDegrees& net_degs,
+                           GainCache& gain_cache) const;
 
   // Note that there is no RollBackHyperedgeGain
   // Because we only use greedy hyperedge refinement
@@ -244,6 +295,9 @@ class Refiner
 
   par::Logger* logger_ = nullptr;
   EvaluatorPtr evaluator_ = nullptr;
+  ThreadPoolPtr thread_pool_ = nullptr;
+  // the minimum workload of a task to be dispatched to the thread pool
+  static constexpr int kMinParallelWorkload = 32;
 };
 
 }  // namespace par
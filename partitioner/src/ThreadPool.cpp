@@ -0,0 +1,121 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2022-2025, The OpenROAD Authors
+
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace par {
+
+ThreadPool::ThreadPool(const int num_threads)
+    : num_threads_(std::max(num_threads, 1))
+{
+  workers_.reserve(num_threads_ - 1);
+  for (int i = 1; i < num_threads_; i++) {
+    workers_.emplace_back(&ThreadPool::WorkerLoop, this);
+  }
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+int ThreadPool::DefaultNumThreads()
+{
+  return std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+}
+
+void ThreadPool::ParallelFor(const int num_tasks,
+                             const std::function<void(int)>& task)
+{
+  if (num_tasks <= 0) {
+    return;
+  }
+  // there is nothing to share, run the tasks in the calling thread
+  if (workers_.empty() || num_tasks == 1) {
+    for (int i = 0; i < num_tasks; i++) {
+      task(i);
+    }
+    return;
+  }
+
+  auto batch = std::make_shared<Batch>();
+  batch->task = &task;
+  batch->num_tasks = num_tasks;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    batches_.push_back(batch);
+  }
+  // the calling thread will take one task by itself
+  const int num_wakeups
+      = std::min(num_tasks - 1, static_cast<int>(workers_.size()));
+  for (int i = 0; i < num_wakeups; i++) {
+    cv_.notify_one();
+  }
+
+  RunBatch(*batch);
+
+  // wait for the tasks claimed by the workers
+  {
+    std::unique_lock<std::mutex> lock(batch->mutex);
+    batch->done.wait(
+        lock, [&] { return batch->finished_tasks.load() == num_tasks; });
+  }
+  // the batch may still be queued if no worker has looked at it
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto iter = std::find(batches_.begin(), batches_.end(), batch);
+  if (iter != batches_.end()) {
+    batches_.erase(iter);
+  }
+}
+
+void ThreadPool::RunBatch(Batch& batch)
+{
+  while (true) {
+    const int task_id = batch.next_task.fetch_add(1);
+    if (task_id >= batch.num_tasks) {
+      return;
+    }
+    (*batch.task)(task_id);
+    if (batch.finished_tasks.fetch_add(1) + 1 == batch.num_tasks) {
+      // take the lock so the notification cannot be lost
+      std::lock_guard<std::mutex> lock(batch.mutex);
+      batch.done.notify_all();
+    }
+  }
+}
+
+void ThreadPool::WorkerLoop()
+{
+  while (true) {
+    std::shared_ptr<Batch> batch;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [&] { return stop_ || !batches_.empty(); });
+      if (stop_) {
+        return;
+      }
+      batch = batches_.front();
+      // all the tasks in the front batch have been claimed
+      if (batch->next_task.load() >= batch->num_tasks) {
+        batches_.pop_front();
+        continue;
+      }
+    }
+    RunBatch(*batch);
+  }
+}
+
+}  // namespace par
@@ -0,0 +1,115 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2022-2025, The OpenROAD Authors
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace par {
+
+class ThreadPool;
+using ThreadPoolPtr = std::shared_ptr<ThreadPool>;
+
+// ---------------------------------------------------------------------------
+// A long-lived pool of worker threads.
+// The refiners used to create a fresh std::thread for every bucket on every
+// move, which costs more than the gain update itself on large designs.
+// The pool keeps its workers alive and executes batches of independent
+// tasks. The calling thread always takes part in its own batch, so
+// ParallelFor can be called concurrently from several threads (for example,
+// when refining multiple candidate solutions in parallel) and can be nested
+// without deadlocking.
+// ---------------------------------------------------------------------------
+class ThreadPool
+{
+ public:
+  // num_threads is the total number of threads including the caller,
+  // i.e., num_threads - 1 workers are created.
+  // num_threads <= 1 means all the tasks are executed inline.
+  explicit ThreadPool(int num_threads);
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+  ~ThreadPool();
+
+  int GetNumThreads() const { return num_threads_; }
+
+  // Run task(0), task(1), ..., task(num_tasks - 1) and block until
+  // all of them have finished. The tasks must be independent.
+  void ParallelFor(int num_tasks, const std::function<void(int)>& task);
+
+  // Sort data with comp. The data is split into one chunk per thread,
+  // the chunks are sorted in parallel and then merged pairwise.
+  template <typename T, typename Compare>
+  void ParallelSort(std::vector<T>& data, Compare comp);
+
+  // The number of threads used when the user does not specify it
+  static int DefaultNumThreads();
+
+ private:
+  // A group of tasks submitted by one ParallelFor call
+  struct Batch
+  {
+    const std::function<void(int)>* task = nullptr;
+    int num_tasks = 0;
+    std::atomic<int> next_task{0};      // the next task to be claimed
+    std::atomic<int> finished_tasks{0};  // the number of finished tasks
+    std::mutex mutex;
+    std::condition_variable done;
+  };
+
+  // Claim and execute the tasks of batch until no task is left
+  static void RunBatch(Batch& batch);
+  void WorkerLoop();
+
+  const int num_threads_ = 1;
+  std::vector<std::thread> workers_;
+  std::deque<std::shared_ptr<Batch>> batches_;  // pending batches
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stop_ = false;
+};
+
+template <typename T, typename Compare>
+void ThreadPool::ParallelSort(std::vector<T>& data, Compare comp)
+{
+  const int kMinChunkSize = 4096;
+  const int num_chunks = std::min(
+      num_threads_, static_cast<int>(data.size() / kMinChunkSize) + 1);
+  if (num_chunks <= 1) {
+    std::sort(data.begin(), data.end(), comp);
+    return;
+  }
+  // the boundaries of the chunks
+  std::vector<size_t> bounds(num_chunks + 1);
+  for (int i = 0; i <= num_chunks; i++) {
+    bounds[i] = data.size() * i / num_chunks;
+  }
+  ParallelFor(num_chunks, [&](int i) {
+    std::sort(data.begin() + bounds[i], data.begin() + bounds[i + 1], comp);
+  });
+  // merge the adjacent sorted chunks until only one chunk is left
+  for (int width = 1; width < num_chunks; width *= 2) {
+    const int num_merges = (num_chunks + 2 * width - 1) / (2 * width);
+    ParallelFor(num_merges, [&](int i) {
+      const int first = 2 * width * i;
+      const int middle = std::min(first + width, num_chunks);
+      const int last = std::min(first + 2 * width, num_chunks);
+      if (middle < last) {
+        std::inplace_merge(data.begin() + bounds[first],
+                           data.begin() + bounds[middle],
+                           data.begin() + bounds[last],
+                           comp);
+      }
+    });
+  }
+}
+
+}  // namespace par
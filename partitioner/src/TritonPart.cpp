@@ -32,6 +32,7 @@
 #include "KWayPMRefine.h"
 #include "Multilevel.h"
 #include "Partitioner.h"
+#include "ThreadPool.h"
 #include "Utilities.h"
 #include "db_sta/dbNetwork.hh"
 #include "db_sta/dbSta.hh"
@@ -630,7 +631,12 @@ void TritonPart::EvaluateHypergraphSolution(
                                                      extra_delay_,
                                                      original_hypergraph_,
                                                      logger_);
+  evaluator->SetThreadPool(
+      std::make_shared<ThreadPool>(ThreadPool::DefaultNumThreads()));
 
+  if (!evaluator->IsValidSolution(original_hypergraph_, solution_)) {
+    logger_->error(PAR, 40, "Invalid solution file : {}", solution_file);
+  }
   evaluator->ConstraintAndCutEvaluator(original_hypergraph_,
                                        solution_,
                                        ub_factor_,
@@ -855,6 +861,8 @@ void TritonPart::EvaluatePartDesignSolution(
                                                      extra_delay_,
                                                      original_hypergraph_,
                                                      logger_);
+  evaluator->SetThreadPool(
+      std::make_shared<ThreadPool>(ThreadPool::DefaultNumThreads()));
 
   evaluator->InitializeTiming(original_hypergraph_);
 
@@ -881,6 +889,9 @@ void TritonPart::EvaluatePartDesignSolution(
       solution_.push_back(part_id);
     }
     solution_file_input.close();
+    if (!evaluator->IsValidSolution(original_hypergraph_, solution_)) {
+      logger_->error(PAR, 39, "Invalid solution file : {}", solution_file);
+    }
     evaluator->ConstraintAndCutEvaluator(original_hypergraph_,
                                          solution_,
                                          ub_factor_,
@@ -939,16 +950,7 @@ std::vector<int> TritonPart::PartitionKWaySimpleMode(
   }
 
   // Build the original hypergraph first
-  original_hypergraph_ = std::make_shared<Hypergraph>(vertex_dimensions_,
-                                                      hyperedge_dimensions_,
-                                                      placement_dimensions_,
-                                                      hyperedges_,
-                                                      vertex_weights_,
-                                                      hyperedge_weights_,
-                                                      fixed_attr_,
-                                                      community_attr_,
-                                                      placement_attr_,
-                                                      logger_);
+  original_hypergraph_ = MakeHypergraphBuilder().Build(logger_);
 
   // call the multilevel partitioner to partition hypergraph_
   // but the evaluation is the original_hypergraph_
@@ -961,6 +963,35 @@ std::vector<int> TritonPart::PartitionKWaySimpleMode(
 // Private functions
 // --------------------------------------------------------------------------------------
 
+// The arrays of original_hypergraph_ (without timing information).
+// The attributes which do not match the number of vertices are dropped.
+HypergraphBuilder TritonPart::MakeHypergraphBuilder() const
+{
+  const size_t num_vertices = vertex_weights_.size();
+  HypergraphBuilder builder;
+  builder.vertex_dimensions = vertex_dimensions_;
+  builder.hyperedge_dimensions = hyperedge_dimensions_;
+  builder.placement_dimensions = placement_dimensions_;
+  builder.eptr.reserve(hyperedges_.size() + 1);
+  for (const auto& hyperedge : hyperedges_) {
+    builder.eind.insert(builder.eind.end(), hyperedge.begin(), hyperedge.end());
+    builder.eptr.push_back(static_cast<int>(builder.eind.size()));
+  }
+  builder.vertex_weights = FlattenRows(vertex_weights_, vertex_dimensions_);
+  builder.hyperedge_weights
+      = FlattenRows(hyperedge_weights_, hyperedge_dimensions_);
+  if (fixed_attr_.size() == num_vertices) {
+    builder.fixed_attr = fixed_attr_;
+  }
+  if (community_attr_.size() == num_vertices) {
+    builder.community_attr = community_attr_;
+  }
+  if (placement_dimensions_ > 0 && placement_attr_.size() == num_vertices) {
+    builder.placement_attr = FlattenRows(placement_attr_, placement_dimensions_);
+  }
+  return builder;
+}
+
 // for hypergraph partitioning
 // Read hypergraph from input files and related constraint files
 void TritonPart::ReadHypergraph(const std::string& hypergraph_file,
@@ -1180,16 +1211,7 @@ void TritonPart::ReadHypergraph(const std::string& hypergraph_file,
   }
 
   // Build the original hypergraph first
-  original_hypergraph_ = std::make_shared<Hypergraph>(vertex_dimensions_,
-                                                      hyperedge_dimensions_,
-                                                      placement_dimensions_,
-                                                      hyperedges_,
-                                                      vertex_weights_,
-                                                      hyperedge_weights_,
-                                                      fixed_attr_,
-                                                      community_attr_,
-                                                      placement_attr_,
-                                                      logger_);
+  original_hypergraph_ = MakeHypergraphBuilder().Build(logger_);
 
   logger_->info(PAR,
                 17,
@@ -1480,27 +1502,27 @@ void TritonPart::ReadNetlist(const std::string& fixed_file,
   }
 
   // build the timing graph
-  // map each net to the timing arc in the timing graph
-  std::vector<std::set<int>> hyperedges_arc_set;
+  // map each net to the timing arc in the timing graph.
+  // The arcs of each net are sorted and deduplicated in place.
+  HypergraphBuilder builder = MakeHypergraphBuilder();
+  builder.vertex_types = vertex_types_;
+  builder.hyperedges_slack = hyperedge_slacks_;
+  builder.arc_ptr.reserve(num_hyperedges_ + 1);
+  builder.arc_ptr.push_back(0);
   for (int e = 0; e < num_hyperedges_; e++) {
-    const std::set<int> arc_set{e};
-    hyperedges_arc_set.push_back(arc_set);
-  }
-
-  original_hypergraph_ = std::make_shared<Hypergraph>(vertex_dimensions_,
-                                                      hyperedge_dimensions_,
-                                                      placement_dimensions_,
-                                                      hyperedges_,
-                                                      vertex_weights_,
-                                                      hyperedge_weights_,
-                                                      fixed_attr_,
-                                                      community_attr_,
-                                                      placement_attr_,
-                                                      vertex_types_,
-                                                      hyperedge_slacks_,
-                                                      hyperedges_arc_set,
-                                                      timing_paths_,
-                                                      logger_);
+    const size_t first = builder.arc_ind.size();
+    builder.arc_ind.push_back(e);
+    std::sort(builder.arc_ind.begin() + first, builder.arc_ind.end());
+    builder.arc_ind.erase(
+        std::unique(builder.arc_ind.begin() + first, builder.arc_ind.end()),
+        builder.arc_ind.end());
+    builder.arc_ptr.push_back(static_cast<int>(builder.arc_ind.size()));
+  }
+  for (const auto& timing_path : timing_paths_) {
+    builder.timing_paths.AddPath(
+        timing_path.path, timing_path.arcs, timing_path.slack);
+  }
+  original_hypergraph_ = builder.Build(logger_);
 
   logger_->info(
       PAR,
@@ -1821,6 +1843,7 @@ void TritonPart::MultiLevelPartition()
 
     // coarsening related parameters
     logger_->report("coarsen order : {}", ToString(coarsen_order_));
+    logger_->report("coarsen scheme : {}", ToString(coarsen_scheme_));
     logger_->report("thr_coarsen_hyperedge_size_skip : {}",
                     thr_coarsen_hyperedge_size_skip_);
     logger_->report("thr_coarsen_vertices : {}", thr_coarsen_vertices_);
@@ -1892,6 +1915,7 @@ void TritonPart::MultiLevelPartition()
                                     coarsen_order_,
                                     tritonpart_evaluator,
                                     logger_);
+  tritonpart_coarsener->SetCoarsenScheme(coarsen_scheme_);
 
   // create the initial partitioning class
   auto tritonpart_partitioner = std::make_shared<Partitioner>(
@@ -1956,6 +1980,10 @@ void TritonPart::MultiLevelPartition()
                                                 ilp_refiner,
                                                 tritonpart_evaluator,
                                                 logger_);
+  // the coarsener and the refiners share one pool instead of spawning
+  // threads for each move
+  tritonpart_mlevel_partitioner->SetThreadPool(
+      std::make_shared<ThreadPool>(ThreadPool::DefaultNumThreads()));
 
   if (timing_aware_flag_ == true) {
     // Initialize the timing on original_hypergraph_
@@ -1984,16 +2012,7 @@ void TritonPart::MultiLevelPartition()
 
   // Translate the solution of hypergraph to original_hypergraph_
   // solution to solution_
-  solution_.clear();
-  solution_.resize(original_hypergraph_->GetNumVertices());
-  std::fill(solution_.begin(), solution_.end(), -1);
-  for (int cluster_id = 0; cluster_id < hypergraph_->GetNumVertices();
-       cluster_id++) {
-    const int part_id = solution[cluster_id];
-    for (const auto& v : hypergraph_->GetVertexCAttr(cluster_id)) {
-      solution_[v] = part_id;
-    }
-  }
+  hypergraph_->ProjectSolution(solution, solution_);
 
   // Perform the last-minute refinement
   tritonpart_coarsener->SetThrCoarsenHyperedgeSizeSkip(global_net_threshold_);
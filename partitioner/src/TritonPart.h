@@ -173,6 +173,14 @@ class TritonPart
     placement_wt_factors_ = placement_wt_factors;
   }
 
+  // The vertex matching used during coarsening.
+  // kParallelFirstChoice matches the vertices with multiple threads,
+  // kLazyFirstChoice (default) is the sequential first-choice matching
+  void SetCoarsenScheme(CoarsenScheme coarsen_scheme)
+  {
+    coarsen_scheme_ = coarsen_scheme;
+  }
+
   // Set detailed parameters
   // There parameters only used by users who want to exploit the performance
   // limits of TritonPart
@@ -218,6 +226,9 @@ class TritonPart
                    const std::string& group_file);
   void BuildTimingPaths();  // Find all the critical timing paths
 
+  // the arrays of original_hypergraph_, see HypergraphBuilder
+  HypergraphBuilder MakeHypergraphBuilder() const;
+
   void informFiles(const std::string& fixed_file,
                    const std::string& community_file,
                    const std::string& group_file,
@@ -307,6 +318,7 @@ class TritonPart
             // We achieve this by controlling the maximum vertex weight
             // during coarsening
   CoarsenOrder coarsen_order_ = CoarsenOrder::kRandom;
+  CoarsenScheme coarsen_scheme_ = CoarsenScheme::kLazyFirstChoice;
   // weight related parameter
 
   // cost related parameter
@@ -95,17 +95,39 @@ std::vector<std::string> SplitLine(const std::string& line)
   return items;
 }
 
+// Store the rows of the matrix in one array, dimensions values per row
+// (missing values are 0)
+std::vector<float> FlattenRows(const Matrix<float>& matrix, int dimensions)
+{
+  std::vector<float> flat(matrix.size() * dimensions, 0.0f);
+  auto flat_iter = flat.begin();
+  for (const auto& row : matrix) {
+    std::copy_n(row.begin(),
+                std::min(dimensions, static_cast<int>(row.size())),
+                flat_iter);
+    flat_iter += dimensions;
+  }
+  return flat;
+}
+
 // Add right vector to left vector
-void Accumulate(std::vector<float>& a, const std::vector<float>& b)
+void Accumulate(std::vector<float>& a, WeightView b)
 {
-  assert(a.size() == b.size());
+  assert(static_cast<int>(a.size()) == b.size());
   std::transform(a.begin(), a.end(), b.begin(), a.begin(), std::plus<float>());
 }
 
+// Subtract right vector from left vector
+void Subtract(std::vector<float>& a, WeightView b)
+{
+  assert(static_cast<int>(a.size()) == b.size());
+  std::transform(a.begin(), a.end(), b.begin(), a.begin(), std::minus<float>());
+}
+
 // weighted sum
-std::vector<float> WeightedSum(const std::vector<float>& a,
+std::vector<float> WeightedSum(WeightView a,
                                const float a_factor,
-                               const std::vector<float>& b,
+                               WeightView b,
                                const float b_factor)
 {
   assert(a.size() == b.size());
@@ -121,9 +143,9 @@ std::vector<float> WeightedSum(const std::vector<float>& a,
 }
 
 // divide the vector
-std::vector<float> DivideFactor(const std::vector<float>& a, const float factor)
+std::vector<float> DivideFactor(WeightView a, const float factor)
 {
-  std::vector<float> result = a;
+  std::vector<float> result(a.begin(), a.end());
   for (auto& value : result) {
     value /= factor;
   }
@@ -131,10 +153,9 @@ std::vector<float> DivideFactor(const std::vector<float>& a, const float factor)
 }
 
 // multiply the vector
-std::vector<float> MultiplyFactor(const std::vector<float>& a,
-                                  const float factor)
+std::vector<float> MultiplyFactor(WeightView a, const float factor)
 {
-  std::vector<float> result = a;
+  std::vector<float> result(a.begin(), a.end());
   for (auto& value : result) {
     value *= factor;
   }
@@ -142,8 +163,7 @@ std::vector<float> MultiplyFactor(const std::vector<float>& a,
 }
 
 // divide the vectors element by element
-std::vector<float> DivideVectorElebyEle(const std::vector<float>& emb,
-                                        const std::vector<float>& factor)
+std::vector<float> DivideVectorElebyEle(WeightView emb, WeightView factor)
 {
   std::vector<float> result;
   auto emb_iter = emb.begin();
@@ -161,8 +181,7 @@ std::vector<float> DivideVectorElebyEle(const std::vector<float>& emb,
 }
 
 // operation for two vectors +, -, *,  ==, <
-std::vector<float> operator+(const std::vector<float>& a,
-                             const std::vector<float>& b)
+std::vector<float> operator+(WeightView a, WeightView b)
 {
   assert(a.size() == b.size());
   std::vector<float> result;
@@ -175,8 +194,7 @@ std::vector<float> operator+(const std::vector<float>& a,
   return result;
 }
 
-std::vector<float> operator-(const std::vector<float>& a,
-                             const std::vector<float>& b)
+std::vector<float> operator-(WeightView a, WeightView b)
 {
   assert(a.size() == b.size());
   std::vector<float> result;
@@ -189,8 +207,7 @@ std::vector<float> operator-(const std::vector<float>& a,
   return result;
 }
 
-std::vector<float> operator*(const std::vector<float>& a,
-                             const std::vector<float>& b)
+std::vector<float> operator*(WeightView a, WeightView b)
 {
   assert(a.size() == b.size());
   std::vector<float> result;
@@ -203,7 +220,7 @@ std::vector<float> operator*(const std::vector<float>& a,
   return result;
 }
 
-std::vector<float> operator*(const std::vector<float>& a, const float factor)
+std::vector<float> operator*(WeightView a, const float factor)
 {
   std::vector<float> result;
   result.reserve(a.size());
@@ -213,7 +230,7 @@ std::vector<float> operator*(const std::vector<float>& a, const float factor)
   return result;
 }
 
-bool operator<(const std::vector<float>& a, const std::vector<float>& b)
+bool operator<(WeightView a, WeightView b)
 {
   assert(a.size() == b.size());
   auto a_iter = a.begin();
@@ -226,11 +243,21 @@ bool operator<(const std::vector<float>& a, const std::vector<float>& b)
   return true;
 }
 
-bool operator==(const std::vector<float>& a, const std::vector<float>& b)
+bool operator<(const std::vector<float>& a, const std::vector<float>& b)
+{
+  return WeightView(a) < WeightView(b);
+}
+
+bool operator==(WeightView a, WeightView b)
 {
   return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
 }
 
+bool operator==(const std::vector<float>& a, const std::vector<float>& b)
+{
+  return WeightView(a) == WeightView(b);
+}
+
 bool operator<=(const Matrix<float>& a, const Matrix<float>& b)
 {
   const int num_dim
@@ -245,7 +272,7 @@ bool operator<=(const Matrix<float>& a, const Matrix<float>& b)
 }
 
 // Basic functions for a vector
-std::vector<float> abs(const std::vector<float>& a)
+std::vector<float> abs(WeightView a)
 {
   std::vector<float> result;
   result.reserve(a.size());
@@ -256,14 +283,14 @@ std::vector<float> abs(const std::vector<float>& a)
   return result;
 }
 
-float norm2(const std::vector<float>& a)
+float norm2(WeightView a)
 {
   float result{0};
   result = std::inner_product(a.begin(), a.end(), a.begin(), result);
   return std::sqrt(result);
 }
 
-float norm2(const std::vector<float>& a, const std::vector<float>& factor)
+float norm2(WeightView a, WeightView factor)
 {
   float result{0};
   assert(a.size() <= factor.size());
@@ -45,6 +45,35 @@ struct Rect
   }
 };
 
+// Read-only view of the weights (or the placement) of one vertex or
+// hyperedge, i.e., a row of the flat arrays of Hypergraph.
+// A std::vector<float> converts implicitly to a view, so the functions
+// below take both. The copy back to a std::vector<float> is explicit.
+class WeightView
+{
+ public:
+  WeightView() = default;
+  WeightView(const float* data, int size) : data_(data), size_(size) {}
+  WeightView(const std::vector<float>& vec)
+      : data_(vec.data()), size_(static_cast<int>(vec.size()))
+  {
+  }
+
+  const float* begin() const { return data_; }
+  const float* end() const { return data_ + size_; }
+  const float* data() const { return data_; }
+  int size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  float operator[](int dim) const { return data_[dim]; }
+
+  // copy of the values, e.g., matrix.emplace_back(view)
+  explicit operator std::vector<float>() const { return {begin(), end()}; }
+
+ private:
+  const float* data_ = nullptr;
+  int size_ = 0;
+};
+
 // Define the type for vertices
 enum VertexType
 {
@@ -59,49 +88,58 @@ std::string GetVectorString(const std::vector<float>& vec);
 // Split a string based on deliminator : empty space and ","
 std::vector<std::string> SplitLine(const std::string& line);
 
+// Store the rows of the matrix in one array, dimensions values per row
+// (missing values are 0)
+std::vector<float> FlattenRows(const Matrix<float>& matrix, int dimensions);
+
 // Add right vector to left vector
-void Accumulate(std::vector<float>& a, const std::vector<float>& b);
+void Accumulate(std::vector<float>& a, WeightView b);
+
+// Subtract right vector from left vector
+void Subtract(std::vector<float>& a, WeightView b);
 
 // weighted sum
-std::vector<float> WeightedSum(const std::vector<float>& a,
+std::vector<float> WeightedSum(WeightView a,
                                float a_factor,
-                               const std::vector<float>& b,
+                               WeightView b,
                                float b_factor);
 
 // divide the vector
-std::vector<float> DivideFactor(const std::vector<float>& a, float factor);
+std::vector<float> DivideFactor(WeightView a, float factor);
 
 // divide the vectors element by element
-std::vector<float> DivideVectorElebyEle(const std::vector<float>& emb,
-                                        const std::vector<float>& factor);
+std::vector<float> DivideVectorElebyEle(WeightView emb, WeightView factor);
 
 // multiplty the vector
-std::vector<float> MultiplyFactor(const std::vector<float>& a, float factor);
+std::vector<float> MultiplyFactor(WeightView a, float factor);
 
 // operation for two vectors +, -, *,  ==, <
-std::vector<float> operator+(const std::vector<float>& a,
-                             const std::vector<float>& b);
+// The std::vector overloads of < and == hide the lexicographic
+// comparisons of std::vector
+std::vector<float> operator+(WeightView a, WeightView b);
+
+std::vector<float> operator*(WeightView a, float factor);
 
-std::vector<float> operator*(const std::vector<float>& a, float factor);
+std::vector<float> operator-(WeightView a, WeightView b);
 
-std::vector<float> operator-(const std::vector<float>& a,
-                             const std::vector<float>& b);
+std::vector<float> operator*(WeightView a, WeightView b);
 
-std::vector<float> operator*(const std::vector<float>& a,
-                             const std::vector<float>& b);
+bool operator<(WeightView a, WeightView b);
 
 bool operator<(const std::vector<float>& a, const std::vector<float>& b);
 
 bool operator<=(const Matrix<float>& a, const Matrix<float>& b);
 
+bool operator==(WeightView a, WeightView b);
+
 bool operator==(const std::vector<float>& a, const std::vector<float>& b);
 
 // Basic functions for a vector
-std::vector<float> abs(const std::vector<float>& a);
+std::vector<float> abs(WeightView a);
 
-float norm2(const std::vector<float>& a);
+float norm2(WeightView a);
 
-float norm2(const std::vector<float>& a, const std::vector<float>& factor);
+float norm2(WeightView a, WeightView factor);
 
 // ILP-based Partitioning Instance
 // Call ILP Solver to partition the design
@@ -0,0 +1,131 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2022-2025, The OpenROAD Authors
+
+///////////////////////////////////////////////////////////////////////////////
+// High-level description
+// WeightVector is a temporary weight (e.g., the balance of a block after a
+// tentative move) in the inner loops of the coarsening and the refinement.
+// Up to kInlineDims dimensions are stored inline, so building, adding and
+// comparing the weights does not allocate. Larger weights fall back to the
+// heap. A single dimension (the common case) takes a scalar fast path, and
+// the other loops are simple enough to be vectorized by the compiler.
+//
+// A WeightVector converts implicitly to a WeightView, so all the functions
+// and operators of Utilities.h apply to it.
+///////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+
+#include "Utilities.h"
+
+namespace par {
+
+class WeightVector
+{
+ public:
+  static constexpr int kInlineDims = 8;
+
+  WeightVector() = default;
+
+  // copy of the weights
+  explicit WeightVector(WeightView weights) : WeightVector(weights.size())
+  {
+    std::copy(weights.begin(), weights.end(), data());
+  }
+
+  WeightVector(const WeightVector& other) : WeightVector(WeightView(other)) {}
+
+  WeightVector& operator=(const WeightVector& other)
+  {
+    if (this != &other) {
+      Resize(other.size_);
+      std::copy(other.begin(), other.end(), data());
+    }
+    return *this;
+  }
+
+  WeightVector(WeightVector&& other) noexcept { *this = std::move(other); }
+
+  WeightVector& operator=(WeightVector&& other) noexcept
+  {
+    if (this != &other) {
+      size_ = other.size_;
+      heap_ = std::move(other.heap_);
+      std::copy(other.inline_, other.inline_ + kInlineDims, inline_);
+      other.size_ = 0;
+    }
+    return *this;
+  }
+
+  operator WeightView() const { return WeightView(data(), size_); }
+
+  int size() const { return size_; }
+  float* data() { return heap_ ? heap_.get() : inline_; }
+  const float* data() const { return heap_ ? heap_.get() : inline_; }
+  const float* begin() const { return data(); }
+  const float* end() const { return data() + size_; }
+  float& operator[](int dim) { return data()[dim]; }
+  float operator[](int dim) const { return data()[dim]; }
+
+  // add the weights element by element
+  WeightVector& operator+=(WeightView other)
+  {
+    if (size_ == 1) {
+      inline_[0] += other[0];
+      return *this;
+    }
+    float* values = data();
+    for (int dim = 0; dim < size_; dim++) {
+      values[dim] += other[dim];
+    }
+    return *this;
+  }
+
+  // subtract the weights element by element
+  WeightVector& operator-=(WeightView other)
+  {
+    if (size_ == 1) {
+      inline_[0] -= other[0];
+      return *this;
+    }
+    float* values = data();
+    for (int dim = 0; dim < size_; dim++) {
+      values[dim] -= other[dim];
+    }
+    return *this;
+  }
+
+ private:
+  explicit WeightVector(int size) { Resize(size); }
+
+  // The values are not kept
+  void Resize(int size)
+  {
+    if (size > kInlineDims) {
+      if (!heap_ || size > size_) {
+        heap_ = std::make_unique<float[]>(size);
+      }
+    } else {
+      heap_.reset();
+    }
+    size_ = size;
+  }
+
+  float inline_[kInlineDims] = {};
+  std::unique_ptr<float[]> heap_;
+  int size_ = 0;
+};
+
+// Lexicographic comparison, i.e., a < b for two std::vector<float>.
+// The balance checks compared std::vector<float> with <=, > and >= before
+// (operator< of Utilities.h requires all the dimensions to be smaller),
+// so they use this function to keep the same results.
+inline bool LexicographicLess(WeightView a, WeightView b)
+{
+  return std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end());
+}
+
+}  // namespace par
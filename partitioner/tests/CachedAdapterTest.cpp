@@ -0,0 +1,210 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2022-2025, The OpenROAD Authors
+
+// CachedAdapter: a cache hit gives back the front-end result, and a missing
+// or corrupted cache is a cache miss (load returns nullptr)
+
+#include "adapter/CachedAdapter.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "TestUtils.h"
+#include "utils/Logger.h"
+
+namespace par {
+namespace {
+
+// The front end of a random hypergraph with timing
+class TestAdapter : public NetlistAdapter
+{
+ public:
+  explicit TestAdapter(Logger* logger)
+  {
+    HypergraphBuilder builder = MakeRandomBuilder(500, 21);
+    AddRandomTiming(builder, 20, 22);
+    timing_paths_ = builder.timing_paths;
+    hypergraph_ = builder.Build(logger);
+  }
+
+  bool readNetlist(const std::string&, const std::string&) override
+  {
+    return true;
+  }
+  bool readSDC(const std::string&) override { return true; }
+  bool readLiberty(const std::string&) override { return true; }
+  bool runTimingAnalysis() override { return true; }
+
+  std::vector<Instance> getInstances() const override
+  {
+    std::vector<Instance> instances(getNumInstances());
+    for (int v = 0; v < getNumInstances(); v++) {
+      instances[v].name = "inst_" + std::to_string(v);
+      instances[v].cell_type = v % 2 == 0 ? "INV_X1" : "DFF_X1";
+    }
+    return instances;
+  }
+  std::vector<Net> getNets() const override
+  {
+    std::vector<Net> nets(getNumNets());
+    for (int e = 0; e < getNumNets(); e++) {
+      nets[e].name = "net_" + std::to_string(e);
+    }
+    return nets;
+  }
+  std::vector<Pin> getPins() const override { return {}; }
+
+  TimingPathStore getCriticalPaths(int) const override
+  {
+    return timing_paths_;
+  }
+  float getNetSlack(int net_id) const override { return net_id * 0.01f; }
+
+  std::shared_ptr<Hypergraph> buildHypergraph() override
+  {
+    return hypergraph_;
+  }
+  float getClockPeriod() const override { return 2.5f; }
+
+  int getNumInstances() const override
+  {
+    return hypergraph_->GetNumVertices();
+  }
+  int getNumNets() const override { return hypergraph_->GetNumHyperedges(); }
+  int getNumPins() const override { return hypergraph_->GetNumPins(); }
+
+ private:
+  HGraphPtr hypergraph_;
+  TimingPathStore timing_paths_;
+};
+
+bool SamePaths(const TimingPathStore& a, const TimingPathStore& b)
+{
+  return a.vind == b.vind && a.vptr == b.vptr && a.eind == b.eind
+         && a.eptr == b.eptr && a.slacks == b.slacks;
+}
+
+std::string ReadFile(const std::string& file_name)
+{
+  std::ifstream file(file_name, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(file),
+                     std::istreambuf_iterator<char>());
+}
+
+void WriteFile(const std::string& file_name,
+               const std::string& contents,
+               const size_t size)
+{
+  std::ofstream(file_name, std::ios::binary).write(contents.data(), size);
+}
+
+void TestCacheHit(Logger* logger)
+{
+  const std::string file_name = "cached_adapter_test.cache";
+  TestAdapter adapter(logger);
+  const HGraphPtr hgraph = adapter.buildHypergraph();
+  CHECK(CachedAdapter::write(
+      file_name, adapter, *hgraph, adapter.getCriticalPaths(100)));
+
+  const auto cached = CachedAdapter::load(file_name);
+  CHECK(cached != nullptr);
+  if (cached == nullptr) {
+    return;
+  }
+  CHECK(SameHypergraph(*hgraph, *cached->buildHypergraph()));
+  CHECK(SamePaths(adapter.getCriticalPaths(100), cached->getCriticalPaths(100)));
+  CHECK(cached->getClockPeriod() == adapter.getClockPeriod());
+  CHECK(cached->getNumInstances() == adapter.getNumInstances());
+  CHECK(cached->getNumNets() == adapter.getNumNets());
+  const std::vector<Instance> instances = cached->getInstances();
+  for (int v = 0; v < cached->getNumInstances(); v++) {
+    CHECK(instances[v].name == "inst_" + std::to_string(v));
+    CHECK(instances[v].cell_type == (v % 2 == 0 ? "INV_X1" : "DFF_X1"));
+  }
+  const std::vector<Net> nets = cached->getNets();
+  for (int e = 0; e < cached->getNumNets(); e++) {
+    CHECK(nets[e].name == "net_" + std::to_string(e));
+    CHECK(cached->getNetSlack(e) == adapter.getNetSlack(e));
+  }
+  std::remove(file_name.c_str());
+}
+
+void TestCorruptCache(Logger* logger)
+{
+  const std::string file_name = "cached_adapter_test_corrupt.cache";
+  CHECK(CachedAdapter::load("missing_file.cache") == nullptr);
+
+  TestAdapter adapter(logger);
+  CHECK(CachedAdapter::write(file_name,
+                             adapter,
+                             *adapter.buildHypergraph(),
+                             adapter.getCriticalPaths(100)));
+  const std::string contents = ReadFile(file_name);
+  CHECK(!contents.empty());
+
+  // a truncated file (e.g., from a crash of an older version) is a miss
+  for (size_t size = 0; size < contents.size();
+       size += size < 64 ? 1 : contents.size() / 200) {
+    WriteFile(file_name, contents, size);
+    CHECK(CachedAdapter::load(file_name) == nullptr);
+  }
+  // another file format or version
+  for (const size_t offset : {size_t(0), size_t(8)}) {
+    std::string modified = contents;
+    modified[offset] ^= 0x5a;
+    WriteFile(file_name, modified, modified.size());
+    CHECK(CachedAdapter::load(file_name) == nullptr);
+  }
+  // corrupted bytes are either detected or give a consistent hypergraph,
+  // but never crash
+  std::mt19937 rng(5);
+  for (int i = 0; i < 200; i++) {
+    std::string modified = contents;
+    for (int j = 0; j < 4; j++) {
+      modified[rng() % modified.size()] = static_cast<char>(rng());
+    }
+    WriteFile(file_name, modified, modified.size());
+    const auto cached = CachedAdapter::load(file_name);
+    if (cached != nullptr) {
+      const HGraphPtr hgraph = cached->buildHypergraph();
+      CHECK(hgraph != nullptr
+            && hgraph->GetNumVertices() >= cached->getNumInstances()
+            && hgraph->GetNumHyperedges() >= cached->getNumNets());
+    }
+  }
+  std::remove(file_name.c_str());
+}
+
+void TestCacheKey()
+{
+  const std::string file_name = "cached_adapter_test.v";
+  WriteFile(file_name, "module top; endmodule\n", 22);
+  const std::string key = computeFrontEndCacheKey({file_name}, "top", "-t");
+  CHECK(key.size() == 16);
+  CHECK(computeFrontEndCacheKey({file_name}, "top", "-t") == key);
+  CHECK(computeFrontEndCacheKey({file_name}, "top2", "-t") != key);
+  CHECK(computeFrontEndCacheKey({file_name}, "top", "") != key);
+  WriteFile(file_name, "module top; endmodule \n", 23);
+  CHECK(computeFrontEndCacheKey({file_name}, "top", "-t") != key);
+  CHECK(computeFrontEndCacheKey({"missing_file.v"}, "top", "-t").empty());
+  std::remove(file_name.c_str());
+}
+
+}  // namespace
+}  // namespace par
+
+int main()
+{
+  par::Logger* logger = &par::Logger::getInstance();
+  // the warnings of the corrupted caches are expected
+  logger->setLevel(par::LogLevel::CRITICAL);
+  par::TestCacheHit(logger);
+  par::TestCorruptCache(logger);
+  par::TestCacheKey();
+  return par::TestResult();
+}
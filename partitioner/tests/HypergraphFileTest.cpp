@@ -0,0 +1,181 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2022-2025, The OpenROAD Authors
+
+// The .hgrb and hMETIS readers and writers, the fixed / group file checks
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "HypergraphFile.h"
+#include "TestUtils.h"
+#include "utils/Logger.h"
+
+namespace par {
+namespace {
+
+void WriteTextFile(const std::string& file_name, const std::string& text)
+{
+  std::ofstream file(file_name);
+  file << text;
+}
+
+// a hypergraph with all the optional attributes
+HGraphPtr MakeFullHypergraph(Logger* logger)
+{
+  const int num_vertices = 5000;
+  HypergraphBuilder builder = MakeRandomBuilder(num_vertices, 3, 2, 1);
+  builder.placement_dimensions = 2;
+  for (int v = 0; v < num_vertices; v++) {
+    builder.fixed_attr.push_back(v % 97 == 0 ? v % 2 : -1);
+    builder.community_attr.push_back(v / 100);
+    builder.placement_attr.push_back(static_cast<float>(v % 13));
+    builder.placement_attr.push_back(static_cast<float>(v % 17));
+  }
+  AddRandomTiming(builder, 200, 4);
+  return builder.Build(logger);
+}
+
+void TestBinaryRoundTrip(Logger* logger)
+{
+  const std::string file_name = "hypergraph_file_test.hgrb";
+  const HGraphPtr full = MakeFullHypergraph(logger);
+  CHECK(full->HasTiming() && full->HasFixedVertices() && full->HasCommunity()
+        && full->HasPlacement());
+  CHECK(WriteBinaryHypergraph(*full, file_name, logger));
+  const HGraphPtr full_read = ReadBinaryHypergraph(file_name, logger);
+  CHECK(full_read != nullptr && SameHypergraph(*full, *full_read));
+
+  const HGraphPtr plain = MakeRandomBuilder(3000, 5).Build(logger);
+  CHECK(WriteBinaryHypergraph(*plain, file_name, logger));
+  const HGraphPtr plain_read = ReadBinaryHypergraph(file_name, logger);
+  CHECK(plain_read != nullptr && SameHypergraph(*plain, *plain_read));
+  std::remove(file_name.c_str());
+}
+
+void TestBinaryInvalidFile(Logger* logger)
+{
+  const std::string file_name = "hypergraph_file_test_invalid.hgrb";
+  CHECK(ReadBinaryHypergraph("missing_file.hgrb", logger) == nullptr);
+
+  const HGraphPtr hgraph = MakeFullHypergraph(logger);
+  CHECK(WriteBinaryHypergraph(*hgraph, file_name, logger));
+  std::string contents;
+  {
+    std::ifstream file(file_name, std::ios::binary);
+    contents.assign(std::istreambuf_iterator<char>(file),
+                    std::istreambuf_iterator<char>());
+  }
+  for (const size_t size : {size_t(0), size_t(16), contents.size() / 2,
+                            contents.size() - 1}) {
+    std::ofstream(file_name, std::ios::binary).write(contents.data(), size);
+    CHECK(ReadBinaryHypergraph(file_name, logger) == nullptr);
+  }
+  WriteTextFile(file_name, "not a hypergraph file");
+  CHECK(ReadBinaryHypergraph(file_name, logger) == nullptr);
+  std::remove(file_name.c_str());
+}
+
+void TestHMetisRoundTrip(Logger* logger)
+{
+  const std::string file_name = "hypergraph_file_test.hgr";
+  const HGraphPtr hgraph = MakeRandomBuilder(20000, 6, 2, 1).Build(logger);
+  CHECK(WriteHMetisHypergraph(*hgraph, file_name, logger));
+  // the lines are split into chunks when more than one thread is used
+  for (const int num_threads : {1, 4}) {
+    const HGraphPtr hgraph_read = ReadHMetisHypergraph(
+        file_name, "", "", "", 2, 1, num_threads, logger);
+    CHECK(hgraph_read != nullptr && SameHypergraph(*hgraph, *hgraph_read));
+  }
+  std::remove(file_name.c_str());
+}
+
+void TestHMetisInvalidFile(Logger* logger)
+{
+  const std::string file_name = "hypergraph_file_test_invalid.hgr";
+  auto read = [&](const std::string& text) {
+    WriteTextFile(file_name, text);
+    return ReadHMetisHypergraph(file_name, "", "", "", 1, 1, 1, logger);
+  };
+  CHECK(read("2 3\n1 2\n2 3\n") != nullptr);
+  CHECK(ReadHMetisHypergraph("missing_file.hgr", "", "", "", 1, 1, 1, logger)
+        == nullptr);
+  CHECK(read("") == nullptr);               // no header
+  CHECK(read("x 3\n1 2\n") == nullptr);     // invalid header
+  CHECK(read("-1 3\n") == nullptr);         // negative count
+  CHECK(read("3 3\n1 2\n2 3\n") == nullptr);  // missing hyperedge
+  CHECK(read("2 3\n1 2\n2 4\n") == nullptr);  // vertex id > num_vertices
+  CHECK(read("2 3\n1 2\n0 3\n") == nullptr);  // vertex id < 1
+  CHECK(read("2 3\n1 2\n2 a\n") == nullptr);  // not a number
+  CHECK(read("1 3 10\n1 2\n1\n1\n") == nullptr);   // missing vertex weight
+  CHECK(read("1 3 10\n1 2\n1\nb\n1\n") == nullptr);  // invalid vertex weight
+  std::remove(file_name.c_str());
+}
+
+void TestFixedFile(Logger* logger)
+{
+  const std::string hgraph_file = "hypergraph_file_test_fixed.hgr";
+  const std::string fixed_file = "hypergraph_file_test.fix";
+  WriteTextFile(hgraph_file, "2 4\n1 2\n3 4\n");
+  auto read = [&](const std::string& text) {
+    WriteTextFile(fixed_file, text);
+    return ReadHMetisHypergraph(
+        hgraph_file, fixed_file, "", "", 1, 1, 1, logger);
+  };
+
+  const HGraphPtr valid = read("% fixed blocks\n-1\n0\n1\n-1\n");
+  CHECK(valid != nullptr && valid->HasFixedVertices());
+  CHECK(valid != nullptr && valid->FindInvalidFixedVertex(2) == -1);
+  // block 1 is out of range for a single block
+  CHECK(valid != nullptr && valid->FindInvalidFixedVertex(1) == 2);
+
+  const HGraphPtr out_of_range = read("-1\n0\n2\n-2\n");
+  CHECK(out_of_range != nullptr
+        && out_of_range->FindInvalidFixedVertex(2) == 2);
+  const HGraphPtr negative = read("-1\n0\n1\n-2\n");
+  CHECK(negative != nullptr && negative->FindInvalidFixedVertex(2) == 3);
+
+  CHECK(read("-1\n0\nx\n1\n") == nullptr);
+  // a fixed file of another hypergraph is ignored
+  const HGraphPtr wrong_size = read("0\n1\n");
+  CHECK(wrong_size != nullptr && !wrong_size->HasFixedVertices()
+        && wrong_size->FindInvalidFixedVertex(2) == -1);
+  std::remove(hgraph_file.c_str());
+  std::remove(fixed_file.c_str());
+}
+
+void TestGroupFile(Logger* logger)
+{
+  const std::string file_name = "hypergraph_file_test.grp";
+  Matrix<int> group_attr;
+  WriteTextFile(file_name, "% groups\n1 2\n3\n4 5 10\n");
+  CHECK(ReadGroupFile(file_name, 10, group_attr, logger));
+  CHECK((group_attr == Matrix<int>{{0, 1}, {3, 4, 9}}));
+
+  for (const std::string text : {"1 2\n3 11\n", "1 0\n", "1 2\n3 a\n"}) {
+    WriteTextFile(file_name, text);
+    CHECK(!ReadGroupFile(file_name, 10, group_attr, logger));
+    CHECK(group_attr.empty());
+  }
+  CHECK(!ReadGroupFile("missing_file.grp", 10, group_attr, logger));
+  std::remove(file_name.c_str());
+}
+
+}  // namespace
+}  // namespace par
+
+int main()
+{
+  par::Logger* logger = &par::Logger::getInstance();
+  // the errors of the invalid files are expected
+  logger->setLevel(par::LogLevel::CRITICAL);
+  par::TestBinaryRoundTrip(logger);
+  par::TestBinaryInvalidFile(logger);
+  par::TestHMetisRoundTrip(logger);
+  par::TestHMetisInvalidFile(logger);
+  par::TestFixedFile(logger);
+  par::TestGroupFile(logger);
+  return par::TestResult();
+}
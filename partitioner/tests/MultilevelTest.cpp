@@ -0,0 +1,314 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2022-2025, The OpenROAD Authors
+
+// The partitioning results do not depend on the number of threads, and the
+// evaluator rejects the solutions with invalid block ids
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "Coarsener.h"
+#include "Evaluator.h"
+#include "GreedyRefine.h"
+#include "ILPRefine.h"
+#include "KWayFMRefine.h"
+#include "KWayPMRefine.h"
+#include "Multilevel.h"
+#include "Partitioner.h"
+#include "TestUtils.h"
+#include "ThreadPool.h"
+#include "utils/Logger.h"
+
+namespace par {
+namespace {
+
+HGraphPtr MakeHypergraph(const int num_vertices,
+                         const bool timing,
+                         Logger* logger)
+{
+  HypergraphBuilder builder = MakeRandomBuilder(num_vertices, 11);
+  if (timing) {
+    AddRandomTiming(builder, num_vertices / 50, 12);
+  }
+  return builder.Build(logger);
+}
+
+EvaluatorPtr MakeEvaluator(const int num_parts,
+                           const HGraphPtr& hgraph,
+                           const float timing_factor,
+                           Logger* logger)
+{
+  return std::make_shared<GoldenEvaluator>(num_parts,
+                                           std::vector<float>{1.0f},
+                                           std::vector<float>{1.0f},
+                                           std::vector<float>{},
+                                           timing_factor,
+                                           timing_factor,
+                                           timing_factor,
+                                           2.0f,
+                                           1.0f,
+                                           hgraph,
+                                           logger);
+}
+
+// the largest cluster of the coarsening
+std::vector<float> MaxClusterWeight(const HGraphPtr& hgraph,
+                                    const int num_parts)
+{
+  return DivideFactor(hgraph->GetTotalVertexWeights(), 4.0f * num_parts);
+}
+
+std::shared_ptr<Coarsener> MakeCoarsener(const int num_parts,
+                                         const HGraphPtr& hgraph,
+                                         const EvaluatorPtr& evaluator,
+                                         Logger* logger)
+{
+  return std::make_shared<Coarsener>(num_parts,
+                                     50,
+                                     200,
+                                     50,
+                                     1.5,
+                                     20,
+                                     0.0001,
+                                     MaxClusterWeight(hgraph, num_parts),
+                                     0,
+                                     CoarsenOrder::kRandom,
+                                     evaluator,
+                                     logger);
+}
+
+// The solution of the multilevel partitioner with num_threads threads
+std::vector<int> Partition(const int num_parts,
+                           const bool timing,
+                           const CoarsenScheme scheme,
+                           const int num_threads,
+                           Logger* logger)
+{
+  const HGraphPtr hgraph = MakeHypergraph(2000, timing, logger);
+  const float timing_factor = timing ? 1.0f : 0.0f;
+  const EvaluatorPtr evaluator
+      = MakeEvaluator(num_parts, hgraph, timing_factor, logger);
+  if (timing) {
+    evaluator->InitializeTiming(hgraph);
+  }
+  const std::vector<float> base_balance(num_parts, 1.0f / num_parts);
+  const auto upper_block_balance
+      = hgraph->GetUpperVertexBalance(num_parts, 2.0, base_balance);
+  const auto lower_block_balance
+      = hgraph->GetLowerVertexBalance(num_parts, 2.0, base_balance);
+  auto coarsener = MakeCoarsener(num_parts, hgraph, evaluator, logger);
+  coarsener->SetCoarsenScheme(scheme);
+  auto partitioner
+      = std::make_shared<Partitioner>(num_parts, 0, evaluator, logger);
+  auto greedy_refiner = std::make_shared<GreedyRefine>(
+      num_parts, 2, timing_factor, timing_factor, 50, evaluator, logger);
+  auto ilp_refiner = std::make_shared<IlpRefine>(
+      num_parts, 2, timing_factor, timing_factor, 50, evaluator, logger);
+  auto k_way_fm_refiner = std::make_shared<KWayFMRefine>(
+      num_parts, 2, timing_factor, timing_factor, 50, 25, evaluator, logger);
+  auto k_way_pm_refiner = std::make_shared<KWayPMRefine>(
+      num_parts, 2, timing_factor, timing_factor, 50, 25, evaluator, logger);
+  auto multilevel = std::make_shared<MultilevelPartitioner>(num_parts,
+                                                            true,
+                                                            50,
+                                                            10,
+                                                            50,
+                                                            5,
+                                                            3,
+                                                            0,
+                                                            coarsener,
+                                                            partitioner,
+                                                            k_way_fm_refiner,
+                                                            k_way_pm_refiner,
+                                                            greedy_refiner,
+                                                            ilp_refiner,
+                                                            evaluator,
+                                                            logger);
+  multilevel->SetThreadPool(std::make_shared<ThreadPool>(num_threads));
+  const HGraphPtr grouped = coarsener->GroupVertices(hgraph, {});
+  const std::vector<int> grouped_solution = multilevel->Partition(
+      grouped, upper_block_balance, lower_block_balance);
+  std::vector<int> solution;
+  grouped->ProjectSolution(grouped_solution, solution);
+  CHECK(evaluator->IsValidSolution(hgraph, solution));
+  return solution;
+}
+
+// The default coarsening gives the same solution with any number of
+// threads. The parallel first-choice matching depends on the thread
+// scheduling, so it is checked by TestParallelFirstChoice instead.
+void TestPartitionThreads(Logger* logger)
+{
+  for (const bool timing : {false, true}) {
+    const std::vector<int> expected = Partition(
+        4, timing, CoarsenScheme::kLazyFirstChoice, 1, logger);
+    for (const int num_threads : {2, 4}) {
+      CHECK(Partition(
+                4, timing, CoarsenScheme::kLazyFirstChoice, num_threads, logger)
+            == expected);
+    }
+  }
+}
+
+// the coarser hypergraphs of the parallel first-choice matching
+CoarseGraphPtrs CoarsenParallel(const HGraphPtr& hgraph,
+                                const int num_threads,
+                                Logger* logger)
+{
+  const EvaluatorPtr evaluator = MakeEvaluator(2, hgraph, 0.0f, logger);
+  auto coarsener = MakeCoarsener(2, hgraph, evaluator, logger);
+  coarsener->SetCoarsenScheme(CoarsenScheme::kParallelFirstChoice);
+  coarsener->SetThreadPool(std::make_shared<ThreadPool>(num_threads));
+  return coarsener->LazyFirstChoice(hgraph);
+}
+
+// true if each cluster of hierarchy[i] has the weight of its vertices in
+// hierarchy[i - 1], does not exceed max_weight (unless it is a single
+// vertex), has the community of its vertices and keeps the fixed vertices
+// as single-vertex clusters
+bool IsValidHierarchy(const CoarseGraphPtrs& hierarchy,
+                      const std::vector<float>& max_weight)
+{
+  for (size_t level = 1; level < hierarchy.size(); level++) {
+    const HGraphPtr& fine = hierarchy[level - 1];
+    const HGraphPtr& coarse = hierarchy[level];
+    const std::vector<int>& parents = coarse->GetVertexParents();
+    if (static_cast<int>(parents.size()) != fine->GetNumVertices()) {
+      return false;
+    }
+    const int num_dims = coarse->GetVertexDimensions();
+    std::vector<float> weights(
+        static_cast<size_t>(coarse->GetNumVertices()) * num_dims, 0.0f);
+    std::vector<int> sizes(coarse->GetNumVertices(), 0);
+    for (int v = 0; v < fine->GetNumVertices(); v++) {
+      const int c = parents[v];
+      if (c < 0 || c >= coarse->GetNumVertices()
+          || fine->HasCommunity() != coarse->HasCommunity()
+          || (fine->HasCommunity()
+              && fine->GetCommunity(v) != coarse->GetCommunity(c))) {
+        return false;
+      }
+      for (int dim = 0; dim < num_dims; dim++) {
+        weights[static_cast<size_t>(c) * num_dims + dim]
+            += fine->GetVertexWeights(v)[dim];
+      }
+      sizes[c]++;
+    }
+    for (int v = 0; v < fine->GetNumVertices(); v++) {
+      if (fine->HasFixedVertices() && fine->GetFixedAttr(v) > -1
+          && sizes[parents[v]] != 1) {
+        return false;
+      }
+    }
+    for (int c = 0; c < coarse->GetNumVertices(); c++) {
+      if (sizes[c] == 0) {
+        return false;
+      }
+      for (int dim = 0; dim < num_dims; dim++) {
+        const float weight = weights[static_cast<size_t>(c) * num_dims + dim];
+        if (coarse->GetVertexWeights(c)[dim] != weight
+            || (sizes[c] > 1 && weight > max_weight[dim])) {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+void TestParallelFirstChoice(Logger* logger)
+{
+  const int num_vertices = 20000;
+  HypergraphBuilder builder = MakeRandomBuilder(num_vertices, 13, 2);
+  for (int v = 0; v < num_vertices; v++) {
+    builder.fixed_attr.push_back(v % 101 == 0 ? v % 2 : -1);
+    builder.community_attr.push_back(v / 1000);
+  }
+  const HGraphPtr hgraph = builder.Build(logger);
+  const std::vector<float> max_weight = MaxClusterWeight(hgraph, 2);
+
+  // a single thread matches the vertices in order, so the result is
+  // reproducible
+  const CoarseGraphPtrs expected = CoarsenParallel(hgraph, 1, logger);
+  const CoarseGraphPtrs again = CoarsenParallel(hgraph, 1, logger);
+  CHECK(expected.size() > 1 && again.size() == expected.size());
+  for (size_t level = 1; level < std::min(expected.size(), again.size());
+       level++) {
+    CHECK(again[level]->GetVertexParents()
+          == expected[level]->GetVertexParents());
+  }
+
+  // with more threads, the clusters depend on the scheduling, but they
+  // satisfy the same constraints
+  for (const int num_threads : {1, 2, 8}) {
+    const CoarseGraphPtrs hierarchy
+        = CoarsenParallel(hgraph, num_threads, logger);
+    CHECK(hierarchy.size() > 1);
+    CHECK(IsValidHierarchy(hierarchy, max_weight));
+  }
+}
+
+void TestEvaluatorThreads(Logger* logger)
+{
+  const int num_parts = 5;
+  const HGraphPtr hgraph = MakeHypergraph(50000, true, logger);
+  const EvaluatorPtr evaluator
+      = MakeEvaluator(num_parts, hgraph, 1.0f, logger);
+  evaluator->InitializeTiming(hgraph);
+  std::vector<int> solution(hgraph->GetNumVertices());
+  for (int v = 0; v < hgraph->GetNumVertices(); v++) {
+    solution[v] = (v / 1000 + v % 7) % num_parts;
+  }
+  const PartitionToken expected = evaluator->CutEvaluator(hgraph, solution);
+  const PathStats expected_paths = evaluator->GetTimingCuts(hgraph, solution);
+  for (const int num_threads : {2, 8}) {
+    evaluator->SetThreadPool(std::make_shared<ThreadPool>(num_threads));
+    const PartitionToken token = evaluator->CutEvaluator(hgraph, solution);
+    CHECK(token.cost == expected.cost);
+    CHECK(token.block_balance == expected.block_balance);
+    const PathStats paths = evaluator->GetTimingCuts(hgraph, solution);
+    CHECK(paths.tot_num_critical_path == expected_paths.tot_num_critical_path);
+    CHECK(paths.worst_cut_critical_path
+          == expected_paths.worst_cut_critical_path);
+    CHECK(paths.avg_cut_critical_path == expected_paths.avg_cut_critical_path);
+  }
+}
+
+void TestSolutionValidation(Logger* logger)
+{
+  const int num_parts = 3;
+  const HGraphPtr hgraph = MakeHypergraph(10000, false, logger);
+  const EvaluatorPtr evaluator
+      = MakeEvaluator(num_parts, hgraph, 0.0f, logger);
+  std::vector<int> solution(hgraph->GetNumVertices());
+  for (int v = 0; v < hgraph->GetNumVertices(); v++) {
+    solution[v] = v % num_parts;
+  }
+  for (const int num_threads : {1, 4}) {
+    evaluator->SetThreadPool(std::make_shared<ThreadPool>(num_threads));
+    CHECK(evaluator->IsValidSolution(hgraph, solution));
+    for (const int block_id : {-1, num_parts}) {
+      std::vector<int> invalid = solution;
+      invalid[9000] = block_id;
+      CHECK(!evaluator->IsValidSolution(hgraph, invalid));
+    }
+    std::vector<int> too_short = solution;
+    too_short.pop_back();
+    CHECK(!evaluator->IsValidSolution(hgraph, too_short));
+  }
+}
+
+}  // namespace
+}  // namespace par
+
+int main()
+{
+  par::Logger* logger = &par::Logger::getInstance();
+  logger->setLevel(par::LogLevel::WARNING);
+  par::TestPartitionThreads(logger);
+  par::TestParallelFirstChoice(logger);
+  par::TestEvaluatorThreads(logger);
+  par::TestSolutionValidation(logger);
+  return par::TestResult();
+}
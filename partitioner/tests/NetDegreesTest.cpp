@@ -0,0 +1,191 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2022-2025, The OpenROAD Authors
+
+// NetDegrees and GainCache against a direct count of the pins of each
+// hyperedge, before and after moving vertices
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "Evaluator.h"
+#include "GainCache.h"
+#include "NetDegrees.h"
+#include "TestUtils.h"
+#include "utils/Logger.h"
+
+namespace par {
+namespace {
+
+// a random hypergraph with a 300-pin and a 70000-pin hyperedge, so all the
+// counter widths are used
+HGraphPtr MakeHypergraph(Logger* logger)
+{
+  const int num_vertices = 70000;
+  HypergraphBuilder builder = MakeRandomBuilder(num_vertices, 7);
+  for (const int size : {300, num_vertices}) {
+    for (int v = 0; v < size; v++) {
+      builder.eind.push_back(v);
+    }
+    builder.eptr.push_back(static_cast<int>(builder.eind.size()));
+    builder.hyperedge_weights.push_back(1.0f);
+  }
+  return builder.Build(logger);
+}
+
+std::vector<int> RandomSolution(const int num_vertices,
+                                const int num_parts,
+                                std::mt19937& rng)
+{
+  std::vector<int> solution(num_vertices);
+  for (auto& block_id : solution) {
+    block_id = static_cast<int>(rng() % num_parts);
+  }
+  return solution;
+}
+
+// true if net_degs has the pin counts of solution
+bool MatchesSolution(const NetDegrees& net_degs,
+                     const HGraphPtr& hgraph,
+                     const std::vector<int>& solution)
+{
+  const int num_parts = net_degs.GetNumParts();
+  if (net_degs.GetNumHyperedges() != hgraph->GetNumHyperedges()) {
+    return false;
+  }
+  std::vector<int> counts(num_parts);
+  for (int e = 0; e < hgraph->GetNumHyperedges(); e++) {
+    std::fill(counts.begin(), counts.end(), 0);
+    for (const int v : hgraph->Vertices(e)) {
+      counts[solution[v]]++;
+    }
+    int connectivity = 0;
+    for (int block_id = 0; block_id < num_parts; block_id++) {
+      if (net_degs.GetPinCount(e, block_id) != counts[block_id]
+          || net_degs.HasPins(e, block_id) != (counts[block_id] > 0)) {
+        return false;
+      }
+      connectivity += counts[block_id] > 0 ? 1 : 0;
+    }
+    if (net_degs.GetPinCounts(e) != counts
+        || net_degs.GetConnectivity(e) != connectivity
+        || net_degs.IsCut(e) != (connectivity > 1)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void TestNetDegrees(Logger* logger)
+{
+  const HGraphPtr hgraph = MakeHypergraph(logger);
+  std::mt19937 rng(1);
+  // more than 64 blocks need more than one word for the blocks of a
+  // hyperedge
+  for (const int num_parts : {2, 5, 70}) {
+    std::vector<int> solution
+        = RandomSolution(hgraph->GetNumVertices(), num_parts, rng);
+    NetDegrees net_degs(num_parts, hgraph, solution);
+    CHECK(MatchesSolution(net_degs, hgraph, solution));
+
+    // move vertices (including the pins of the large hyperedges)
+    for (int move = 0; move < 2000; move++) {
+      const int v = move < 1000 ? move % 300
+                                : static_cast<int>(rng() % solution.size());
+      const int from_pid = solution[v];
+      const int to_pid = static_cast<int>(rng() % num_parts);
+      if (to_pid == from_pid) {
+        continue;
+      }
+      for (const int e : hgraph->Edges(v)) {
+        const int from_count = net_degs.GetPinCount(e, from_pid);
+        const int to_count = net_degs.GetPinCount(e, to_pid);
+        CHECK(net_degs.DecreasePinCount(e, from_pid) == from_count - 1);
+        CHECK(net_degs.IncreasePinCount(e, to_pid) == to_count + 1);
+      }
+      solution[v] = to_pid;
+    }
+    CHECK(MatchesSolution(net_degs, hgraph, solution));
+  }
+}
+
+// the cut of solution, i.e., the summation of the cost of the cut
+// hyperedges
+float CutCost(const HGraphPtr& hgraph,
+              const std::vector<int>& solution,
+              const GoldenEvaluator& evaluator)
+{
+  float cost = 0.0f;
+  for (int e = 0; e < hgraph->GetNumHyperedges(); e++) {
+    const int block_id = solution[*hgraph->Vertices(e).begin()];
+    for (const int v : hgraph->Vertices(e)) {
+      if (solution[v] != block_id) {
+        cost += evaluator.CalculateHyperedgeCost(e, hgraph);
+        break;
+      }
+    }
+  }
+  return cost;
+}
+
+void TestGainCache(Logger* logger)
+{
+  const int num_parts = 3;
+  const HGraphPtr hgraph = MakeRandomBuilder(2000, 8).Build(logger);
+  const auto evaluator = std::make_shared<GoldenEvaluator>(
+      num_parts,
+      std::vector<float>{1.0f},
+      std::vector<float>{1.0f},
+      std::vector<float>{},
+      0.0f,
+      0.0f,
+      0.0f,
+      2.0f,
+      1.0f,
+      hgraph,
+      logger);
+  std::mt19937 rng(2);
+  std::vector<int> solution
+      = RandomSolution(hgraph->GetNumVertices(), num_parts, rng);
+  NetDegrees net_degs(num_parts, hgraph, solution);
+  GainCache gain_cache;
+  gain_cache.Initialize(num_parts, hgraph, net_degs, evaluator);
+
+  float cut = CutCost(hgraph, solution, *evaluator);
+  for (int move = 0; move < 200; move++) {
+    const int v = static_cast<int>(rng() % solution.size());
+    const int from_pid = solution[v];
+    const int to_pid = (from_pid + 1 + static_cast<int>(rng() % 2)) % 3;
+    // the cached gain is the reduction of the cut
+    const float gain = gain_cache.GetCutGain(v, to_pid);
+    gain_cache.MoveVertex(v, from_pid, to_pid, hgraph, net_degs);
+    solution[v] = to_pid;
+    const float new_cut = CutCost(hgraph, solution, *evaluator);
+    CHECK(gain == cut - new_cut);
+    cut = new_cut;
+  }
+  CHECK(MatchesSolution(net_degs, hgraph, solution));
+
+  // the updated entries are the same as the entries built from scratch
+  GainCache expected;
+  expected.Initialize(num_parts, hgraph, net_degs, evaluator);
+  for (int v = 0; v < hgraph->GetNumVertices(); v++) {
+    CHECK(gain_cache.GetPenalty(v) == expected.GetPenalty(v));
+    for (int block_id = 0; block_id < num_parts; block_id++) {
+      CHECK(gain_cache.GetBenefit(v, block_id)
+            == expected.GetBenefit(v, block_id));
+    }
+  }
+}
+
+}  // namespace
+}  // namespace par
+
+int main()
+{
+  par::Logger* logger = &par::Logger::getInstance();
+  par::TestNetDegrees(logger);
+  par::TestGainCache(logger);
+  return par::TestResult();
+}
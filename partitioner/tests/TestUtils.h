@@ -0,0 +1,194 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2022-2025, The OpenROAD Authors
+
+///////////////////////////////////////////////////////////////////////////////
+// High-level description
+// Helpers shared by the tests: a CHECK macro which counts the failures
+// (each test program returns nonzero if any check failed), a generator of
+// random hypergraphs and a deep comparison of two hypergraphs.
+///////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "Hypergraph.h"
+#include "Utilities.h"
+
+namespace par {
+
+inline int& NumFailures()
+{
+  static int num_failures = 0;
+  return num_failures;
+}
+
+#define CHECK(condition)                                    \
+  do {                                                      \
+    if (!(condition)) {                                     \
+      std::fprintf(stderr,                                  \
+                   "%s:%d: CHECK failed: %s\n",             \
+                   __FILE__,                                \
+                   __LINE__,                                \
+                   #condition);                             \
+      par::NumFailures()++;                                 \
+    }                                                       \
+  } while (0)
+
+// the exit code of a test program
+inline int TestResult()
+{
+  if (NumFailures() > 0) {
+    std::fprintf(stderr, "%d check(s) failed\n", NumFailures());
+    return 1;
+  }
+  return 0;
+}
+
+// A hypergraph whose hyperedges mostly connect nearby vertices (similar to
+// a placed netlist), with random integer weights in all the dimensions.
+// Single-vertex hyperedges are skipped.
+inline HypergraphBuilder MakeRandomBuilder(const int num_vertices,
+                                           const unsigned seed,
+                                           const int vertex_dimensions = 1,
+                                           const int hyperedge_dimensions = 1)
+{
+  std::mt19937 rng(seed);
+  HypergraphBuilder builder;
+  builder.vertex_dimensions = vertex_dimensions;
+  builder.hyperedge_dimensions = hyperedge_dimensions;
+  for (int v = 0; v < num_vertices; v++) {
+    const size_t first = builder.eind.size();
+    builder.eind.push_back(v);
+    const int degree = 1 + static_cast<int>(rng() % 4);
+    for (int j = 0; j < degree; j++) {
+      int offset = static_cast<int>(rng() % 64) - 32;
+      if (rng() % 50 == 0) {
+        offset = static_cast<int>(rng() % num_vertices);
+      }
+      const int u = ((v + offset) % num_vertices + num_vertices) % num_vertices;
+      if (std::find(builder.eind.begin() + first, builder.eind.end(), u)
+          == builder.eind.end()) {
+        builder.eind.push_back(u);
+      }
+    }
+    if (builder.eind.size() - first > 1) {
+      builder.eptr.push_back(static_cast<int>(builder.eind.size()));
+    } else {
+      builder.eind.resize(first);
+    }
+  }
+  const size_t num_hyperedges = builder.eptr.size() - 1;
+  for (size_t i = 0; i < num_vertices * size_t(vertex_dimensions); i++) {
+    builder.vertex_weights.push_back(static_cast<float>(1 + rng() % 3));
+  }
+  for (size_t i = 0; i < num_hyperedges * hyperedge_dimensions; i++) {
+    builder.hyperedge_weights.push_back(static_cast<float>(1 + rng() % 2));
+  }
+  return builder;
+}
+
+// Add the vertex types, the hyperedge slacks, one timing arc per hyperedge
+// and num_paths random timing paths to builder
+inline void AddRandomTiming(HypergraphBuilder& builder,
+                            const int num_paths,
+                            const unsigned seed)
+{
+  std::mt19937 rng(seed);
+  const int num_vertices = static_cast<int>(builder.vertex_weights.size()
+                                            / builder.vertex_dimensions);
+  const int num_hyperedges = static_cast<int>(builder.eptr.size()) - 1;
+  for (int v = 0; v < num_vertices; v++) {
+    builder.vertex_types.push_back(static_cast<VertexType>(rng() % 4));
+  }
+  builder.arc_ptr.push_back(0);
+  for (int e = 0; e < num_hyperedges; e++) {
+    builder.hyperedges_slack.push_back((rng() % 100) / 100.0f);
+    builder.arc_ind.push_back(e);
+    builder.arc_ptr.push_back(static_cast<int>(builder.arc_ind.size()));
+  }
+  for (int p = 0; p < num_paths; p++) {
+    const int start = static_cast<int>(rng() % num_vertices);
+    std::vector<int> path;
+    for (int j = 0; j < 6; j++) {
+      path.push_back((start + j * 3) % num_vertices);
+    }
+    const std::vector<int> arcs{static_cast<int>(rng() % num_hyperedges)};
+    builder.timing_paths.AddPath(path, arcs, (rng() % 100) / 100.0f);
+  }
+}
+
+// true if the two ranges have the same values
+template <typename RangeA, typename RangeB>
+bool SameRange(const RangeA& a, const RangeB& b)
+{
+  return std::equal(a.begin(), a.end(), b.begin(), b.end());
+}
+
+// true if a and b have the same hyperedges, weights and attributes
+inline bool SameHypergraph(const Hypergraph& a, const Hypergraph& b)
+{
+  if (a.GetNumVertices() != b.GetNumVertices()
+      || a.GetNumHyperedges() != b.GetNumHyperedges()
+      || a.GetNumPins() != b.GetNumPins()
+      || a.GetVertexDimensions() != b.GetVertexDimensions()
+      || a.GetHyperedgeDimensions() != b.GetHyperedgeDimensions()
+      || a.GetPlacementDimensions() != b.GetPlacementDimensions()
+      || a.GetFlatVertexWeights() != b.GetFlatVertexWeights()
+      || a.GetFlatHyperedgeWeights() != b.GetFlatHyperedgeWeights()
+      || a.HasFixedVertices() != b.HasFixedVertices()
+      || a.HasCommunity() != b.HasCommunity()
+      || a.HasPlacement() != b.HasPlacement()
+      || a.HasTiming() != b.HasTiming()) {
+    return false;
+  }
+  for (int e = 0; e < a.GetNumHyperedges(); e++) {
+    if (!SameRange(a.Vertices(e), b.Vertices(e))) {
+      return false;
+    }
+  }
+  for (int v = 0; v < a.GetNumVertices(); v++) {
+    if (!SameRange(a.Edges(v), b.Edges(v))) {
+      return false;
+    }
+    if (a.HasFixedVertices() && a.GetFixedAttr(v) != b.GetFixedAttr(v)) {
+      return false;
+    }
+    if (a.HasCommunity() && a.GetCommunity(v) != b.GetCommunity(v)) {
+      return false;
+    }
+  }
+  if (a.HasPlacement() && a.GetFlatPlacement() != b.GetFlatPlacement()) {
+    return false;
+  }
+  if (!a.HasTiming()) {
+    return true;
+  }
+  if (a.GetHyperedgeTimingAttr() != b.GetHyperedgeTimingAttr()
+      || a.GetNumTimingPaths() != b.GetNumTimingPaths()) {
+    return false;
+  }
+  for (int v = 0; v < a.GetNumVertices(); v++) {
+    if (a.GetVertexType(v) != b.GetVertexType(v)
+        || !SameRange(a.TimingPathsThrough(v), b.TimingPathsThrough(v))) {
+      return false;
+    }
+  }
+  for (int e = 0; e < a.GetNumHyperedges(); e++) {
+    if (!SameRange(a.GetHyperedgeArcSet(e), b.GetHyperedgeArcSet(e))) {
+      return false;
+    }
+  }
+  for (int p = 0; p < a.GetNumTimingPaths(); p++) {
+    if (!SameRange(a.PathVertices(p), b.PathVertices(p))
+        || !SameRange(a.PathEdges(p), b.PathEdges(p))
+        || a.PathTimingSlack(p) != b.PathTimingSlack(p)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace par
@@ -0,0 +1,107 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2022-2025, The OpenROAD Authors
+
+// ThreadPool: every task runs exactly once, including nested batches and
+// batches submitted concurrently by several callers
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "TestUtils.h"
+#include "ThreadPool.h"
+
+namespace par {
+namespace {
+
+void TestParallelFor()
+{
+  for (const int num_threads : {0, 1, 2, 8}) {
+    ThreadPool pool(num_threads);
+    CHECK(pool.GetNumThreads() >= 1);
+    const int num_tasks = 1000;
+    std::vector<std::atomic<int>> counts(num_tasks);
+    pool.ParallelFor(num_tasks, [&](const int i) { counts[i]++; });
+    CHECK(std::all_of(counts.begin(), counts.end(), [](const auto& count) {
+      return count == 1;
+    }));
+    // an empty batch returns immediately
+    pool.ParallelFor(0, [&](int) { counts[0]++; });
+    CHECK(counts[0] == 1);
+  }
+}
+
+void TestNestedParallelFor()
+{
+  ThreadPool pool(4);
+  const int num_outer = 16;
+  const int num_inner = 100;
+  std::vector<std::atomic<int>> counts(num_outer * num_inner);
+  pool.ParallelFor(num_outer, [&](const int i) {
+    pool.ParallelFor(num_inner,
+                     [&](const int j) { counts[i * num_inner + j]++; });
+  });
+  CHECK(std::all_of(counts.begin(), counts.end(), [](const auto& count) {
+    return count == 1;
+  }));
+}
+
+void TestConcurrentCallers()
+{
+  // the callers take part in their own batches, so they finish even when
+  // all the workers are busy with the batches of other callers
+  ThreadPool pool(3);
+  const int num_callers = 6;
+  const int num_tasks = 500;
+  std::vector<std::vector<int>> counts(num_callers,
+                                       std::vector<int>(num_tasks, 0));
+  std::vector<std::thread> callers;
+  for (int caller = 0; caller < num_callers; caller++) {
+    callers.emplace_back([&, caller] {
+      for (int round = 0; round < 20; round++) {
+        pool.ParallelFor(num_tasks,
+                         [&](const int i) { counts[caller][i]++; });
+      }
+    });
+  }
+  for (auto& caller : callers) {
+    caller.join();
+  }
+  for (const auto& caller_counts : counts) {
+    CHECK(std::all_of(caller_counts.begin(),
+                      caller_counts.end(),
+                      [](const int count) { return count == 20; }));
+  }
+}
+
+void TestParallelSort()
+{
+  std::mt19937 rng(1);
+  std::vector<int> data(100000);
+  for (auto& value : data) {
+    value = static_cast<int>(rng() % 1000);
+  }
+  for (const int num_threads : {1, 3, 8}) {
+    ThreadPool pool(num_threads);
+    std::vector<int> sorted = data;
+    pool.ParallelSort(sorted, std::greater<int>());
+    std::vector<int> expected = data;
+    std::sort(expected.begin(), expected.end(), std::greater<int>());
+    CHECK(sorted == expected);
+  }
+}
+
+}  // namespace
+}  // namespace par
+
+int main()
+{
+  par::TestParallelFor();
+  par::TestNestedParallelFor();
+  par::TestConcurrentCallers();
+  par::TestParallelSort();
+  return par::TestResult();
+}